@@ -49,6 +49,7 @@
 #include "libavutil/parseutils.h"
 #include "libavutil/pixdesc.h"
 #include "libavutil/eval.h"
+#include "libavutil/executor.h"
 #include "libavutil/dict.h"
 #include "libavutil/opt.h"
 #include "libavutil/cpu.h"
@@ -869,6 +870,16 @@ int opt_cpucount(void *optctx, const char *opt, const char *arg)
     return ret;
 }
 
+int opt_threads_global(void *optctx, const char *opt, const char *arg)
+{
+    int ret = av_executor_global_init(parse_number_or_die(opt, arg, OPT_INT, 0, INT_MAX));
+
+    if (ret < 0)
+        av_log(NULL, AV_LOG_ERROR, "Failed to create the global thread pool: %s\n",
+               av_err2str(ret));
+    return ret;
+}
+
 int opt_loglevel(void *optctx, const char *opt, const char *arg)
 {
     const struct { const char *name; int level; } log_levels[] = {
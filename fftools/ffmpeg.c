@@ -47,6 +47,7 @@
 #include "libavutil/channel_layout.h"
 #include "libavutil/parseutils.h"
 #include "libavutil/samplefmt.h"
+#include "libavutil/executor.h"
 #include "libavutil/fifo.h"
 #include "libavutil/hwcontext.h"
 #include "libavutil/internal.h"
@@ -167,6 +168,10 @@ static int restore_tty;
 
 #if HAVE_THREADS
 static void free_input_threads(void);
+static void free_decoder_threads(void);
+static void free_muxer_threads(void);
+static void free_encoder_threads(void);
+static int init_encoder_thread(OutputStream *ost);
 #endif
 
 /* sub2video hack:
@@ -524,6 +529,9 @@ static void ffmpeg_cleanup(int ret)
     for (i = 0; i < nb_filtergraphs; i++) {
         FilterGraph *fg = filtergraphs[i];
         avfilter_graph_free(&fg->graph);
+        for (j = 0; j < fg->nb_profiles; j++)
+            av_freep(&fg->profiles[j].name);
+        av_freep(&fg->profiles);
         for (j = 0; j < fg->nb_inputs; j++) {
             InputFilter *ifilter = fg->inputs[j];
             struct InputStream *ist = ifilter->ist;
@@ -560,6 +568,11 @@ static void ffmpeg_cleanup(int ret)
 
     av_freep(&subtitle_out);
 
+#if HAVE_THREADS
+    free_encoder_threads();
+    free_muxer_threads();
+#endif
+
     /* close files */
     for (i = 0; i < nb_output_files; i++) {
         OutputFile *of = output_files[i];
@@ -612,6 +625,7 @@ static void ffmpeg_cleanup(int ret)
     }
 #if HAVE_THREADS
     free_input_threads();
+    free_decoder_threads();
 #endif
     for (i = 0; i < nb_input_files; i++) {
         avformat_close_input(&input_files[i]->ctx);
@@ -627,6 +641,9 @@ static void ffmpeg_cleanup(int ret)
         avsubtitle_free(&ist->prev_sub.subtitle);
         av_frame_free(&ist->sub2video.frame);
         av_freep(&ist->filters);
+        for (j = 0; j < ist->nb_conversions; j++)
+            shared_conversion_free(&ist->conversions[j]);
+        av_freep(&ist->conversions);
         av_freep(&ist->hwaccel_device);
         av_freep(&ist->dts_buffer);
 
@@ -642,7 +659,9 @@ static void ffmpeg_cleanup(int ret)
                    av_err2str(AVERROR(errno)));
     }
     av_freep(&vstats_filename);
+    av_freep(&profile_filename);
     av_freep(&filter_nbthreads);
+    av_freep(&filter_thread_type);
 
     av_freep(&input_streams);
     av_freep(&input_files);
@@ -650,6 +669,7 @@ static void ffmpeg_cleanup(int ret)
     av_freep(&output_files);
 
     uninit_opts();
+    av_executor_global_uninit();
 
     avformat_network_deinit();
 
@@ -707,6 +727,239 @@ static void update_benchmark(const char *fmt, ...)
     }
 }
 
+typedef struct StageTimer {
+    int64_t wall;
+    int64_t cpu;
+} StageTimer;
+
+static void stage_timer_start(StageTimer *t)
+{
+    if (!profile_filename)
+        return;
+    t->wall = av_gettime_relative();
+    t->cpu  = av_gettime_thread_cpu();
+}
+
+static void stage_timer_stop(StageProfile *p, const StageTimer *t)
+{
+    int64_t cpu;
+
+    if (!profile_filename)
+        return;
+    cpu = av_gettime_thread_cpu();
+    p->calls++;
+    p->wall_time += av_gettime_relative() - t->wall;
+    if (cpu >= 0 && t->cpu >= 0 && p->cpu_time >= 0)
+        p->cpu_time += cpu - t->cpu;
+    else
+        p->cpu_time = -1;
+}
+
+static int dec_send_packet(InputStream *ist, const AVPacket *pkt)
+{
+    StageTimer t;
+    int ret;
+
+    stage_timer_start(&t);
+    ret = avcodec_send_packet(ist->dec_ctx, pkt);
+    stage_timer_stop(&ist->dec_profile, &t);
+    if (ret >= 0 && pkt)
+        ist->dec_profile.bytes += pkt->size;
+
+    return ret;
+}
+
+static int dec_receive_frame(InputStream *ist, AVFrame *frame)
+{
+    StageTimer t;
+    int ret;
+
+    stage_timer_start(&t);
+    ret = avcodec_receive_frame(ist->dec_ctx, frame);
+    stage_timer_stop(&ist->dec_profile, &t);
+    if (ret >= 0)
+        ist->dec_profile.frames++;
+
+    return ret;
+}
+
+static int enc_send_frame(OutputStream *ost, const AVFrame *frame)
+{
+    StageTimer t;
+    int ret;
+
+    stage_timer_start(&t);
+    ret = avcodec_send_frame(ost->enc_ctx, frame);
+    stage_timer_stop(&ost->enc_profile, &t);
+    if (ret >= 0 && frame)
+        ost->enc_profile.frames++;
+
+    return ret;
+}
+
+static int enc_receive_packet(OutputStream *ost, AVPacket *pkt)
+{
+    StageTimer t;
+    int ret;
+
+    stage_timer_start(&t);
+    ret = avcodec_receive_packet(ost->enc_ctx, pkt);
+    stage_timer_stop(&ost->enc_profile, &t);
+    if (ret >= 0)
+        ost->enc_profile.bytes += pkt->size;
+
+    return ret;
+}
+
+#if HAVE_THREADS
+/*
+ * A packet returned by the encoder thread, together with the encoder state
+ * the main thread needs for the statistics, so that it never has to look at
+ * the encoder context while the thread is encoding.
+ */
+typedef struct EncoderOutput {
+    AVPacket *pkt;
+    int64_t error[4];
+} EncoderOutput;
+
+static void encoder_thread_post(OutputStream *ost, AVPacket *pkt, int err)
+{
+    EncoderOutput out = { pkt };
+
+    if (pkt)
+        memcpy(out.error, ost->enc_ctx->error, sizeof(out.error));
+
+    pthread_mutex_lock(&ost->enc_lock);
+    if (pkt && av_fifo_write(ost->enc_out, &out, 1) < 0) {
+        av_packet_free(&pkt);
+        err = AVERROR(ENOMEM);
+    }
+    if (err < 0 && !ost->enc_thread_err)
+        ost->enc_thread_err = err;
+    pthread_cond_signal(&ost->enc_cond);
+    pthread_mutex_unlock(&ost->enc_lock);
+}
+
+/* A NULL frame drains the encoder. */
+static void *encoder_thread(void *arg)
+{
+    OutputStream *ost = arg;
+    AVFrame *frame;
+    int ret = 0;
+
+    while (av_thread_message_queue_recv(ost->enc_queue, &frame, 0) >= 0) {
+        ret = enc_send_frame(ost, frame);
+        av_frame_free(&frame);
+        if (ret < 0)
+            break;
+
+        while (1) {
+            AVPacket *pkt = av_packet_alloc();
+            if (!pkt) {
+                ret = AVERROR(ENOMEM);
+                break;
+            }
+            ret = enc_receive_packet(ost, pkt);
+            if (ret < 0) {
+                av_packet_free(&pkt);
+                break;
+            }
+            encoder_thread_post(ost, pkt, 0);
+        }
+        if (ret == AVERROR_EOF) {
+            encoder_thread_post(ost, NULL, ret);
+            ret = 0;
+        } else if (ret != AVERROR(EAGAIN))
+            break;
+    }
+
+    /* do not let the main thread block on a queue nobody reads anymore */
+    if (ret < 0 && ret != AVERROR(EAGAIN)) {
+        encoder_thread_post(ost, NULL, ret);
+        av_thread_message_queue_set_err_send(ost->enc_queue, ret);
+    }
+
+    return NULL;
+}
+#endif
+
+/*
+ * Send a frame to the encoder. With -async_depth, the frame is queued to the
+ * encoder thread, blocking only when that many frames are already in flight.
+ */
+static int encode_send_frame(OutputStream *ost, const AVFrame *frame)
+{
+#if HAVE_THREADS
+    if (ost->enc_queue) {
+        AVFrame *tmp = NULL;
+        int ret;
+
+        if (!frame) {
+            if (ost->enc_draining)
+                return 0;
+            ost->enc_draining = 1;
+        } else if (!(tmp = av_frame_clone(frame)))
+            return AVERROR(ENOMEM);
+
+        ret = av_thread_message_queue_send(ost->enc_queue, &tmp, 0);
+        if (ret < 0)
+            av_frame_free(&tmp);
+        return ret;
+    }
+#endif
+    return enc_send_frame(ost, frame);
+}
+
+/*
+ * Get an encoded packet. With -async_depth, only the packets the encoder
+ * thread already produced are returned, unless the encoder is being drained.
+ */
+static int encode_receive_packet(OutputStream *ost, AVPacket *pkt)
+{
+    int ret;
+
+#if HAVE_THREADS
+    if (ost->enc_queue) {
+        EncoderOutput out;
+
+        pthread_mutex_lock(&ost->enc_lock);
+        while (ost->enc_draining && !ost->enc_thread_err && !av_fifo_can_read(ost->enc_out))
+            pthread_cond_wait(&ost->enc_cond, &ost->enc_lock);
+        ret = av_fifo_read(ost->enc_out, &out, 1);
+        if (ret < 0)
+            ret = ost->enc_thread_err ? ost->enc_thread_err : AVERROR(EAGAIN);
+        pthread_mutex_unlock(&ost->enc_lock);
+        if (ret < 0)
+            return ret;
+
+        memcpy(ost->enc_error, out.error, sizeof(ost->enc_error));
+        av_packet_move_ref(pkt, out.pkt);
+        av_packet_free(&out.pkt);
+        return 0;
+    }
+#endif
+    ret = enc_receive_packet(ost, pkt);
+    if (ret >= 0)
+        memcpy(ost->enc_error, ost->enc_ctx->error, sizeof(ost->enc_error));
+    return ret;
+}
+
+static int mux_write_packet(OutputFile *of, AVPacket *pkt)
+{
+    StageTimer t;
+    int size = pkt->size, ret;
+
+    stage_timer_start(&t);
+    ret = av_interleaved_write_frame(of->ctx, pkt);
+    stage_timer_stop(&of->mux_profile, &t);
+    if (ret >= 0) {
+        of->mux_profile.frames++;
+        of->mux_profile.bytes += size;
+    }
+
+    return ret;
+}
+
 static void close_all_output_streams(OutputStream *ost, OSTFinished this_stream, OSTFinished others)
 {
     int i;
@@ -716,6 +969,210 @@ static void close_all_output_streams(OutputStream *ost, OSTFinished this_stream,
     }
 }
 
+#if HAVE_THREADS
+static void *muxer_thread(void *arg)
+{
+    OutputFile *of = arg;
+    AVPacket *pkt;
+    int ret;
+
+    while (1) {
+        OutputStream *ost;
+        int size;
+
+        ret = av_thread_message_queue_recv(of->mux_queue, &pkt, 0);
+        if (ret < 0)
+            break;
+
+        ost  = output_streams[of->ost_index + pkt->stream_index];
+        size = pkt->size;
+        ret  = mux_write_packet(of, pkt);
+        av_packet_free(&pkt);
+
+        pthread_mutex_lock(&of->mux_lock);
+        of->mux_queue_bytes -= size;
+        of->mux_size         = of->ctx->pb ? avio_tell(of->ctx->pb) : 0;
+        ost->mux_end_pts     = av_stream_get_end_pts(ost->st);
+        pthread_cond_signal(&of->mux_cond);
+        pthread_mutex_unlock(&of->mux_lock);
+
+        if (ret < 0)
+            break;
+    }
+
+    pthread_mutex_lock(&of->mux_lock);
+    of->mux_thread_ret  = ret == AVERROR_EOF ? 0 : ret;
+    of->mux_thread_done = 1;
+    pthread_cond_broadcast(&of->mux_cond);
+    pthread_mutex_unlock(&of->mux_lock);
+
+    av_thread_message_queue_set_err_send(of->mux_queue, ret);
+
+    return NULL;
+}
+
+/* Hand a packet over to the muxer thread, blocking while the queue is full. */
+static int muxer_thread_send(OutputFile *of, AVPacket *pkt)
+{
+    AVPacket *queue_pkt;
+    int ret;
+
+    ret = av_packet_make_refcounted(pkt);
+    if (ret < 0)
+        return ret;
+    queue_pkt = av_packet_alloc();
+    if (!queue_pkt)
+        return AVERROR(ENOMEM);
+    av_packet_move_ref(queue_pkt, pkt);
+
+    pthread_mutex_lock(&of->mux_lock);
+    /* always let a packet through into an empty queue, however large it is */
+    while (of->thread_queue_max_bytes > 0 && !of->mux_thread_done &&
+           of->mux_queue_bytes > 0 &&
+           of->mux_queue_bytes + queue_pkt->size > of->thread_queue_max_bytes)
+        pthread_cond_wait(&of->mux_cond, &of->mux_lock);
+    /* nothing will drain the queue anymore once the thread is gone */
+    if (of->mux_thread_done) {
+        ret = of->mux_thread_ret ? of->mux_thread_ret : AVERROR_EOF;
+        of->mux_thread_ret = 0;
+        pthread_mutex_unlock(&of->mux_lock);
+        av_packet_free(&queue_pkt);
+        return ret;
+    }
+    of->mux_queue_bytes += queue_pkt->size;
+    pthread_mutex_unlock(&of->mux_lock);
+
+    ret = av_thread_message_queue_send(of->mux_queue, &queue_pkt, 0);
+    if (ret < 0) {
+        pthread_mutex_lock(&of->mux_lock);
+        of->mux_queue_bytes -= queue_pkt->size;
+        /* the error is returned to and reported by the caller */
+        of->mux_thread_ret   = 0;
+        pthread_mutex_unlock(&of->mux_lock);
+        av_packet_free(&queue_pkt);
+    }
+    return ret;
+}
+
+static void muxer_queue_free(void *msg)
+{
+    av_packet_free(msg);
+}
+
+/* Wait for the muxer thread to write all the queued packets and stop it. */
+static int finish_muxer_thread(OutputFile *of)
+{
+    int ret;
+
+    if (!of->mux_queue)
+        return 0;
+
+    av_thread_message_queue_set_err_recv(of->mux_queue, AVERROR_EOF);
+    pthread_join(of->mux_thread, NULL);
+    ret = of->mux_thread_ret;
+
+    av_thread_message_queue_free(&of->mux_queue);
+    pthread_cond_destroy(&of->mux_cond);
+    pthread_mutex_destroy(&of->mux_lock);
+
+    return ret;
+}
+
+static void free_muxer_threads(void)
+{
+    int i;
+
+    for (i = 0; i < nb_output_files; i++) {
+        OutputFile *of = output_files[i];
+
+        if (!of || !of->mux_queue)
+            continue;
+        /* drop the pending packets so the thread exits as soon as possible */
+        av_thread_message_flush(of->mux_queue);
+        finish_muxer_thread(of);
+    }
+}
+
+static int init_muxer_thread(OutputFile *of)
+{
+    int i, ret;
+
+    if (!of->thread_queue_size)
+        return 0;
+
+    ret = av_thread_message_queue_alloc(&of->mux_queue, of->thread_queue_size,
+                                        sizeof(AVPacket *));
+    if (ret < 0)
+        return ret;
+    av_thread_message_queue_set_free_func(of->mux_queue, muxer_queue_free);
+
+    for (i = 0; i < of->ctx->nb_streams; i++)
+        output_streams[of->ost_index + i]->mux_end_pts = av_stream_get_end_pts(of->ctx->streams[i]);
+    of->mux_queue_bytes = 0;
+    of->mux_thread_ret  = 0;
+    of->mux_thread_done = 0;
+    of->mux_size        = of->ctx->pb ? avio_tell(of->ctx->pb) : 0;
+
+    pthread_mutex_init(&of->mux_lock, NULL);
+    pthread_cond_init(&of->mux_cond, NULL);
+
+    if ((ret = pthread_create(&of->mux_thread, NULL, muxer_thread, of))) {
+        av_log(NULL, AV_LOG_ERROR, "pthread_create failed: %s. Try to increase `ulimit -v` or decrease `ulimit -s`.\n", strerror(ret));
+        av_thread_message_queue_free(&of->mux_queue);
+        pthread_cond_destroy(&of->mux_cond);
+        pthread_mutex_destroy(&of->mux_lock);
+        return AVERROR(ret);
+    }
+
+    return 0;
+}
+#endif
+
+/* Current position in the output file, also valid while its muxer thread runs. */
+static int64_t output_file_tell(OutputFile *of)
+{
+#if HAVE_THREADS
+    if (of->mux_queue) {
+        int64_t pos;
+        pthread_mutex_lock(&of->mux_lock);
+        pos = of->mux_size;
+        pthread_mutex_unlock(&of->mux_lock);
+        return pos;
+    }
+#endif
+    return avio_tell(of->ctx->pb);
+}
+
+static int64_t output_file_size(OutputFile *of)
+{
+    int64_t size;
+
+#if HAVE_THREADS
+    if (of->mux_queue)
+        return output_file_tell(of);
+#endif
+    size = avio_size(of->ctx->pb);
+    if (size <= 0) // FIXME improve avio_size() so it works with non seekable output too
+        size = avio_tell(of->ctx->pb);
+    return size;
+}
+
+/* av_stream_get_end_pts(), also valid while the muxer thread runs. */
+static int64_t output_stream_end_pts(OutputStream *ost)
+{
+#if HAVE_THREADS
+    OutputFile *of = output_files[ost->file_index];
+    if (of->mux_queue) {
+        int64_t pts;
+        pthread_mutex_lock(&of->mux_lock);
+        pts = ost->mux_end_pts;
+        pthread_mutex_unlock(&of->mux_lock);
+        return pts;
+    }
+#endif
+    return av_stream_get_end_pts(ost->st);
+}
+
 static void write_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost, int unqueue)
 {
     AVFormatContext *s = of->ctx;
@@ -851,7 +1308,12 @@ static void write_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost, int u
               );
     }
 
-    ret = av_interleaved_write_frame(s, pkt);
+#if HAVE_THREADS
+    if (of->mux_queue)
+        ret = muxer_thread_send(of, pkt);
+    else
+#endif
+    ret = mux_write_packet(of, pkt);
     if (ret < 0) {
         print_error("av_interleaved_write_frame()", ret);
         main_return_code = 1;
@@ -1015,12 +1477,12 @@ static void do_audio_out(OutputFile *of, OutputStream *ost,
                enc->time_base.num, enc->time_base.den);
     }
 
-    ret = avcodec_send_frame(enc, frame);
+    ret = encode_send_frame(ost, frame);
     if (ret < 0)
         goto error;
 
     while (1) {
-        ret = avcodec_receive_packet(enc, pkt);
+        ret = encode_receive_packet(ost, pkt);
         if (ret == AVERROR(EAGAIN))
             break;
         if (ret < 0)
@@ -1340,14 +1802,14 @@ static void do_video_out(OutputFile *of,
 
         ost->frames_encoded++;
 
-        ret = avcodec_send_frame(enc, in_picture);
+        ret = encode_send_frame(ost, in_picture);
         if (ret < 0)
             goto error;
         // Make sure Closed Captions will not be duplicated
         av_frame_remove_side_data(in_picture, AV_FRAME_DATA_A53_CC);
 
         while (1) {
-            ret = avcodec_receive_packet(enc, pkt);
+            ret = encode_receive_packet(ost, pkt);
             update_benchmark("encode_video %d.%d", ost->file_index, ost->index);
             if (ret == AVERROR(EAGAIN))
                 break;
@@ -1380,6 +1842,10 @@ static void do_video_out(OutputFile *of,
             if (ost->logfile && enc->stats_out) {
                 fprintf(ost->logfile, "%s", enc->stats_out);
             }
+
+            /* with -async_depth, a call may return zero or several packets */
+            if (vstats_filename && frame_size)
+                do_video_stats(ost, frame_size);
         }
         ost->sync_opts++;
         /*
@@ -1388,9 +1854,6 @@ static void do_video_out(OutputFile *of,
          * flush, we need to limit them here, before they go into encoder.
          */
         ost->frame_number++;
-
-        if (vstats_filename && frame_size)
-            do_video_stats(ost, frame_size);
     }
 
     av_frame_unref(ost->last_frame);
@@ -1425,7 +1888,9 @@ static void do_video_stats(OutputStream *ost, int frame_size)
 
     enc = ost->enc_ctx;
     if (enc->codec_type == AVMEDIA_TYPE_VIDEO) {
-        frame_number = ost->st->nb_frames;
+        /* st->nb_frames is updated by the muxer, which may run on its own
+         * thread, so count the packets handed to it here instead */
+        frame_number = ost->packets_written;
         if (vstats_version <= 1) {
             fprintf(vstats_file, "frame= %5d q= %2.1f ", frame_number,
                     ost->quality / (float)FF_QP2LAMBDA);
@@ -1439,7 +1904,7 @@ static void do_video_stats(OutputStream *ost, int frame_size)
 
         fprintf(vstats_file,"f_size= %6d ", frame_size);
         /* compute pts value */
-        ti1 = av_stream_get_end_pts(ost->st) * av_q2d(ost->st->time_base);
+        ti1 = output_stream_end_pts(ost) * av_q2d(ost->st->time_base);
         if (ti1 < 0.01)
             ti1 = 0.01;
 
@@ -1668,7 +2133,6 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
 {
     AVBPrint buf, buf_script;
     OutputStream *ost;
-    AVFormatContext *oc;
     int64_t total_size;
     AVCodecContext *enc;
     int frame_number, vid, i;
@@ -1699,17 +2163,14 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
     t = (cur_time-timer_start) / 1000000.0;
 
 
-    oc = output_files[0]->ctx;
-
-    total_size = avio_size(oc->pb);
-    if (total_size <= 0) // FIXME improve avio_size() so it works with non seekable output too
-        total_size = avio_tell(oc->pb);
+    total_size = output_file_size(output_files[0]);
 
     vid = 0;
     av_bprint_init(&buf, 0, AV_BPRINT_SIZE_AUTOMATIC);
     av_bprint_init(&buf_script, 0, AV_BPRINT_SIZE_AUTOMATIC);
     for (i = 0; i < nb_output_streams; i++) {
         float q = -1;
+        int64_t end_pts;
         ost = output_streams[i];
         enc = ost->enc_ctx;
         if (!ost->stream_copy)
@@ -1751,7 +2212,7 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
                 av_bprintf(&buf, "PSNR=");
                 for (j = 0; j < 3; j++) {
                     if (is_last_report) {
-                        error = enc->error[j];
+                        error = ost->enc_error[j];
                         scale = enc->width * enc->height * 255.0 * 255.0 * frame_number;
                     } else {
                         error = ost->error[j];
@@ -1774,9 +2235,9 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
             vid = 1;
         }
         /* compute min output value */
-        if (av_stream_get_end_pts(ost->st) != AV_NOPTS_VALUE) {
-            pts = FFMAX(pts, av_rescale_q(av_stream_get_end_pts(ost->st),
-                                          ost->st->time_base, AV_TIME_BASE_Q));
+        end_pts = output_stream_end_pts(ost);
+        if (end_pts != AV_NOPTS_VALUE) {
+            pts = FFMAX(pts, av_rescale_q(end_pts, ost->st->time_base, AV_TIME_BASE_Q));
             if (copy_ts) {
                 if (copy_ts_first_pts == AV_NOPTS_VALUE && pts > 1)
                     copy_ts_first_pts = pts;
@@ -1843,6 +2304,25 @@ static void print_report(int is_last_report, int64_t timer_start, int64_t cur_ti
         av_bprintf(&buf_script, "speed=%4.3gx\n", speed);
     }
 
+#if HAVE_THREADS
+    for (i = 0; i < nb_output_files; i++) {
+        OutputFile *of = output_files[i];
+        int64_t queued_bytes;
+        int queued;
+
+        if (!of->mux_queue)
+            continue;
+        pthread_mutex_lock(&of->mux_lock);
+        queued_bytes = of->mux_queue_bytes;
+        pthread_mutex_unlock(&of->mux_lock);
+        queued = av_thread_message_queue_nb_elems(of->mux_queue);
+
+        av_bprintf(&buf, " muxq%d=%d/%d", i, queued, of->thread_queue_size);
+        av_bprintf(&buf_script, "mux_queue_%d_packets=%d\n", i, queued);
+        av_bprintf(&buf_script, "mux_queue_%d_bytes=%"PRId64"\n", i, queued_bytes);
+    }
+#endif
+
     if (print_stats || is_last_report) {
         const char end = is_last_report ? '\n' : '\r';
         if (print_stats==1 && AV_LOG_INFO > av_log_get_level()) {
@@ -1887,6 +2367,115 @@ static void ifilter_parameters_from_codecpar(InputFilter *ifilter, AVCodecParame
     ifilter->sample_aspect_ratio    = par->sample_aspect_ratio;
 }
 
+static void json_print_str(AVBPrint *bp, const char *key, const char *str)
+{
+    av_bprintf(bp, "\"%s\": \"", key);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            av_bprintf(bp, "\\%c", *str);
+        else if ((unsigned char)*str < 0x20)
+            av_bprintf(bp, "\\u%04x", *str);
+        else
+            av_bprint_chars(bp, *str, 1);
+    }
+    av_bprintf(bp, "\"");
+}
+
+static void json_print_stage(AVBPrint *bp, const StageProfile *p)
+{
+    av_bprintf(bp, ", \"calls\": %"PRIu64", \"frames\": %"PRIu64", "
+               "\"bytes\": %"PRIu64", \"wall_us\": %"PRId64", \"cpu_us\": %"PRId64,
+               p->calls, p->frames, p->bytes, p->wall_time, p->cpu_time);
+}
+
+static void write_profile_json(void)
+{
+    AVBPrint bp;
+    FILE *f;
+    int i, j;
+
+    for (i = 0; i < nb_filtergraphs; i++) {
+        if (filtergraphs[i]->graph &&
+            filtergraph_collect_profile(filtergraphs[i]) < 0) {
+            av_log(NULL, AV_LOG_ERROR, "Error collecting filter profiles\n");
+            return;
+        }
+    }
+
+    av_bprint_init(&bp, 0, AV_BPRINT_SIZE_UNLIMITED);
+
+    av_bprintf(&bp, "{\n  \"decode\": [");
+    for (i = 0, j = 0; i < nb_input_streams; i++) {
+        InputStream *ist = input_streams[i];
+        if (!ist->decoding_needed)
+            continue;
+        av_bprintf(&bp, "%s\n    { \"stream\": \"%d:%d\", ", j++ ? "," : "",
+                   ist->file_index, ist->st->index);
+        json_print_str(&bp, "codec", ist->dec->name);
+        json_print_stage(&bp, &ist->dec_profile);
+        av_bprintf(&bp, " }");
+    }
+
+    av_bprintf(&bp, "\n  ],\n  \"filtergraphs\": [");
+    for (i = 0; i < nb_filtergraphs; i++) {
+        FilterGraph *fg = filtergraphs[i];
+        av_bprintf(&bp, "%s\n    { \"index\": %d, \"filters\": [", i ? "," : "", fg->index);
+        for (j = 0; j < fg->nb_profiles; j++) {
+            const FilterProfile *p = &fg->profiles[j];
+            av_bprintf(&bp, "%s\n      { ", j ? "," : "");
+            json_print_str(&bp, "name", p->name);
+            av_bprintf(&bp, ", ");
+            json_print_str(&bp, "filter", p->filter);
+            av_bprintf(&bp, ", \"activations\": %"PRIu64", \"frames_in\": %"PRIu64", "
+                       "\"frames_out\": %"PRIu64", \"bytes_allocated\": %"PRIu64", "
+                       "\"wall_us\": %"PRId64", \"cpu_us\": %"PRId64" }",
+                       p->counters.nb_activations, p->counters.frames_in,
+                       p->counters.frames_out, p->counters.bytes_allocated,
+                       p->counters.wall_time, p->counters.cpu_time);
+        }
+        av_bprintf(&bp, "\n    ] }");
+    }
+
+    av_bprintf(&bp, "\n  ],\n  \"encode\": [");
+    for (i = 0, j = 0; i < nb_output_streams; i++) {
+        OutputStream *ost = output_streams[i];
+        if (!ost->encoding_needed)
+            continue;
+        av_bprintf(&bp, "%s\n    { \"stream\": \"%d:%d\", ", j++ ? "," : "",
+                   ost->file_index, ost->index);
+        json_print_str(&bp, "codec", ost->enc->name);
+        json_print_stage(&bp, &ost->enc_profile);
+        av_bprintf(&bp, " }");
+    }
+
+    av_bprintf(&bp, "\n  ],\n  \"mux\": [");
+    for (i = 0; i < nb_output_files; i++) {
+        OutputFile *of = output_files[i];
+        av_bprintf(&bp, "%s\n    { \"file\": %d, ", i ? "," : "", i);
+        json_print_str(&bp, "format", of->ctx->oformat->name);
+        json_print_stage(&bp, &of->mux_profile);
+        av_bprintf(&bp, " }");
+    }
+    av_bprintf(&bp, "\n  ]\n}\n");
+
+    if (!av_bprint_is_complete(&bp)) {
+        av_log(NULL, AV_LOG_ERROR, "Out of memory writing the profile\n");
+        goto end;
+    }
+
+    f = fopen(profile_filename, "w");
+    if (!f) {
+        av_log(NULL, AV_LOG_ERROR, "Cannot open profile file %s: %s\n",
+               profile_filename, strerror(errno));
+        goto end;
+    }
+    fwrite(bp.str, 1, bp.len, f);
+    fclose(f);
+
+end:
+    av_bprint_finalize(&bp, NULL);
+}
+
 static void flush_encoders(void)
 {
     int i, ret;
@@ -1952,8 +2541,8 @@ static void flush_encoders(void)
 
             update_benchmark(NULL);
 
-            while ((ret = avcodec_receive_packet(enc, pkt)) == AVERROR(EAGAIN)) {
-                ret = avcodec_send_frame(enc, NULL);
+            while ((ret = encode_receive_packet(ost, pkt)) == AVERROR(EAGAIN)) {
+                ret = encode_send_frame(ost, NULL);
                 if (ret < 0) {
                     av_log(NULL, AV_LOG_FATAL, "%s encoding failed: %s\n",
                            desc,
@@ -2142,6 +2731,14 @@ static int ifilter_send_frame(InputFilter *ifilter, AVFrame *frame, int keep_ref
     int need_reinit, ret;
     int buffersrc_flags = AV_BUFFERSRC_FLAG_PUSH;
 
+    if (ifilter->conversion && frame->format != ifilter->conversion->format) {
+        ret = ifilter_convert_frame(ifilter, frame, 1, &frame);
+        if (ret < 0)
+            return ret;
+        /* the converted frame is shared with the other filtergraphs */
+        keep_reference = 1;
+    }
+
     if (keep_reference)
         buffersrc_flags |= AV_BUFFERSRC_FLAG_KEEP_REF;
 
@@ -2204,6 +2801,14 @@ static int ifilter_send_frame(InputFilter *ifilter, AVFrame *frame, int keep_ref
             av_log(NULL, AV_LOG_ERROR, "Error reinitializing filters!\n");
             return ret;
         }
+
+        /* the graph may have just decided to share the conversion */
+        if (ifilter->conversion && frame->format != ifilter->format) {
+            ret = ifilter_convert_frame(ifilter, frame, 1, &frame);
+            if (ret < 0)
+                return ret;
+            buffersrc_flags |= AV_BUFFERSRC_FLAG_KEEP_REF;
+        }
     }
 
     ret = av_buffersrc_add_frame_flags(ifilter->filter, frame, buffersrc_flags);
@@ -2239,31 +2844,211 @@ static int ifilter_send_eof(InputFilter *ifilter, int64_t pts)
     return 0;
 }
 
+static void get_decoder_state(const AVCodecContext *avctx, DecoderState *s)
+{
+    s->has_b_frames        = avctx->has_b_frames;
+    s->width               = avctx->width;
+    s->height              = avctx->height;
+    s->pix_fmt             = avctx->pix_fmt;
+    s->framerate           = avctx->framerate;
+    s->ticks_per_frame     = avctx->ticks_per_frame;
+    s->sample_rate         = avctx->sample_rate;
+    s->bits_per_raw_sample = avctx->bits_per_raw_sample;
+}
+
+/* must run on the thread decoding ist, which also runs the get_format() and
+ * hwaccel callbacks */
+static int hwaccel_retrieve(InputStream *ist, AVFrame *frame)
+{
+    if (ist->hwaccel_retrieve_data && frame->format == ist->hwaccel_pix_fmt) {
+        int err = ist->hwaccel_retrieve_data(ist->dec_ctx, frame);
+        if (err < 0)
+            return err;
+    }
+    ist->hwaccel_retrieved_pix_fmt = frame->format;
+    return 0;
+}
+
+#if HAVE_THREADS
+typedef struct DecodedFrame {
+    AVFrame *frame; /* NULL if this entry only carries an error code */
+    int ret;
+    /* properties of the packet the frame was returned for, matching what
+     * decode() sees when decoding on the main thread */
+    int has_pkt;
+    int64_t pkt_pts;
+    int64_t pkt_duration;
+    /* decoder state after this entry was produced */
+    DecoderState state;
+    int retrieve_err;
+} DecodedFrame;
+
+static void decoder_thread_post(InputStream *ist, AVFrame *frame, int err,
+                                const AVPacket *pkt)
+{
+    DecodedFrame df = { frame, err };
+    int ret;
+
+    if (frame && ist->dec_ctx->codec_type == AVMEDIA_TYPE_VIDEO)
+        df.retrieve_err = hwaccel_retrieve(ist, frame);
+    get_decoder_state(ist->dec_ctx, &df.state);
+
+    if (pkt) {
+        df.has_pkt      = 1;
+        df.pkt_pts      = pkt->pts;
+        df.pkt_duration = pkt->duration;
+    }
+
+    pthread_mutex_lock(&ist->dec_lock);
+    ret = av_fifo_write(ist->dec_out, &df, 1);
+    if (ret < 0) {
+        av_frame_free(&frame);
+        ist->dec_thread_err = ret;
+    }
+    pthread_cond_signal(&ist->dec_cond);
+    pthread_mutex_unlock(&ist->dec_lock);
+}
+
+/* A NULL packet requests a decoder flush, an empty one drains the decoder. */
+static void *decoder_thread(void *arg)
+{
+    InputStream *ist = arg;
+    AVCodecContext *avctx = ist->dec_ctx;
+    AVPacket *pkt;
+    int ret;
+
+    while (av_thread_message_queue_recv(ist->dec_queue, &pkt, 0) >= 0) {
+        const AVPacket *frame_pkt = pkt;
+
+        if (!pkt) {
+            avcodec_flush_buffers(avctx);
+            continue;
+        }
+
+        ret = dec_send_packet(ist, pkt);
+        if (ret < 0 && ret != AVERROR_EOF) {
+            decoder_thread_post(ist, NULL, ret, NULL);
+            av_packet_free(&pkt);
+            continue;
+        }
+
+        while (1) {
+            AVFrame *frame = av_frame_alloc();
+            if (!frame) {
+                decoder_thread_post(ist, NULL, AVERROR(ENOMEM), NULL);
+                break;
+            }
+            ret = dec_receive_frame(ist, frame);
+            if (ret < 0) {
+                av_frame_free(&frame);
+                if (ret != AVERROR(EAGAIN))
+                    decoder_thread_post(ist, NULL, ret, NULL);
+                break;
+            }
+            /* only the first frame is attributed to the packet */
+            decoder_thread_post(ist, frame, 0, frame_pkt);
+            frame_pkt = NULL;
+        }
+        av_packet_free(&pkt);
+    }
+
+    return NULL;
+}
+
+static int decode_threaded(InputStream *ist, AVFrame *frame, int *got_frame, AVPacket *pkt)
+{
+    DecodedFrame df;
+    int ret;
+
+    if (ist->dec_eof)
+        return AVERROR_EOF;
+
+    if (pkt) {
+        int drain = !pkt->data && !pkt->side_data_elems;
+
+        if (!drain || !ist->dec_draining) {
+            AVPacket *queue_pkt = av_packet_alloc();
+            if (!queue_pkt)
+                return AVERROR(ENOMEM);
+            /* a drain packet is sent as a blank one, av_packet_ref() would
+             * give it a data buffer */
+            ret = drain ? 0 : av_packet_ref(queue_pkt, pkt);
+            if (ret >= 0)
+                ret = av_thread_message_queue_send(ist->dec_queue, &queue_pkt, 0);
+            if (ret < 0) {
+                av_packet_free(&queue_pkt);
+                return ret;
+            }
+            ist->dec_draining |= drain;
+        }
+    }
+
+    /* once draining, wait for the decoder to either output a frame or signal
+     * EOF; otherwise only pick up what it has already decoded */
+    pthread_mutex_lock(&ist->dec_lock);
+    while (ist->dec_draining && !ist->dec_thread_err && !av_fifo_can_read(ist->dec_out))
+        pthread_cond_wait(&ist->dec_cond, &ist->dec_lock);
+    ret = av_fifo_read(ist->dec_out, &df, 1);
+    if (ret < 0)
+        df = (DecodedFrame){ NULL, ist->dec_thread_err };
+    else
+        ist->dec_state = df.state;
+    pthread_mutex_unlock(&ist->dec_lock);
+
+    if (!df.frame) {
+        if (df.ret == AVERROR_EOF)
+            ist->dec_eof = 1;
+        return df.ret;
+    }
+
+    av_frame_move_ref(frame, df.frame);
+    av_frame_free(&df.frame);
+    *got_frame = 1;
+    ist->dec_retrieve_err = df.retrieve_err;
+
+    ist->dec_frame_pkt = NULL;
+    if (df.has_pkt) {
+        ist->dec_pkt->pts      = df.pkt_pts;
+        ist->dec_pkt->duration = df.pkt_duration;
+        ist->dec_frame_pkt     = ist->dec_pkt;
+    }
+
+    return 0;
+}
+#endif
+
 // This does not quite work like avcodec_decode_audio4/avcodec_decode_video2.
 // There is the following difference: if you got a frame, you must call
 // it again with pkt=NULL. pkt==NULL is treated differently from pkt->size==0
 // (pkt==NULL means get more output, pkt->size==0 is a flush/drain packet)
-static int decode(AVCodecContext *avctx, AVFrame *frame, int *got_frame, AVPacket *pkt)
+static int decode(InputStream *ist, AVFrame *frame, int *got_frame, AVPacket *pkt)
 {
     int ret;
 
     *got_frame = 0;
 
+#if HAVE_THREADS
+    if (ist->dec_queue)
+        return decode_threaded(ist, frame, got_frame, pkt);
+#endif
+
     if (pkt) {
-        ret = avcodec_send_packet(avctx, pkt);
+        ret = dec_send_packet(ist, pkt);
         // In particular, we don't expect AVERROR(EAGAIN), because we read all
         // decoded frames with avcodec_receive_frame() until done.
         if (ret < 0 && ret != AVERROR_EOF)
-            return ret;
+            goto finish;
     }
 
-    ret = avcodec_receive_frame(avctx, frame);
-    if (ret < 0 && ret != AVERROR(EAGAIN))
-        return ret;
+    ret = dec_receive_frame(ist, frame);
     if (ret >= 0)
         *got_frame = 1;
+    if (ret >= 0 || ret == AVERROR(EAGAIN))
+        ret = 0;
 
-    return 0;
+finish:
+    get_decoder_state(ist->dec_ctx, &ist->dec_state);
+    return ret;
 }
 
 static int send_frame_to_filters(InputStream *ist, AVFrame *decoded_frame)
@@ -2271,6 +3056,7 @@ static int send_frame_to_filters(InputStream *ist, AVFrame *decoded_frame)
     int i, ret;
 
     av_assert1(ist->nb_filters > 0); /* ensure ret is initialized */
+    ist->frame_serial++;
     for (i = 0; i < ist->nb_filters; i++) {
         ret = ifilter_send_frame(ist->filters[i], decoded_frame, i < ist->nb_filters - 1);
         if (ret == AVERROR_EOF)
@@ -2293,13 +3079,17 @@ static int decode_audio(InputStream *ist, AVPacket *pkt, int *got_output,
     AVRational decoded_frame_tb;
 
     update_benchmark(NULL);
-    ret = decode(avctx, decoded_frame, got_output, pkt);
+    ret = decode(ist, decoded_frame, got_output, pkt);
     update_benchmark("decode_audio %d.%d", ist->file_index, ist->st->index);
     if (ret < 0)
         *decode_failed = 1;
+#if HAVE_THREADS
+    if (ist->dec_queue)
+        pkt = ist->dec_frame_pkt;
+#endif
 
-    if (ret >= 0 && avctx->sample_rate <= 0) {
-        av_log(avctx, AV_LOG_ERROR, "Sample rate %d invalid\n", avctx->sample_rate);
+    if (ret >= 0 && ist->dec_state.sample_rate <= 0) {
+        av_log(avctx, AV_LOG_ERROR, "Sample rate %d invalid\n", ist->dec_state.sample_rate);
         ret = AVERROR_INVALIDDATA;
     }
 
@@ -2315,9 +3105,9 @@ static int decode_audio(InputStream *ist, AVPacket *pkt, int *got_output,
     /* increment next_dts to use for the case where the input stream does not
        have timestamps or there are multiple frames in the packet */
     ist->next_pts += ((int64_t)AV_TIME_BASE * decoded_frame->nb_samples) /
-                     avctx->sample_rate;
+                     ist->dec_state.sample_rate;
     ist->next_dts += ((int64_t)AV_TIME_BASE * decoded_frame->nb_samples) /
-                     avctx->sample_rate;
+                     ist->dec_state.sample_rate;
 
     if (decoded_frame->pts != AV_NOPTS_VALUE) {
         decoded_frame_tb   = ist->st->time_base;
@@ -2335,8 +3125,8 @@ static int decode_audio(InputStream *ist, AVPacket *pkt, int *got_output,
         ist->prev_pkt_pts = pkt->pts;
     if (decoded_frame->pts != AV_NOPTS_VALUE)
         decoded_frame->pts = av_rescale_delta(decoded_frame_tb, decoded_frame->pts,
-                                              (AVRational){1, avctx->sample_rate}, decoded_frame->nb_samples, &ist->filter_in_rescale_delta_last,
-                                              (AVRational){1, avctx->sample_rate});
+                                              (AVRational){1, ist->dec_state.sample_rate}, decoded_frame->nb_samples, &ist->filter_in_rescale_delta_last,
+                                              (AVRational){1, ist->dec_state.sample_rate});
     ist->nb_samples = decoded_frame->nb_samples;
     err = send_frame_to_filters(ist, decoded_frame);
 
@@ -2375,23 +3165,23 @@ static int decode_video(InputStream *ist, AVPacket *pkt, int *got_output, int64_
     }
 
     update_benchmark(NULL);
-    ret = decode(ist->dec_ctx, decoded_frame, got_output, pkt);
+    ret = decode(ist, decoded_frame, got_output, pkt);
     update_benchmark("decode_video %d.%d", ist->file_index, ist->st->index);
     if (ret < 0)
         *decode_failed = 1;
 
     // The following line may be required in some cases where there is no parser
     // or the parser does not has_b_frames correctly
-    if (ist->st->codecpar->video_delay < ist->dec_ctx->has_b_frames) {
+    if (ist->st->codecpar->video_delay < ist->dec_state.has_b_frames) {
         if (ist->dec_ctx->codec_id == AV_CODEC_ID_H264) {
-            ist->st->codecpar->video_delay = ist->dec_ctx->has_b_frames;
+            ist->st->codecpar->video_delay = ist->dec_state.has_b_frames;
         } else
             av_log(ist->dec_ctx, AV_LOG_WARNING,
                    "video_delay is larger in decoder than demuxer %d > %d.\n"
                    "If you want to help, upload a sample "
                    "of this file to https://streams.videolan.org/upload/ "
                    "and contact the ffmpeg-devel mailing list. (ffmpeg-devel@ffmpeg.org)\n",
-                   ist->dec_ctx->has_b_frames,
+                   ist->dec_state.has_b_frames,
                    ist->st->codecpar->video_delay);
     }
 
@@ -2399,16 +3189,16 @@ static int decode_video(InputStream *ist, AVPacket *pkt, int *got_output, int64_
         check_decode_result(ist, got_output, ret);
 
     if (*got_output && ret >= 0) {
-        if (ist->dec_ctx->width  != decoded_frame->width ||
-            ist->dec_ctx->height != decoded_frame->height ||
-            ist->dec_ctx->pix_fmt != decoded_frame->format) {
+        if (ist->dec_state.width   != decoded_frame->width ||
+            ist->dec_state.height  != decoded_frame->height ||
+            ist->dec_state.pix_fmt != decoded_frame->format) {
             av_log(NULL, AV_LOG_DEBUG, "Frame parameters mismatch context %d,%d,%d != %d,%d,%d\n",
                 decoded_frame->width,
                 decoded_frame->height,
                 decoded_frame->format,
-                ist->dec_ctx->width,
-                ist->dec_ctx->height,
-                ist->dec_ctx->pix_fmt);
+                ist->dec_state.width,
+                ist->dec_state.height,
+                ist->dec_state.pix_fmt);
         }
     }
 
@@ -2420,12 +3210,15 @@ static int decode_video(InputStream *ist, AVPacket *pkt, int *got_output, int64_
 
     ist->frames_decoded++;
 
-    if (ist->hwaccel_retrieve_data && decoded_frame->format == ist->hwaccel_pix_fmt) {
-        err = ist->hwaccel_retrieve_data(ist->dec_ctx, decoded_frame);
-        if (err < 0)
-            goto fail;
-    }
-    ist->hwaccel_retrieved_pix_fmt = decoded_frame->format;
+#if HAVE_THREADS
+    /* the decoder thread already did it */
+    if (ist->dec_queue)
+        err = ist->dec_retrieve_err;
+    else
+#endif
+    err = hwaccel_retrieve(ist, decoded_frame);
+    if (err < 0)
+        goto fail;
 
     best_effort_timestamp= decoded_frame->best_effort_timestamp;
     *duration_pts = decoded_frame->pkt_duration;
@@ -2570,7 +3363,7 @@ static int process_input_packet(InputStream *ist, const AVPacket *pkt, int no_eo
 
     if (!ist->saw_first_ts) {
         ist->first_dts =
-        ist->dts = ist->st->avg_frame_rate.num ? - ist->dec_ctx->has_b_frames * AV_TIME_BASE / av_q2d(ist->st->avg_frame_rate) : 0;
+        ist->dts = ist->st->avg_frame_rate.num ? - ist->dec_state.has_b_frames * AV_TIME_BASE / av_q2d(ist->st->avg_frame_rate) : 0;
         ist->pts = 0;
         if (pkt && pkt->pts != AV_NOPTS_VALUE && !ist->decoding_needed) {
             ist->first_dts =
@@ -2620,11 +3413,11 @@ static int process_input_packet(InputStream *ist, const AVPacket *pkt, int no_eo
             if (!repeating || !pkt || got_output) {
                 if (pkt && pkt->duration) {
                     duration_dts = av_rescale_q(pkt->duration, ist->st->time_base, AV_TIME_BASE_Q);
-                } else if(ist->dec_ctx->framerate.num != 0 && ist->dec_ctx->framerate.den != 0) {
-                    int ticks= av_stream_get_parser(ist->st) ? av_stream_get_parser(ist->st)->repeat_pict+1 : ist->dec_ctx->ticks_per_frame;
+                } else if(ist->dec_state.framerate.num != 0 && ist->dec_state.framerate.den != 0) {
+                    int ticks= av_stream_get_parser(ist->st) ? av_stream_get_parser(ist->st)->repeat_pict+1 : ist->dec_state.ticks_per_frame;
                     duration_dts = ((int64_t)AV_TIME_BASE *
-                                    ist->dec_ctx->framerate.den * ticks) /
-                                    ist->dec_ctx->framerate.num / ist->dec_ctx->ticks_per_frame;
+                                    ist->dec_state.framerate.den * ticks) /
+                                    ist->dec_state.framerate.num / ist->dec_state.ticks_per_frame;
                 }
 
                 if(ist->dts != AV_NOPTS_VALUE && duration_dts) {
@@ -2906,6 +3699,7 @@ FF_ENABLE_DEPRECATION_WARNINGS
         }
         assert_avoptions(ist->decoder_opts);
     }
+    get_decoder_state(ist->dec_ctx, &ist->dec_state);
 
     ist->next_pts = AV_NOPTS_VALUE;
     ist->next_dts = AV_NOPTS_VALUE;
@@ -2947,6 +3741,12 @@ static int check_init_output_file(OutputFile *of, int file_index)
     //assert_avoptions(of->opts);
     of->header_written = 1;
 
+#if HAVE_THREADS
+    ret = init_muxer_thread(of);
+    if (ret < 0)
+        return ret;
+#endif
+
     av_dump_format(of->ctx, file_index, of->ctx->url, 1);
     nb_output_dumped++;
 
@@ -3257,16 +4057,11 @@ static int init_output_stream_encode(OutputStream *ost, AVFrame *frame)
 {
     InputStream *ist = get_input_stream(ost);
     AVCodecContext *enc_ctx = ost->enc_ctx;
-    AVCodecContext *dec_ctx = NULL;
     AVFormatContext *oc = output_files[ost->file_index]->ctx;
     int ret;
 
     set_encoder_id(output_files[ost->file_index], ost);
 
-    if (ist) {
-        dec_ctx = ist->dec_ctx;
-    }
-
     if (enc_ctx->codec_type == AVMEDIA_TYPE_VIDEO) {
         if (!ost->frame_rate.num)
             ost->frame_rate = av_buffersink_get_frame_rate(ost->filter->filter);
@@ -3305,8 +4100,8 @@ static int init_output_stream_encode(OutputStream *ost, AVFrame *frame)
 
         if (ost->bits_per_raw_sample)
             enc_ctx->bits_per_raw_sample = ost->bits_per_raw_sample;
-        else if (dec_ctx && ost->filter->graph->is_meta)
-            enc_ctx->bits_per_raw_sample = FFMIN(dec_ctx->bits_per_raw_sample,
+        else if (ist && ost->filter->graph->is_meta)
+            enc_ctx->bits_per_raw_sample = FFMIN(ist->dec_state.bits_per_raw_sample,
                                                  av_get_bytes_per_sample(enc_ctx->sample_fmt) << 3);
 
         init_encoder_time_base(ost, av_make_q(1, enc_ctx->sample_rate));
@@ -3334,8 +4129,8 @@ static int init_output_stream_encode(OutputStream *ost, AVFrame *frame)
 
         if (ost->bits_per_raw_sample)
             enc_ctx->bits_per_raw_sample = ost->bits_per_raw_sample;
-        else if (dec_ctx && ost->filter->graph->is_meta)
-            enc_ctx->bits_per_raw_sample = FFMIN(dec_ctx->bits_per_raw_sample,
+        else if (ist && ost->filter->graph->is_meta)
+            enc_ctx->bits_per_raw_sample = FFMIN(ist->dec_state.bits_per_raw_sample,
                                                  av_pix_fmt_desc_get(enc_ctx->pix_fmt)->comp[0].depth);
 
         if (frame) {
@@ -3479,6 +4274,14 @@ static int init_output_stream(OutputStream *ost, AVFrame *frame,
             av_buffersink_set_frame_size(ost->filter->filter,
                                             ost->enc_ctx->frame_size);
         assert_avoptions(ost->encoder_opts);
+#if HAVE_THREADS
+        if ((ret = init_encoder_thread(ost)) < 0) {
+            snprintf(error, error_len,
+                     "Error starting the encoder thread for output stream #%d:%d",
+                     ost->file_index, ost->index);
+            return ret;
+        }
+#endif
         if (ost->enc_ctx->bit_rate && ost->enc_ctx->bit_rate < 1000 &&
             ost->enc_ctx->codec_id != AV_CODEC_ID_CODEC2 /* don't complain about 700 bit/s modes */)
             av_log(NULL, AV_LOG_WARNING, "The bitrate parameter is set too low."
@@ -3763,7 +4566,7 @@ static int need_output(void)
         AVFormatContext *os  = output_files[ost->file_index]->ctx;
 
         if (ost->finished ||
-            (os->pb && avio_tell(os->pb) >= of->limit_filesize))
+            (os->pb && output_file_tell(of) >= of->limit_filesize))
             continue;
         if (ost->frame_number >= ost->max_frames) {
             int j;
@@ -3912,10 +4715,25 @@ static int check_keyboard_interaction(int64_t cur_time)
                 fprintf(stderr,"error parsing debug value\n");
         }
         for(i=0;i<nb_input_streams;i++) {
-            input_streams[i]->dec_ctx->debug = debug;
+            InputStream *ist = input_streams[i];
+            /* the decoder thread owns the decoder context */
+            if (ist->dec_queue) {
+                av_log(NULL, AV_LOG_WARNING, "Not changing the debug flags of "
+                       "input stream #%d:%d, it has a decoder thread\n",
+                       ist->file_index, ist->st->index);
+                continue;
+            }
+            ist->dec_ctx->debug = debug;
         }
         for(i=0;i<nb_output_streams;i++) {
             OutputStream *ost = output_streams[i];
+            /* the encoder thread owns the encoder context */
+            if (ost->enc_queue) {
+                av_log(NULL, AV_LOG_WARNING, "Not changing the debug flags of "
+                       "output stream #%d:%d, it has an encoder thread\n",
+                       ost->file_index, ost->index);
+                continue;
+            }
             ost->enc_ctx->debug = debug;
         }
         if(debug) av_log_set_level(AV_LOG_DEBUG);
@@ -4049,6 +4867,172 @@ static int init_input_threads(void)
     return 0;
 }
 
+static void decoder_queue_free(void *msg)
+{
+    av_packet_free(msg);
+}
+
+static void free_decoder_thread(InputStream *ist)
+{
+    DecodedFrame df;
+
+    if (!ist->dec_queue)
+        return;
+
+    /* drop the pending packets so the thread exits as soon as possible */
+    av_thread_message_flush(ist->dec_queue);
+    av_thread_message_queue_set_err_recv(ist->dec_queue, AVERROR_EOF);
+    pthread_join(ist->dec_thread, NULL);
+    av_thread_message_queue_free(&ist->dec_queue);
+
+    while (av_fifo_read(ist->dec_out, &df, 1) >= 0)
+        av_frame_free(&df.frame);
+    av_fifo_freep2(&ist->dec_out);
+    av_packet_free(&ist->dec_pkt);
+    pthread_cond_destroy(&ist->dec_cond);
+    pthread_mutex_destroy(&ist->dec_lock);
+}
+
+static void free_decoder_threads(void)
+{
+    int i;
+
+    for (i = 0; i < nb_input_streams; i++)
+        free_decoder_thread(input_streams[i]);
+}
+
+static int init_decoder_thread(InputStream *ist)
+{
+    InputFile *f = input_files[ist->file_index];
+    int i, ret;
+
+    if (!f->decode_queue_size || !ist->decoding_needed ||
+        (ist->dec_ctx->codec_type != AVMEDIA_TYPE_VIDEO &&
+         ist->dec_ctx->codec_type != AVMEDIA_TYPE_AUDIO))
+        return 0;
+
+    /* stream copy reads the decoder context on the main thread */
+    for (i = 0; i < nb_output_streams; i++)
+        if (output_streams[i]->stream_copy && get_input_stream(output_streams[i]) == ist)
+            return 0;
+
+    ist->dec_pkt = av_packet_alloc();
+    ist->dec_out = av_fifo_alloc2(f->decode_queue_size, sizeof(DecodedFrame),
+                                  AV_FIFO_FLAG_AUTO_GROW);
+    if (!ist->dec_pkt || !ist->dec_out) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    ret = av_thread_message_queue_alloc(&ist->dec_queue, f->decode_queue_size,
+                                        sizeof(AVPacket *));
+    if (ret < 0)
+        goto fail;
+    av_thread_message_queue_set_free_func(ist->dec_queue, decoder_queue_free);
+
+    pthread_mutex_init(&ist->dec_lock, NULL);
+    pthread_cond_init(&ist->dec_cond, NULL);
+
+    if ((ret = pthread_create(&ist->dec_thread, NULL, decoder_thread, ist))) {
+        av_log(NULL, AV_LOG_ERROR, "pthread_create failed: %s. Try to increase `ulimit -v` or decrease `ulimit -s`.\n", strerror(ret));
+        av_thread_message_queue_free(&ist->dec_queue);
+        pthread_cond_destroy(&ist->dec_cond);
+        pthread_mutex_destroy(&ist->dec_lock);
+        ret = AVERROR(ret);
+        goto fail;
+    }
+
+    return 0;
+fail:
+    av_packet_free(&ist->dec_pkt);
+    av_fifo_freep2(&ist->dec_out);
+    return ret;
+}
+
+static int init_decoder_threads(void)
+{
+    int i, ret;
+
+    for (i = 0; i < nb_input_streams; i++) {
+        ret = init_decoder_thread(input_streams[i]);
+        if (ret < 0)
+            return ret;
+    }
+    return 0;
+}
+
+static void encoder_queue_free(void *msg)
+{
+    av_frame_free(msg);
+}
+
+static void free_encoder_thread(OutputStream *ost)
+{
+    EncoderOutput out;
+
+    if (!ost->enc_queue)
+        return;
+
+    av_thread_message_flush(ost->enc_queue);
+    av_thread_message_queue_set_err_recv(ost->enc_queue, AVERROR_EOF);
+    pthread_join(ost->enc_thread, NULL);
+    av_thread_message_queue_free(&ost->enc_queue);
+
+    while (av_fifo_read(ost->enc_out, &out, 1) >= 0)
+        av_packet_free(&out.pkt);
+    av_fifo_freep2(&ost->enc_out);
+    pthread_cond_destroy(&ost->enc_cond);
+    pthread_mutex_destroy(&ost->enc_lock);
+}
+
+static void free_encoder_threads(void)
+{
+    int i;
+
+    for (i = 0; i < nb_output_streams; i++)
+        if (output_streams[i])
+            free_encoder_thread(output_streams[i]);
+}
+
+static int init_encoder_thread(OutputStream *ost)
+{
+    int ret;
+
+    /* two-pass statistics are written on the main thread */
+    if (ost->async_depth <= 0 || ost->logfile ||
+        (ost->enc_ctx->codec_type != AVMEDIA_TYPE_VIDEO &&
+         ost->enc_ctx->codec_type != AVMEDIA_TYPE_AUDIO))
+        return 0;
+
+    ost->enc_out = av_fifo_alloc2(ost->async_depth, sizeof(EncoderOutput),
+                                  AV_FIFO_FLAG_AUTO_GROW);
+    if (!ost->enc_out)
+        return AVERROR(ENOMEM);
+
+    ret = av_thread_message_queue_alloc(&ost->enc_queue, ost->async_depth,
+                                        sizeof(AVFrame *));
+    if (ret < 0)
+        goto fail;
+    av_thread_message_queue_set_free_func(ost->enc_queue, encoder_queue_free);
+
+    pthread_mutex_init(&ost->enc_lock, NULL);
+    pthread_cond_init(&ost->enc_cond, NULL);
+
+    if ((ret = pthread_create(&ost->enc_thread, NULL, encoder_thread, ost))) {
+        av_log(NULL, AV_LOG_ERROR, "pthread_create failed: %s. Try to increase `ulimit -v` or decrease `ulimit -s`.\n", strerror(ret));
+        av_thread_message_queue_free(&ost->enc_queue);
+        pthread_cond_destroy(&ost->enc_cond);
+        pthread_mutex_destroy(&ost->enc_lock);
+        ret = AVERROR(ret);
+        goto fail;
+    }
+
+    return 0;
+fail:
+    av_fifo_freep2(&ost->enc_out);
+    return ret;
+}
+
 static int get_input_packet_mt(InputFile *f, AVPacket **pkt)
 {
     return av_thread_message_queue_recv(f->in_thread_queue, pkt,
@@ -4152,7 +5136,7 @@ static int seek_to_start(InputFile *ifile, AVFormatContext *is)
 
         if (has_audio) {
             if (avctx->codec_type == AVMEDIA_TYPE_AUDIO && ist->nb_samples) {
-                AVRational sample_rate = {1, avctx->sample_rate};
+                AVRational sample_rate = {1, ist->dec_state.sample_rate};
 
                 duration = av_rescale_q(ist->nb_samples, sample_rate, ist->st->time_base);
             } else {
@@ -4217,6 +5201,14 @@ static int process_input(int file_index)
                 ret = process_input_packet(ist, NULL, 1);
                 if (ret>0)
                     return 0;
+#if HAVE_THREADS
+                if (ist->dec_queue) {
+                    AVPacket *flush_pkt = NULL;
+                    av_thread_message_queue_send(ist->dec_queue, &flush_pkt, 0);
+                    ist->dec_draining = ist->dec_eof = 0;
+                    continue;
+                }
+#endif
                 avcodec_flush_buffers(avctx);
             }
         }
@@ -4641,6 +5633,8 @@ static int transcode(void)
 #if HAVE_THREADS
     if ((ret = init_input_threads()) < 0)
         goto fail;
+    if ((ret = init_decoder_threads()) < 0)
+        goto fail;
 #endif
 
     while (!received_sigterm) {
@@ -4677,13 +5671,25 @@ static int transcode(void)
             process_input_packet(ist, NULL, 0);
         }
     }
+#if HAVE_THREADS
+    free_decoder_threads();
+#endif
     flush_encoders();
+#if HAVE_THREADS
+    free_encoder_threads();
+#endif
 
     term_exit();
 
     /* write the trailer if needed */
     for (i = 0; i < nb_output_files; i++) {
         os = output_files[i]->ctx;
+#if HAVE_THREADS
+        if ((ret = finish_muxer_thread(output_files[i])) < 0) {
+            print_error("av_interleaved_write_frame()", ret);
+            main_return_code = 1;
+        }
+#endif
         if (!output_files[i]->header_written) {
             av_log(NULL, AV_LOG_ERROR,
                    "Nothing was written into output file %d (%s), because "
@@ -4701,6 +5707,9 @@ static int transcode(void)
     /* dump report by using the first video and audio streams */
     print_report(1, timer_start, av_gettime_relative());
 
+    if (profile_filename)
+        write_profile_json();
+
     /* close the output files */
     for (i = 0; i < nb_output_files; i++) {
         os = output_files[i]->ctx;
@@ -4749,6 +5758,7 @@ static int transcode(void)
  fail:
 #if HAVE_THREADS
     free_input_threads();
+    free_decoder_threads();
 #endif
 
     if (output_streams) {
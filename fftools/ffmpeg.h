@@ -116,6 +116,7 @@ typedef struct OptionsContext {
     float readrate;
     int accurate_seek;
     int thread_queue_size;
+    int decode_queue_size;
 
     SpecifierOpt *ts_scale;
     int        nb_ts_scale;
@@ -146,6 +147,7 @@ typedef struct OptionsContext {
     int64_t recording_time;
     int64_t stop_time;
     uint64_t limit_filesize;
+    int64_t thread_queue_max_bytes;
     float mux_preload;
     float mux_max_delay;
     int shortest;
@@ -212,6 +214,8 @@ typedef struct OptionsContext {
     int        nb_passlogfiles;
     SpecifierOpt *max_muxing_queue_size;
     int        nb_max_muxing_queue_size;
+    SpecifierOpt *async_depth;
+    int        nb_async_depth;
     SpecifierOpt *muxing_queue_data_threshold;
     int        nb_muxing_queue_data_threshold;
     SpecifierOpt *guess_layout_max;
@@ -234,6 +238,19 @@ typedef struct OptionsContext {
     int        nb_bits_per_raw_sample;
 } OptionsContext;
 
+/* pixel format conversion of decoded frames shared by several filtergraphs */
+typedef struct SharedConversion {
+    int   format;           ///< pixel format the frames are converted to
+    char *sws_opts;         ///< options of the scale filter doing the conversion
+
+    AVFilterGraph   *graph;
+    AVFilterContext *src, *sink;
+    int in_format, in_width, in_height; ///< input parameters of graph
+
+    AVFrame *frame;         ///< converted frame for frame_serial
+    int64_t  frame_serial;
+} SharedConversion;
+
 typedef struct InputFilter {
     AVFilterContext    *filter;
     struct InputStream *ist;
@@ -256,6 +273,9 @@ typedef struct InputFilter {
     AVBufferRef *hw_frames_ctx;
     int32_t *displaymatrix;
 
+    /* if set, frames are converted with this before being sent to the graph */
+    SharedConversion *conversion;
+
     int eof;
 } InputFilter;
 
@@ -283,6 +303,36 @@ typedef struct OutputFilter {
     const int *sample_rates;
 } OutputFilter;
 
+/* counters of a decoding, encoding or muxing stage, for -profile_json */
+typedef struct StageProfile {
+    uint64_t calls;     /* number of calls into the codec or muxer */
+    uint64_t frames;    /* frames decoded, frames encoded or packets muxed */
+    uint64_t bytes;     /* packet bytes decoded, encoded or muxed */
+    int64_t  wall_time; /* microseconds */
+    int64_t  cpu_time;  /* microseconds of thread CPU time, negative if unavailable */
+} StageProfile;
+
+/*
+ * decoder context fields used outside of decoding; with a decoder thread, they
+ * are copied on that thread with each frame, as it owns the decoder context
+ */
+typedef struct DecoderState {
+    int has_b_frames;
+    int width, height;
+    enum AVPixelFormat pix_fmt;
+    AVRational framerate;
+    int ticks_per_frame;
+    int sample_rate;
+    int bits_per_raw_sample;
+} DecoderState;
+
+/* counters of a filter accumulated over all configurations of its graph */
+typedef struct FilterProfile {
+    char           *name;
+    const char     *filter;
+    AVFilterProfile counters;
+} FilterProfile;
+
 typedef struct FilterGraph {
     int            index;
     const char    *graph_desc;
@@ -297,6 +347,9 @@ typedef struct FilterGraph {
     int          nb_inputs;
     OutputFilter **outputs;
     int         nb_outputs;
+
+    FilterProfile *profiles;
+    int         nb_profiles;
 } FilterGraph;
 
 typedef struct InputStream {
@@ -309,6 +362,7 @@ typedef struct InputStream {
 #define DECODING_FOR_FILTER 2
 
     AVCodecContext *dec_ctx;
+    DecoderState dec_state;
     const AVCodec *dec;
     AVFrame *decoded_frame;
     AVPacket *pkt;
@@ -366,6 +420,11 @@ typedef struct InputStream {
     InputFilter **filters;
     int        nb_filters;
 
+    /* format conversions shared between the filters above */
+    SharedConversion **conversions;
+    int             nb_conversions;
+    int64_t frame_serial; ///< incremented for every frame sent to the filters
+
     int reinit_filters;
 
     /* hwaccel options */
@@ -390,10 +449,27 @@ typedef struct InputStream {
     uint64_t frames_decoded;
     uint64_t samples_decoded;
 
+    StageProfile dec_profile;
+
     int64_t *dts_buffer;
     int nb_dts_buffer;
 
     int got_output;
+
+#if HAVE_THREADS
+    /* decoder thread, only used when -decode_queue_size is set */
+    AVThreadMessageQueue *dec_queue; /* packets sent to the decoder thread */
+    AVFifo *dec_out;                 /* DecodedFrame entries produced by it */
+    AVPacket *dec_pkt;               /* storage for dec_frame_pkt */
+    AVPacket *dec_frame_pkt;         /* packet the last frame was returned for */
+    pthread_t dec_thread;
+    pthread_mutex_t dec_lock;        /* protects dec_out and dec_thread_err */
+    pthread_cond_t dec_cond;
+    int dec_thread_err;              /* fatal error in the decoder thread */
+    int dec_draining;                /* a drain packet was sent to the thread */
+    int dec_eof;                     /* the decoder thread returned EOF */
+    int dec_retrieve_err;            /* hwaccel download error of the last frame */
+#endif
 } InputStream;
 
 typedef struct InputFile {
@@ -426,6 +502,7 @@ typedef struct InputFile {
     int non_blocking;           /* reading packets from the thread should not block */
     int joined;                 /* the thread has been joined */
     int thread_queue_size;      /* maximum number of queued packets */
+    int decode_queue_size;      /* maximum number of packets queued per decoder thread */
 #endif
 } InputFile;
 
@@ -464,6 +541,10 @@ typedef struct OutputStream {
     int64_t first_pts;
     /* dts of the last packet sent to the muxer */
     int64_t last_mux_dts;
+#if HAVE_THREADS
+    /* av_stream_get_end_pts() as seen by the muxer thread */
+    int64_t mux_end_pts;
+#endif
     // the timebase of the packets sent to the muxer
     AVRational mux_timebase;
     AVRational enc_timebase;
@@ -549,6 +630,8 @@ typedef struct OutputStream {
     uint64_t frames_encoded;
     uint64_t samples_encoded;
 
+    StageProfile enc_profile;
+
     /* packet quality factor */
     int quality;
 
@@ -571,6 +654,20 @@ typedef struct OutputStream {
 
     /* frame encode sum of squared error values */
     int64_t error[4];
+    /* encoder's accumulated sum of squared errors, as of the last packet */
+    int64_t enc_error[4];
+
+    int async_depth;                 /* maximum number of frames queued to the encoder thread */
+#if HAVE_THREADS
+    /* encoder thread, only used when -async_depth is set */
+    AVThreadMessageQueue *enc_queue; /* frames sent to the encoder thread */
+    AVFifo *enc_out;                 /* EncoderOutput entries produced by it */
+    pthread_t enc_thread;
+    pthread_mutex_t enc_lock;        /* protects enc_out and enc_thread_err */
+    pthread_cond_t enc_cond;
+    int enc_thread_err;              /* error or EOF returned by the encoder */
+    int enc_draining;                /* the drain request was sent to the thread */
+#endif
 } OutputStream;
 
 typedef struct OutputFile {
@@ -584,6 +681,21 @@ typedef struct OutputFile {
     int shortest;
 
     int header_written;
+
+    StageProfile mux_profile;
+
+#if HAVE_THREADS
+    AVThreadMessageQueue *mux_queue;
+    pthread_t mux_thread;
+    pthread_mutex_t mux_lock;
+    pthread_cond_t mux_cond;
+    int thread_queue_size;          /* maximum number of queued packets, 0 to mux in the main thread */
+    int64_t thread_queue_max_bytes; /* maximum size of the queued packet data, 0 for no limit */
+    int64_t mux_queue_bytes;        /* size of the packet data currently queued */
+    int64_t mux_size;               /* output size as seen by the muxer thread */
+    int mux_thread_ret;
+    int mux_thread_done;            /* set by the muxer thread when it exits */
+#endif
 } OutputFile;
 
 extern InputStream **input_streams;
@@ -600,6 +712,7 @@ extern FilterGraph **filtergraphs;
 extern int        nb_filtergraphs;
 
 extern char *vstats_filename;
+extern char *profile_filename;
 extern char *sdp_filename;
 
 extern float audio_drift_threshold;
@@ -630,9 +743,11 @@ extern AVIOContext *progress_avio;
 extern float max_error_rate;
 
 extern char *filter_nbthreads;
+extern char *filter_thread_type;
 extern int filter_complex_nbthreads;
 extern int vstats_version;
 extern int auto_conversion_filters;
+extern int shared_conversion;
 
 extern const AVIOInterruptCB int_cb;
 
@@ -654,6 +769,8 @@ void assert_avoptions(AVDictionary *m);
 int guess_input_channel_layout(InputStream *ist);
 
 int configure_filtergraph(FilterGraph *fg);
+/* add the profiling counters of the current graph to fg->profiles */
+int filtergraph_collect_profile(FilterGraph *fg);
 void check_filter_outputs(void);
 int filtergraph_is_simple(FilterGraph *fg);
 int init_simple_filtergraph(InputStream *ist, OutputStream *ost);
@@ -662,6 +779,9 @@ int init_complex_filtergraph(FilterGraph *fg);
 void sub2video_update(InputStream *ist, int64_t heartbeat_pts, AVSubtitle *sub);
 
 int ifilter_parameters_from_frame(InputFilter *ifilter, const AVFrame *frame);
+int ifilter_convert_frame(InputFilter *ifilter, AVFrame *frame, int cached,
+                          AVFrame **out);
+void shared_conversion_free(SharedConversion **pconv);
 
 int ffmpeg_parse_options(int argc, char **argv);
 
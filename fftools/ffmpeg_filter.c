@@ -946,6 +946,224 @@ static void cleanup_filtergraph(FilterGraph *fg)
     avfilter_graph_free(&fg->graph);
 }
 
+int filtergraph_collect_profile(FilterGraph *fg)
+{
+    for (unsigned i = 0; i < fg->graph->nb_filters; i++) {
+        AVFilterContext *f = fg->graph->filters[i];
+        const AVFilterProfile *src = avfilter_get_profile(f);
+        FilterProfile *dst = NULL;
+
+        for (int j = 0; j < fg->nb_profiles; j++) {
+            if (!strcmp(fg->profiles[j].name, f->name)) {
+                dst = &fg->profiles[j];
+                break;
+            }
+        }
+        if (!dst) {
+            char *name = av_strdup(f->name);
+            if (!name)
+                return AVERROR(ENOMEM);
+            dst = av_dynarray2_add((void **)&fg->profiles, &fg->nb_profiles,
+                                   sizeof(*fg->profiles), NULL);
+            if (!dst) {
+                av_free(name);
+                return AVERROR(ENOMEM);
+            }
+            memset(dst, 0, sizeof(*dst));
+            dst->name   = name;
+            dst->filter = f->filter->name;
+        }
+
+        dst->counters.nb_activations  += src->nb_activations;
+        dst->counters.wall_time       += src->wall_time;
+        dst->counters.frames_in       += src->frames_in;
+        dst->counters.frames_out      += src->frames_out;
+        dst->counters.bytes_allocated += src->bytes_allocated;
+        if (src->cpu_time >= 0 && dst->counters.cpu_time >= 0)
+            dst->counters.cpu_time += src->cpu_time;
+        else
+            dst->counters.cpu_time = -1;
+    }
+
+    return 0;
+}
+
+void shared_conversion_free(SharedConversion **pconv)
+{
+    SharedConversion *conv = *pconv;
+
+    if (!conv)
+        return;
+
+    avfilter_graph_free(&conv->graph);
+    av_frame_free(&conv->frame);
+    av_freep(&conv->sws_opts);
+    av_freep(pconv);
+}
+
+static int shared_conversion_configure(SharedConversion *conv, const AVFrame *frame)
+{
+    const enum AVPixelFormat pix_fmts[] = { conv->format, AV_PIX_FMT_NONE };
+    AVFilterContext *scale;
+    char args[256];
+    int ret;
+
+    avfilter_graph_free(&conv->graph);
+    conv->graph = avfilter_graph_alloc();
+    if (!conv->graph)
+        return AVERROR(ENOMEM);
+
+    snprintf(args, sizeof(args),
+             "video_size=%dx%d:pix_fmt=%d:time_base=1/%d:pixel_aspect=%d/%d",
+             frame->width, frame->height, frame->format, AV_TIME_BASE,
+             frame->sample_aspect_ratio.num, FFMAX(frame->sample_aspect_ratio.den, 1));
+    ret = avfilter_graph_create_filter(&conv->src, avfilter_get_by_name("buffer"),
+                                       "shared_conversion_in", args, NULL, conv->graph);
+    if (ret < 0)
+        return ret;
+    ret = avfilter_graph_create_filter(&scale, avfilter_get_by_name("scale"),
+                                       "shared_conversion", conv->sws_opts, NULL,
+                                       conv->graph);
+    if (ret < 0)
+        return ret;
+    ret = avfilter_graph_create_filter(&conv->sink, avfilter_get_by_name("buffersink"),
+                                       "shared_conversion_out", NULL, NULL, conv->graph);
+    if (ret < 0)
+        return ret;
+    ret = av_opt_set_int_list(conv->sink, "pix_fmts", pix_fmts,
+                              AV_PIX_FMT_NONE, AV_OPT_SEARCH_CHILDREN);
+    if (ret < 0)
+        return ret;
+
+    if ((ret = avfilter_link(conv->src, 0, scale, 0)) < 0 ||
+        (ret = avfilter_link(scale, 0, conv->sink, 0)) < 0 ||
+        (ret = avfilter_graph_config(conv->graph, NULL)) < 0)
+        return ret;
+
+    conv->in_format = frame->format;
+    conv->in_width  = frame->width;
+    conv->in_height = frame->height;
+
+    return 0;
+}
+
+int ifilter_convert_frame(InputFilter *ifilter, AVFrame *frame, int cached,
+                          AVFrame **out)
+{
+    SharedConversion *conv = ifilter->conversion;
+    int64_t serial = cached ? ifilter->ist->frame_serial : -1;
+    int ret;
+
+    if (serial >= 0 && conv->frame_serial == serial) {
+        *out = conv->frame;
+        return 0;
+    }
+
+    if (!conv->graph || conv->in_format != frame->format ||
+        conv->in_width != frame->width || conv->in_height != frame->height) {
+        ret = shared_conversion_configure(conv, frame);
+        if (ret < 0) {
+            avfilter_graph_free(&conv->graph);
+            return ret;
+        }
+    }
+
+    conv->frame_serial = -1;
+    av_frame_unref(conv->frame);
+
+    ret = av_buffersrc_add_frame_flags(conv->src, frame, AV_BUFFERSRC_FLAG_KEEP_REF);
+    if (ret < 0)
+        return ret;
+    ret = av_buffersink_get_frame(conv->sink, conv->frame);
+    if (ret < 0)
+        return ret;
+
+    conv->frame_serial = serial;
+    *out = conv->frame;
+    return 0;
+}
+
+/*
+ * Check whether the only thing the graph does to the frames of this input
+ * before the first user filter is an automatic pixel format conversion, and
+ * if so return the pixel format converted to.
+ */
+static int ifilter_auto_conversion_format(InputFilter *ifilter)
+{
+    AVFilterContext *cur = ifilter->filter;
+
+    while (cur->nb_outputs == 1) {
+        AVFilterLink    *link = cur->outputs[0];
+        AVFilterContext *next = link->dst;
+
+        if (!strncmp(next->name, "auto_scale_", 11)) {
+            AVFilterLink *out = next->outputs[0];
+
+            if (out->w != link->w || out->h != link->h || out->format == link->format)
+                return AV_PIX_FMT_NONE;
+            return out->format;
+        }
+        /* these do not touch the frame data */
+        if (strcmp(next->filter->name, "null") && strcmp(next->filter->name, "trim"))
+            return AV_PIX_FMT_NONE;
+        cur = next;
+    }
+
+    return AV_PIX_FMT_NONE;
+}
+
+/*
+ * Set up a shared format conversion for an input whose frames are
+ * converted by the graph anyway. Returns 1 if the graph must be
+ * reconfigured for the converted format.
+ */
+static int ifilter_setup_shared_conversion(InputFilter *ifilter)
+{
+    InputStream *ist = ifilter->ist;
+    FilterGraph  *fg = ifilter->graph;
+    const char *sws_opts = fg->graph->scale_sws_opts ? fg->graph->scale_sws_opts : "";
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(ifilter->format);
+    SharedConversion *conv = NULL;
+    int format;
+
+    if (ifilter->conversion || ifilter->type != AVMEDIA_TYPE_VIDEO ||
+        ist->nb_filters < 2 || !desc || desc->flags & AV_PIX_FMT_FLAG_HWACCEL)
+        return 0;
+
+    format = ifilter_auto_conversion_format(ifilter);
+    if (format == AV_PIX_FMT_NONE)
+        return 0;
+
+    for (int i = 0; i < ist->nb_conversions; i++) {
+        if (ist->conversions[i]->format == format &&
+            !strcmp(ist->conversions[i]->sws_opts, sws_opts)) {
+            conv = ist->conversions[i];
+            break;
+        }
+    }
+    if (!conv) {
+        conv = av_mallocz(sizeof(*conv));
+        if (!conv)
+            return AVERROR(ENOMEM);
+        conv->format       = format;
+        conv->frame_serial = -1;
+        conv->sws_opts     = av_strdup(sws_opts);
+        conv->frame        = av_frame_alloc();
+        if (!conv->sws_opts || !conv->frame ||
+            av_dynarray_add_nofree(&ist->conversions, &ist->nb_conversions, conv) < 0) {
+            shared_conversion_free(&conv);
+            return AVERROR(ENOMEM);
+        }
+        av_log(NULL, AV_LOG_VERBOSE, "Sharing conversion of input stream #%d:%d to %s\n",
+               ist->file_index, ist->st->index, av_get_pix_fmt_name(format));
+    }
+
+    ifilter->conversion = conv;
+    ifilter->format     = format;
+
+    return 1;
+}
+
 static int filter_is_buffersrc(const AVFilterContext *f)
 {
     return f->nb_inputs == 0 &&
@@ -977,9 +1195,15 @@ int configure_filtergraph(FilterGraph *fg)
     const char *graph_desc = simple ? fg->outputs[0]->ost->avfilter :
                                       fg->graph_desc;
 
+    if (fg->graph && fg->graph->profile) {
+        ret = filtergraph_collect_profile(fg);
+        if (ret < 0)
+            return ret;
+    }
     cleanup_filtergraph(fg);
     if (!(fg->graph = avfilter_graph_alloc()))
         return AVERROR(ENOMEM);
+    fg->graph->profile = !!profile_filename;
 
     if (simple) {
         OutputStream *ost = fg->outputs[0]->ost;
@@ -1020,6 +1244,12 @@ int configure_filtergraph(FilterGraph *fg)
         fg->graph->nb_threads = filter_complex_nbthreads;
     }
 
+    if (filter_thread_type) {
+        ret = av_opt_set(fg->graph, "thread_type", filter_thread_type, 0);
+        if (ret < 0)
+            goto fail;
+    }
+
     if ((ret = avfilter_graph_parse2(fg->graph, graph_desc, &inputs, &outputs)) < 0)
         goto fail;
 
@@ -1070,6 +1300,19 @@ int configure_filtergraph(FilterGraph *fg)
     if ((ret = avfilter_graph_config(fg->graph, NULL)) < 0)
         goto fail;
 
+    if (shared_conversion) {
+        int reconfigure = 0;
+
+        for (i = 0; i < fg->nb_inputs; i++) {
+            ret = ifilter_setup_shared_conversion(fg->inputs[i]);
+            if (ret < 0)
+                goto fail;
+            reconfigure |= ret;
+        }
+        if (reconfigure)
+            return configure_filtergraph(fg);
+    }
+
     fg->is_meta = graph_is_meta(fg->graph);
 
     /* limit the lists of allowed formats to the ones selected, to
@@ -1106,9 +1349,15 @@ int configure_filtergraph(FilterGraph *fg)
     }
 
     for (i = 0; i < fg->nb_inputs; i++) {
-        AVFrame *tmp;
-        while (av_fifo_read(fg->inputs[i]->frame_queue, &tmp, 1) >= 0) {
-            ret = av_buffersrc_add_frame(fg->inputs[i]->filter, tmp);
+        InputFilter *ifilter = fg->inputs[i];
+        AVFrame *tmp, *frame;
+        while (av_fifo_read(ifilter->frame_queue, &tmp, 1) >= 0) {
+            frame = tmp;
+            ret = 0;
+            if (ifilter->conversion && tmp->format != ifilter->format)
+                ret = ifilter_convert_frame(ifilter, tmp, 0, &frame);
+            if (ret >= 0)
+                ret = av_buffersrc_add_frame(ifilter->filter, frame);
             av_frame_free(&tmp);
             if (ret < 0)
                 goto fail;
@@ -90,6 +90,7 @@ static const char *const opt_name_canvas_sizes[]              = {"canvas_size",
 static const char *const opt_name_pass[]                      = {"pass", NULL};
 static const char *const opt_name_passlogfiles[]              = {"passlogfile", NULL};
 static const char *const opt_name_max_muxing_queue_size[]     = {"max_muxing_queue_size", NULL};
+static const char *const opt_name_async_depth[]               = {"async_depth", NULL};
 static const char *const opt_name_muxing_queue_data_threshold[] = {"muxing_queue_data_threshold", NULL};
 static const char *const opt_name_guess_layout_max[]          = {"guess_layout_max", NULL};
 static const char *const opt_name_apad[]                      = {"apad", NULL};
@@ -139,6 +140,7 @@ static const char *const opt_name_bits_per_raw_sample[]       = {"bits_per_raw_s
 HWDevice *filter_hw_device;
 
 char *vstats_filename;
+char *profile_filename;
 char *sdp_filename;
 
 float audio_drift_threshold = 0.1;
@@ -164,9 +166,11 @@ int qp_hist           = 0;
 int stdin_interaction = 1;
 float max_error_rate  = 2.0/3;
 char *filter_nbthreads;
+char *filter_thread_type;
 int filter_complex_nbthreads = 0;
 int vstats_version = 2;
 int auto_conversion_filters = 1;
+int shared_conversion = 0;
 int64_t stats_period = 500000;
 
 
@@ -263,6 +267,13 @@ static int opt_filter_threads(void *optctx, const char *opt, const char *arg)
     return 0;
 }
 
+static int opt_filter_thread_type(void *optctx, const char *opt, const char *arg)
+{
+    av_free(filter_thread_type);
+    filter_thread_type = av_strdup(arg);
+    return 0;
+}
+
 static int opt_abort_on(void *optctx, const char *opt, const char *arg)
 {
     static const AVOption opts[] = {
@@ -775,6 +786,27 @@ static const AVCodec *choose_decoder(OptionsContext *o, AVFormatContext *s, AVSt
         return avcodec_find_decoder(st->codecpar->codec_id);
 }
 
+/*
+ * Pass -async_depth on to codecs having an asynchronous mode of their own,
+ * instead of running them in a separate thread. Returns 1 if the codec
+ * takes the option.
+ */
+static int set_codec_async_depth(OptionsContext *o, AVFormatContext *s, AVStream *st,
+                                 const AVCodec *codec, AVDictionary **opts)
+{
+    int async_depth = -1;
+
+    if (!codec || !codec->priv_class ||
+        !av_opt_find((void *)&codec->priv_class, "async_depth", NULL, 0,
+                     AV_OPT_SEARCH_FAKE_OBJ))
+        return 0;
+
+    MATCH_PER_STREAM_OPT(async_depth, i, async_depth, s, st);
+    if (async_depth >= 0)
+        av_dict_set_int(opts, "async_depth", async_depth, 0);
+    return 1;
+}
+
 /* Add all the streams from the given input file to the global
  * list of input streams. */
 static void add_input_streams(OptionsContext *o, AVFormatContext *ic)
@@ -826,6 +858,7 @@ static void add_input_streams(OptionsContext *o, AVFormatContext *ic)
 
         ist->dec = choose_decoder(o, ic, st);
         ist->decoder_opts = filter_codec_opts(o->g->codec_opts, ist->st->codecpar->codec_id, ic, st, ist->dec);
+        set_codec_async_depth(o, ic, st, ist->dec, &ist->decoder_opts);
 
         ist->reinit_filters = -1;
         MATCH_PER_STREAM_OPT(reinit_filters, i, ist->reinit_filters, ic, st);
@@ -1296,6 +1329,7 @@ static int open_input_file(OptionsContext *o, const char *filename)
         exit_program(1);
 #if HAVE_THREADS
     f->thread_queue_size = o->thread_queue_size;
+    f->decode_queue_size = o->decode_queue_size;
 #endif
 
     /* check if all codec options have been used */
@@ -1489,6 +1523,8 @@ static OutputStream *new_output_stream(OptionsContext *o, AVFormatContext *oc, e
         char *buf = NULL, *arg = NULL, *preset = NULL;
 
         ost->encoder_opts  = filter_codec_opts(o->g->codec_opts, ost->enc->id, oc, st, ost->enc);
+        if (!set_codec_async_depth(o, oc, st, ost->enc, &ost->encoder_opts))
+            MATCH_PER_STREAM_OPT(async_depth, i, ost->async_depth, oc, st);
 
         MATCH_PER_STREAM_OPT(presets, str, preset, oc, st);
         ost->autoscale = 1;
@@ -2286,6 +2322,10 @@ static int open_output_file(OptionsContext *o, const char *filename)
     of->start_time     = o->start_time;
     of->limit_filesize = o->limit_filesize;
     of->shortest       = o->shortest;
+#if HAVE_THREADS
+    of->thread_queue_size      = FFMAX(o->thread_queue_size, 0);
+    of->thread_queue_max_bytes = o->thread_queue_max_bytes;
+#endif
     av_dict_copy(&of->opts, o->g->format_opts, 0);
 
     if (!strcmp(filename, "-"))
@@ -3584,6 +3624,8 @@ const OptionDef options[] = {
         "add timings for benchmarking" },
     { "benchmark_all",  OPT_BOOL | OPT_EXPERT,                       { &do_benchmark_all },
       "add timings for each task" },
+    { "profile_json",   HAS_ARG | OPT_STRING | OPT_EXPERT,           { &profile_filename },
+      "write per stage and per filter profiling counters to a JSON file", "file" },
     { "progress",       HAS_ARG | OPT_EXPERT,                        { .func_arg = opt_progress },
       "write program-readable progress information", "url" },
     { "stdin",          OPT_BOOL | OPT_EXPERT,                       { &stdin_interaction },
@@ -3656,6 +3698,8 @@ const OptionDef options[] = {
         "set stream filtergraph", "filter_graph" },
     { "filter_threads", HAS_ARG,                                     { .func_arg = opt_filter_threads },
         "number of non-complex filter threads" },
+    { "filter_thread_type", HAS_ARG | OPT_EXPERT,                    { .func_arg = opt_filter_thread_type },
+        "set the threading types allowed in all filtergraphs", "flags" },
     { "filter_script",  HAS_ARG | OPT_STRING | OPT_SPEC | OPT_OUTPUT, { .off = OFFSET(filter_scripts) },
         "read stream filtergraph description from a file", "filename" },
     { "reinit_filter",  HAS_ARG | OPT_INT | OPT_SPEC | OPT_INPUT,    { .off = OFFSET(reinit_filters) },
@@ -3670,6 +3714,8 @@ const OptionDef options[] = {
         "read complex filtergraph description from a file", "filename" },
     { "auto_conversion_filters", OPT_BOOL | OPT_EXPERT,              { &auto_conversion_filters },
         "enable automatic conversion filters globally" },
+    { "shared_conversion", OPT_BOOL | OPT_EXPERT,                    { &shared_conversion },
+        "convert decoded frames once for all filtergraphs needing the same format" },
     { "stats",          OPT_BOOL,                                    { &print_stats },
         "print progress report during encoding", },
     { "stats_period",    HAS_ARG | OPT_EXPERT,                       { .func_arg = opt_stats_period },
@@ -3692,9 +3738,15 @@ const OptionDef options[] = {
     { "disposition",    OPT_STRING | HAS_ARG | OPT_SPEC |
                         OPT_OUTPUT,                                  { .off = OFFSET(disposition) },
         "disposition", "" },
-    { "thread_queue_size", HAS_ARG | OPT_INT | OPT_OFFSET | OPT_EXPERT | OPT_INPUT,
+    { "thread_queue_size", HAS_ARG | OPT_INT | OPT_OFFSET | OPT_EXPERT | OPT_INPUT | OPT_OUTPUT,
                                                                      { .off = OFFSET(thread_queue_size) },
-        "set the maximum number of queued packets from the demuxer" },
+        "set the maximum number of queued packets from the demuxer or to the muxer" },
+    { "thread_queue_max_bytes", HAS_ARG | OPT_INT64 | OPT_OFFSET | OPT_EXPERT | OPT_OUTPUT,
+                                                                     { .off = OFFSET(thread_queue_max_bytes) },
+        "set the maximum size in bytes of the packets queued to the muxer" },
+    { "decode_queue_size", HAS_ARG | OPT_INT | OPT_OFFSET | OPT_EXPERT | OPT_INPUT,
+                                                                     { .off = OFFSET(decode_queue_size) },
+        "run each decoder in its own thread with this many queued packets" },
     { "find_stream_info", OPT_BOOL | OPT_PERFILE | OPT_INPUT | OPT_EXPERT, { &find_stream_info },
         "read and decode the streams to fill missing information with heuristics" },
     { "bits_per_raw_sample", OPT_INT | HAS_ARG | OPT_EXPERT | OPT_SPEC | OPT_OUTPUT,
@@ -3868,6 +3920,8 @@ const OptionDef options[] = {
     { "fpre", HAS_ARG | OPT_EXPERT| OPT_PERFILE | OPT_OUTPUT,                { .func_arg = opt_preset },
         "set options from indicated preset file", "filename" },
 
+    { "async_depth", HAS_ARG | OPT_INT | OPT_SPEC | OPT_EXPERT | OPT_INPUT | OPT_OUTPUT, { .off = OFFSET(async_depth) },
+        "run the encoder in its own thread with this many frames in flight", "frames" },
     { "max_muxing_queue_size", HAS_ARG | OPT_INT | OPT_SPEC | OPT_EXPERT | OPT_OUTPUT, { .off = OFFSET(max_muxing_queue_size) },
         "maximum number of packets that can be buffered while waiting for all streams to initialize", "packets" },
     { "muxing_queue_data_threshold", HAS_ARG | OPT_INT | OPT_SPEC | OPT_EXPERT | OPT_OUTPUT, { .off = OFFSET(muxing_queue_data_threshold) },
@@ -37,6 +37,7 @@
 #include "libavutil/pixdesc.h"
 #include "libavutil/imgutils.h"
 #include "libavutil/dict.h"
+#include "libavutil/executor.h"
 #include "libavutil/fifo.h"
 #include "libavutil/parseutils.h"
 #include "libavutil/samplefmt.h"
@@ -1300,6 +1301,7 @@ static void do_exit(VideoState *is)
     if (window)
         SDL_DestroyWindow(window);
     uninit_opts();
+    av_executor_global_uninit();
 #if CONFIG_AVFILTER
     av_freep(&vfilters_list);
 #endif
@@ -553,19 +553,205 @@ static void copy_input_samples(AACEncContext *s, const AVFrame *frame)
     }
 }
 
+/**
+ * Window decision, transform and clipping analysis of one channel element.
+ */
+static int transform_element(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    AACEncContext *s = avctx->priv_data;
+    AACEncContext *t = s->thread[threadnr];
+    const AVFrame *frame = arg;
+    const int start_ch = s->elements[jobnr].start_ch;
+    FFPsyWindowInfo *wi = s->windows + start_ch;
+    float *samples2, *la, *overlap;
+    ChannelElement *cpe = &s->cpe[jobnr];
+    SingleChannelElement *sce;
+    IndividualChannelStream *ics;
+    int ch, w;
+    const int tag   = s->chan_map[jobnr + 1];
+    const int chans = tag == TYPE_CPE ? 2 : 1;
+
+    for (ch = 0; ch < chans; ch++) {
+        int k;
+        float clip_avoidance_factor;
+        sce = &cpe->ch[ch];
+        ics = &sce->ics;
+        t->cur_channel = start_ch + ch;
+        overlap  = &s->planar_samples[t->cur_channel][0];
+        samples2 = overlap + 1024;
+        la       = samples2 + (448+64);
+        if (!frame)
+            la = NULL;
+        if (tag == TYPE_LFE) {
+            wi[ch].window_type[0] = wi[ch].window_type[1] = ONLY_LONG_SEQUENCE;
+            wi[ch].window_shape   = 0;
+            wi[ch].num_windows    = 1;
+            wi[ch].grouping[0]    = 1;
+            wi[ch].clipping[0]    = 0;
+
+            /* Only the lowest 12 coefficients are used in a LFE channel.
+             * The expression below results in only the bottom 8 coefficients
+             * being used for 11.025kHz to 16kHz sample rates.
+             */
+            ics->num_swb = s->samplerate_index >= 8 ? 1 : 3;
+        } else {
+            wi[ch] = s->psy.model->window(&t->psy, samples2, la, t->cur_channel,
+                                          ics->window_sequence[0]);
+        }
+        ics->window_sequence[1] = ics->window_sequence[0];
+        ics->window_sequence[0] = wi[ch].window_type[0];
+        ics->use_kb_window[1]   = ics->use_kb_window[0];
+        ics->use_kb_window[0]   = wi[ch].window_shape;
+        ics->num_windows        = wi[ch].num_windows;
+        ics->swb_sizes          = s->psy.bands    [ics->num_windows == 8];
+        ics->num_swb            = tag == TYPE_LFE ? ics->num_swb : s->psy.num_bands[ics->num_windows == 8];
+        ics->max_sfb            = FFMIN(ics->max_sfb, ics->num_swb);
+        ics->swb_offset         = wi[ch].window_type[0] == EIGHT_SHORT_SEQUENCE ?
+                                    ff_swb_offset_128 [s->samplerate_index]:
+                                    ff_swb_offset_1024[s->samplerate_index];
+        ics->tns_max_bands      = wi[ch].window_type[0] == EIGHT_SHORT_SEQUENCE ?
+                                    ff_tns_max_bands_128 [s->samplerate_index]:
+                                    ff_tns_max_bands_1024[s->samplerate_index];
+
+        for (w = 0; w < ics->num_windows; w++)
+            ics->group_len[w] = wi[ch].grouping[w];
+
+        /* Calculate input sample maximums and evaluate clipping risk */
+        clip_avoidance_factor = 0.0f;
+        for (w = 0; w < ics->num_windows; w++) {
+            const float *wbuf = overlap + w * 128;
+            const int wlen = 2048 / ics->num_windows;
+            float max = 0;
+            int j;
+            /* mdct input is 2 * output */
+            for (j = 0; j < wlen; j++)
+                max = FFMAX(max, fabsf(wbuf[j]));
+            wi[ch].clipping[w] = max;
+        }
+        for (w = 0; w < ics->num_windows; w++) {
+            if (wi[ch].clipping[w] > CLIP_AVOIDANCE_FACTOR) {
+                ics->window_clipping[w] = 1;
+                clip_avoidance_factor = FFMAX(clip_avoidance_factor, wi[ch].clipping[w]);
+            } else {
+                ics->window_clipping[w] = 0;
+            }
+        }
+        if (clip_avoidance_factor > CLIP_AVOIDANCE_FACTOR) {
+            ics->clip_avoidance_factor = CLIP_AVOIDANCE_FACTOR / clip_avoidance_factor;
+        } else {
+            ics->clip_avoidance_factor = 1.0f;
+        }
+
+        apply_window_and_mdct(t, sce, overlap);
+
+        if (s->options.ltp && s->coder->update_ltp) {
+            s->coder->update_ltp(t, sce);
+            apply_window[sce->ics.window_sequence[0]](t->fdsp, sce, &sce->ltp_state[0]);
+            t->mdct1024.mdct_calc(&t->mdct1024, sce->lcoeffs, sce->ret_buf);
+        }
+
+        for (k = 0; k < 1024; k++) {
+            if (!(fabs(cpe->ch[ch].coeffs[k]) < 1E16)) { // Ensure headroom for energy calculation
+                av_log(avctx, AV_LOG_ERROR, "Input contains (near) NaN/+-Inf\n");
+                return AVERROR(EINVAL);
+            }
+        }
+        avoid_clipping(t, sce);
+    }
+
+    return 0;
+}
+
+/**
+ * Exchange the psy bands of the channel after a channel pair with the ones
+ * it had before its analysis in the current pass.
+ */
+static void swap_next_bands(AACEncContext *s, AACEncElement *el)
+{
+    FFPsyBand *bands = s->psy.ch[el->start_ch + 2].psy_bands;
+    int i;
+
+    for (i = 0; i < PSY_MAX_BANDS; i++)
+        FFSWAP(FFPsyBand, bands[i], el->next_bands[i]);
+}
+
+/**
+ * Search the quantizers and the temporal noise shaping of one channel
+ * element, after its psychoacoustic analysis.
+ * jobnr counts from the element given by *arg.
+ */
+static int search_element(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    AACEncContext *s = avctx->priv_data;
+    AACEncContext *t = s->thread[threadnr];
+    const int i = jobnr + *(const int *)arg;
+    AACEncElement *el = &s->elements[i];
+    const FFPsyWindowInfo *wi = s->windows + el->start_ch;
+    ChannelElement *cpe = &s->cpe[i];
+    SingleChannelElement *sce;
+    const int start_ch = el->start_ch;
+    const int tag   = s->chan_map[i + 1];
+    const int chans = tag == TYPE_CPE ? 2 : 1;
+    int ch, w;
+
+    el->tns_mode        = 0;
+    t->lambda           = s->lambda;
+    t->psy.bitres.alloc = el->psy_alloc;
+    t->psy.bitres.bits  = s->last_frame_pb_count / s->channels;
+    t->cur_type         = tag;
+
+    /* The coders do not touch scoefs for silent channels, the later stages
+     * then read what the previous element left. abs_pow34 never stores a
+     * negative value, so this tells whether the search has set them. */
+    t->scoefs[0] = -1.0f;
+    for (ch = 0; ch < chans; ch++) {
+        t->cur_channel = start_ch + ch;
+        if (s->options.pns && s->coder->mark_pns)
+            s->coder->mark_pns(t, avctx, &cpe->ch[ch]);
+        s->coder->search_for_quantizers(avctx, t, &cpe->ch[ch], t->lambda);
+    }
+    el->has_scoefs = t->scoefs[0] >= 0.0f;
+    if (el->has_scoefs)
+        memcpy(el->scoefs, t->scoefs, sizeof(el->scoefs));
+
+    if (chans > 1
+        && wi[0].window_type[0] == wi[1].window_type[0]
+        && wi[0].window_shape   == wi[1].window_shape) {
+
+        cpe->common_window = 1;
+        for (w = 0; w < wi[0].num_windows; w++) {
+            if (wi[0].grouping[w] != wi[1].grouping[w]) {
+                cpe->common_window = 0;
+                break;
+            }
+        }
+    }
+    for (ch = 0; ch < chans; ch++) { /* TNS */
+        sce = &cpe->ch[ch];
+        t->cur_channel = start_ch + ch;
+        if (s->options.tns && s->coder->search_for_tns)
+            s->coder->search_for_tns(t, sce);
+        if (s->options.tns && s->coder->apply_tns_filt)
+            s->coder->apply_tns_filt(t, sce);
+        if (sce->tns.present)
+            el->tns_mode = 1;
+    }
+    el->psy_cutoff = t->psy.cutoff;
+
+    return 0;
+}
+
 static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                             const AVFrame *frame, int *got_packet_ptr)
 {
     AACEncContext *s = avctx->priv_data;
-    float **samples = s->planar_samples, *samples2, *la, *overlap;
     ChannelElement *cpe;
     SingleChannelElement *sce;
-    IndividualChannelStream *ics;
     int i, its, ch, w, chans, tag, start_ch, ret, frame_bits;
     int target_bits, rate_bits, too_many_bits, too_few_bits;
     int ms_mode = 0, is_mode = 0, tns_mode = 0, pred_mode = 0;
     int chan_el_counter[4];
-    FFPsyWindowInfo windows[AAC_MAX_CHANNELS];
+    int job_ret[16], first_job = 0;
 
     /* add current frame to queue */
     if (frame) {
@@ -583,123 +769,31 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
     if (!avctx->frame_number)
         return 0;
 
-    start_ch = 0;
-    for (i = 0; i < s->chan_map[0]; i++) {
-        FFPsyWindowInfo* wi = windows + start_ch;
-        tag      = s->chan_map[i+1];
-        chans    = tag == TYPE_CPE ? 2 : 1;
-        cpe      = &s->cpe[i];
-        for (ch = 0; ch < chans; ch++) {
-            int k;
-            float clip_avoidance_factor;
-            sce = &cpe->ch[ch];
-            ics = &sce->ics;
-            s->cur_channel = start_ch + ch;
-            overlap  = &samples[s->cur_channel][0];
-            samples2 = overlap + 1024;
-            la       = samples2 + (448+64);
-            if (!frame)
-                la = NULL;
-            if (tag == TYPE_LFE) {
-                wi[ch].window_type[0] = wi[ch].window_type[1] = ONLY_LONG_SEQUENCE;
-                wi[ch].window_shape   = 0;
-                wi[ch].num_windows    = 1;
-                wi[ch].grouping[0]    = 1;
-                wi[ch].clipping[0]    = 0;
-
-                /* Only the lowest 12 coefficients are used in a LFE channel.
-                 * The expression below results in only the bottom 8 coefficients
-                 * being used for 11.025kHz to 16kHz sample rates.
-                 */
-                ics->num_swb = s->samplerate_index >= 8 ? 1 : 3;
-            } else {
-                wi[ch] = s->psy.model->window(&s->psy, samples2, la, s->cur_channel,
-                                              ics->window_sequence[0]);
-            }
-            ics->window_sequence[1] = ics->window_sequence[0];
-            ics->window_sequence[0] = wi[ch].window_type[0];
-            ics->use_kb_window[1]   = ics->use_kb_window[0];
-            ics->use_kb_window[0]   = wi[ch].window_shape;
-            ics->num_windows        = wi[ch].num_windows;
-            ics->swb_sizes          = s->psy.bands    [ics->num_windows == 8];
-            ics->num_swb            = tag == TYPE_LFE ? ics->num_swb : s->psy.num_bands[ics->num_windows == 8];
-            ics->max_sfb            = FFMIN(ics->max_sfb, ics->num_swb);
-            ics->swb_offset         = wi[ch].window_type[0] == EIGHT_SHORT_SEQUENCE ?
-                                        ff_swb_offset_128 [s->samplerate_index]:
-                                        ff_swb_offset_1024[s->samplerate_index];
-            ics->tns_max_bands      = wi[ch].window_type[0] == EIGHT_SHORT_SEQUENCE ?
-                                        ff_tns_max_bands_128 [s->samplerate_index]:
-                                        ff_tns_max_bands_1024[s->samplerate_index];
-
-            for (w = 0; w < ics->num_windows; w++)
-                ics->group_len[w] = wi[ch].grouping[w];
-
-            /* Calculate input sample maximums and evaluate clipping risk */
-            clip_avoidance_factor = 0.0f;
-            for (w = 0; w < ics->num_windows; w++) {
-                const float *wbuf = overlap + w * 128;
-                const int wlen = 2048 / ics->num_windows;
-                float max = 0;
-                int j;
-                /* mdct input is 2 * output */
-                for (j = 0; j < wlen; j++)
-                    max = FFMAX(max, fabsf(wbuf[j]));
-                wi[ch].clipping[w] = max;
-            }
-            for (w = 0; w < ics->num_windows; w++) {
-                if (wi[ch].clipping[w] > CLIP_AVOIDANCE_FACTOR) {
-                    ics->window_clipping[w] = 1;
-                    clip_avoidance_factor = FFMAX(clip_avoidance_factor, wi[ch].clipping[w]);
-                } else {
-                    ics->window_clipping[w] = 0;
-                }
-            }
-            if (clip_avoidance_factor > CLIP_AVOIDANCE_FACTOR) {
-                ics->clip_avoidance_factor = CLIP_AVOIDANCE_FACTOR / clip_avoidance_factor;
-            } else {
-                ics->clip_avoidance_factor = 1.0f;
-            }
-
-            apply_window_and_mdct(s, sce, overlap);
-
-            if (s->options.ltp && s->coder->update_ltp) {
-                s->coder->update_ltp(s, sce);
-                apply_window[sce->ics.window_sequence[0]](s->fdsp, sce, &sce->ltp_state[0]);
-                s->mdct1024.mdct_calc(&s->mdct1024, sce->lcoeffs, sce->ret_buf);
-            }
+    avctx->execute2(avctx, transform_element, (void *)frame, job_ret, s->chan_map[0]);
+    for (i = 0; i < s->chan_map[0]; i++)
+        if (job_ret[i] < 0)
+            return job_ret[i];
 
-            for (k = 0; k < 1024; k++) {
-                if (!(fabs(cpe->ch[ch].coeffs[k]) < 1E16)) { // Ensure headroom for energy calculation
-                    av_log(avctx, AV_LOG_ERROR, "Input contains (near) NaN/+-Inf\n");
-                    return AVERROR(EINVAL);
-                }
-            }
-            avoid_clipping(s, sce);
-        }
-        start_ch += chans;
-    }
     if ((ret = ff_alloc_packet(avctx, avpkt, 8192 * s->channels)) < 0)
         return ret;
     frame_bits = its = 0;
     do {
-        init_put_bits(&s->pb, avpkt->data, avpkt->size);
-
-        if ((avctx->frame_number & 0xFF)==1 && !(avctx->flags & AV_CODEC_FLAG_BITEXACT))
-            put_bitstream_info(s, LIBAVCODEC_IDENT);
-        start_ch = 0;
+        /* The psychoacoustic model carries state from one channel element
+         * to the next, so the analysis runs serially before the searches.
+         * It also uses the cutoff left by the coder. That only depends on
+         * the options and lambda, so it is the same for all elements of the
+         * pass and the first element is searched on its own to get it. */
         target_bits = 0;
-        memset(chan_el_counter, 0, sizeof(chan_el_counter));
         for (i = 0; i < s->chan_map[0]; i++) {
-            FFPsyWindowInfo* wi = windows + start_ch;
+            FFPsyWindowInfo* wi = s->windows + s->elements[i].start_ch;
             const float *coeffs[2];
+            start_ch = s->elements[i].start_ch;
             tag      = s->chan_map[i+1];
             chans    = tag == TYPE_CPE ? 2 : 1;
             cpe      = &s->cpe[i];
             cpe->common_window = 0;
             memset(cpe->is_mask, 0, sizeof(cpe->is_mask));
             memset(cpe->ms_mask, 0, sizeof(cpe->ms_mask));
-            put_bits(&s->pb, 3, tag);
-            put_bits(&s->pb, 4, chan_el_counter[tag]++);
             for (ch = 0; ch < chans; ch++) {
                 sce = &cpe->ch[ch];
                 coeffs[ch] = sce->coeffs;
@@ -712,6 +806,11 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                     if (sce->band_type[w] > RESERVED_BT)
                         sce->band_type[w] = 0;
             }
+            /* The common prediction check of a channel pair also reads the
+             * bands of the channel after the pair, from before its analysis. */
+            if (i && s->options.pred && s->chan_map[i] == TYPE_CPE)
+                memcpy(s->elements[i - 1].next_bands, s->psy.ch[start_ch].psy_bands,
+                       sizeof(s->elements[i - 1].next_bands));
             s->psy.bitres.alloc = -1;
             s->psy.bitres.bits = s->last_frame_pb_count / s->channels;
             s->psy.model->analyze(&s->psy, start_ch, coeffs, wi);
@@ -721,36 +820,42 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                     * (s->lambda / (avctx->global_quality ? avctx->global_quality : 120));
                 s->psy.bitres.alloc /= chans;
             }
-            s->cur_type = tag;
-            for (ch = 0; ch < chans; ch++) {
-                s->cur_channel = start_ch + ch;
-                if (s->options.pns && s->coder->mark_pns)
-                    s->coder->mark_pns(s, avctx, &cpe->ch[ch]);
-                s->coder->search_for_quantizers(avctx, s, &cpe->ch[ch], s->lambda);
+            s->elements[i].psy_alloc = s->psy.bitres.alloc;
+            if (!i) {
+                search_element(avctx, &first_job, 0, 0);
+                s->psy.cutoff = s->elements[0].psy_cutoff;
             }
-            if (chans > 1
-                && wi[0].window_type[0] == wi[1].window_type[0]
-                && wi[0].window_shape   == wi[1].window_shape) {
-
-                cpe->common_window = 1;
-                for (w = 0; w < wi[0].num_windows; w++) {
-                    if (wi[0].grouping[w] != wi[1].grouping[w]) {
-                        cpe->common_window = 0;
-                        break;
-                    }
-                }
-            }
-            for (ch = 0; ch < chans; ch++) { /* TNS and PNS */
-                sce = &cpe->ch[ch];
+        }
+        if (s->chan_map[0] > 1) {
+            first_job = 1;
+            avctx->execute2(avctx, search_element, &first_job, NULL, s->chan_map[0] - 1);
+            first_job = 0;
+            s->psy.cutoff = s->elements[s->chan_map[0] - 1].psy_cutoff;
+        }
+
+        init_put_bits(&s->pb, avpkt->data, avpkt->size);
+
+        if ((avctx->frame_number & 0xFF)==1 && !(avctx->flags & AV_CODEC_FLAG_BITEXACT))
+            put_bitstream_info(s, LIBAVCODEC_IDENT);
+        memset(chan_el_counter, 0, sizeof(chan_el_counter));
+        /* The remaining stages share the PNS noise generator and the coder
+         * scratch buffers from one element to the next, so they stay serial. */
+        for (i = 0; i < s->chan_map[0]; i++) {
+            AACEncElement *el = &s->elements[i];
+            start_ch = el->start_ch;
+            tag      = s->chan_map[i+1];
+            chans    = tag == TYPE_CPE ? 2 : 1;
+            cpe      = &s->cpe[i];
+            put_bits(&s->pb, 3, tag);
+            put_bits(&s->pb, 4, chan_el_counter[tag]++);
+            s->cur_type = tag;
+            if (el->has_scoefs)
+                memcpy(s->scoefs, el->scoefs, sizeof(s->scoefs));
+            tns_mode |= el->tns_mode;
+            for (ch = 0; ch < chans; ch++) { /* PNS */
                 s->cur_channel = start_ch + ch;
-                if (s->options.tns && s->coder->search_for_tns)
-                    s->coder->search_for_tns(s, sce);
-                if (s->options.tns && s->coder->apply_tns_filt)
-                    s->coder->apply_tns_filt(s, sce);
-                if (sce->tns.present)
-                    tns_mode = 1;
                 if (s->options.pns && s->coder->search_for_pns)
-                    s->coder->search_for_pns(s, avctx, sce);
+                    s->coder->search_for_pns(s, avctx, &cpe->ch[ch]);
             }
             s->cur_channel = start_ch;
             if (s->options.intensity_stereo) { /* Intensity Stereo */
@@ -767,8 +872,14 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                         s->coder->search_for_pred(s, sce);
                     if (cpe->ch[ch].ics.predictor_present) pred_mode = 1;
                 }
-                if (s->coder->adjust_common_pred)
+                if (s->coder->adjust_common_pred) {
+                    const int next = chans == 2 && i + 1 < s->chan_map[0];
+                    if (next)
+                        swap_next_bands(s, el);
                     s->coder->adjust_common_pred(s, cpe);
+                    if (next)
+                        swap_next_bands(s, el);
+                }
                 for (ch = 0; ch < chans; ch++) {
                     sce = &cpe->ch[ch];
                     s->cur_channel = start_ch + ch;
@@ -813,7 +924,6 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                 s->cur_channel = start_ch + ch;
                 encode_individual_channel(avctx, s, &cpe->ch[ch], cpe->common_window);
             }
-            start_ch += chans;
         }
 
         if (avctx->flags & AV_CODEC_FLAG_QSCALE) {
@@ -899,6 +1009,7 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
 static av_cold int aac_encode_end(AVCodecContext *avctx)
 {
     AACEncContext *s = avctx->priv_data;
+    int i;
 
     av_log(avctx, AV_LOG_INFO, "Qavg: %.3f\n", s->lambda_count ? s->lambda_sum / s->lambda_count : NAN);
 
@@ -906,10 +1017,16 @@ static av_cold int aac_encode_end(AVCodecContext *avctx)
     ff_mdct_end(&s->mdct128);
     ff_psy_end(&s->psy);
     ff_lpc_end(&s->lpc);
+    for (i = 0; i < s->nb_threads; i++) {
+        if (s->thread[i])
+            ff_lpc_end(&s->thread[i]->lpc);
+        av_freep(&s->thread[i]);
+    }
     if (s->psypp)
         ff_psy_preprocess_end(s->psypp);
     av_freep(&s->buffer.samples);
     av_freep(&s->cpe);
+    av_freep(&s->elements);
     av_freep(&s->fdsp);
     ff_af_queue_close(&s->afq);
     return 0;
@@ -936,21 +1053,27 @@ static av_cold int dsp_init(AVCodecContext *avctx, AACEncContext *s)
 
 static av_cold int alloc_buffers(AVCodecContext *avctx, AACEncContext *s)
 {
-    int ch;
-    if (!FF_ALLOCZ_TYPED_ARRAY(s->buffer.samples, s->channels * 3 * 1024) ||
-        !FF_ALLOCZ_TYPED_ARRAY(s->cpe,            s->chan_map[0]))
+    int ch, i;
+    if (!FF_ALLOCZ_TYPED_ARRAY(s->buffer.samples,  s->channels * 3 * 1024) ||
+        !FF_ALLOCZ_TYPED_ARRAY(s->cpe,             s->chan_map[0])         ||
+        !FF_ALLOCZ_TYPED_ARRAY(s->elements,        s->chan_map[0]))
         return AVERROR(ENOMEM);
 
     for(ch = 0; ch < s->channels; ch++)
         s->planar_samples[ch] = s->buffer.samples + 3 * 1024 * ch;
 
+    for (i = 0, ch = 0; i < s->chan_map[0]; i++) {
+        s->elements[i].start_ch = ch;
+        ch += s->chan_map[i + 1] == TYPE_CPE ? 2 : 1;
+    }
+
     return 0;
 }
 
 static av_cold int aac_encode_init(AVCodecContext *avctx)
 {
     AACEncContext *s = avctx->priv_data;
-    int i, ret = 0;
+    int i, ret = 0, nb_threads = 1;
     const uint8_t *sizes[2];
     uint8_t grouping[AAC_MAX_CHANNELS];
     int lengths[2];
@@ -1101,6 +1224,21 @@ static av_cold int aac_encode_init(AVCodecContext *avctx)
     ff_af_queue_init(avctx, &s->afq);
     ff_aac_tableinit();
 
+    /* The channel elements are searched in parallel with one context per
+     * thread. The main context is not one of them as it keeps the scratch
+     * buffers of the serial stages. */
+    if (avctx->active_thread_type & FF_THREAD_SLICE)
+        nb_threads = av_clip(avctx->thread_count, 1, s->chan_map[0]);
+    for (i = 0; i < nb_threads; i++) {
+        s->thread[i] = av_memdup(s, sizeof(*s));
+        if (!s->thread[i])
+            return AVERROR(ENOMEM);
+        s->nb_threads++;
+        if ((ret = ff_lpc_init(&s->thread[i]->lpc, 2*avctx->frame_size,
+                               TNS_MAX_ORDER, FF_LPC_TYPE_LEVINSON)) < 0)
+            return ret;
+    }
+
     return 0;
 }
 
@@ -1145,7 +1283,8 @@ const AVCodec ff_aac_encoder = {
     .defaults       = aac_encode_defaults,
     .supported_samplerates = ff_mpeg4audio_sample_rates,
     .caps_internal  = FF_CODEC_CAP_INIT_THREADSAFE | FF_CODEC_CAP_INIT_CLEANUP,
-    .capabilities   = AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_DELAY,
+    .capabilities   = AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_DELAY |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .sample_fmts    = (const enum AVSampleFormat[]){ AV_SAMPLE_FMT_FLTP,
                                                      AV_SAMPLE_FMT_NONE },
     .priv_class     = &aacenc_class,
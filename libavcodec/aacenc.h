@@ -373,6 +373,20 @@ static const AACPCEInfo aac_pce_configs[] = {
     },
 };
 
+/**
+ * Per channel element state of the quantizer search, which runs as a
+ * separate job for every channel element.
+ */
+typedef struct AACEncElement {
+    int start_ch;                                ///< first channel of the element
+    int psy_alloc;                               ///< bits per channel allocated by psy, or -1
+    int psy_cutoff;                              ///< psy cutoff left by the coder
+    int tns_mode;                                ///< TNS used in the current pass
+    int has_scoefs;                              ///< whether the search left scoefs
+    float scoefs[1024];                          ///< scaled coefficients left by the search
+    FFPsyBand next_bands[PSY_MAX_BANDS];         ///< bands of the channel after a pair, before its analysis
+} AACEncElement;
+
 /**
  * AAC encoder context
  */
@@ -395,6 +409,10 @@ typedef struct AACEncContext {
     const uint8_t *chan_map;                     ///< channel configuration map
 
     ChannelElement *cpe;                         ///< channel elements
+    AACEncElement *elements;                     ///< channel element coding state
+    FFPsyWindowInfo windows[16];                 ///< window decisions for the current frame
+    struct AACEncContext *thread[16];            ///< per-thread contexts for the search jobs
+    int nb_threads;                              ///< number of per-thread contexts
     FFPsyContext psy;
     struct FFPsyPreprocessContext* psypp;
     const AACCoefficientsEncoder *coder;
@@ -365,6 +365,50 @@ typedef struct RcOverride{
  */
 #define AV_GET_ENCODE_BUFFER_FLAG_REF (1 << 0)
 
+/**
+ * Requirements of a video decoder on the buffers of the frames it decodes
+ * into, for one pixel format and set of dimensions.
+ *
+ * Buffers provided by AVCodecContext.get_buffer2() which satisfy them can
+ * be used without any other padding or alignment.
+ *
+ * sizeof(AVCodecBufferRequirements) is not a part of the public ABI, new
+ * fields may be added to the end with minor version bumps.
+ *
+ * @see AVCodecContext.buffer_requirements, avcodec_get_buffer_requirements()
+ */
+typedef struct AVCodecBufferRequirements {
+    /**
+     * Pixel format of the frames.
+     */
+    enum AVPixelFormat format;
+
+    /**
+     * Dimensions the planes must be allocated for. They may be larger than
+     * the frame dimensions, the decoder may then write to the area past the
+     * visible picture.
+     */
+    int width;
+    int height;
+
+    /**
+     * The linesize of each plane must be a multiple of the corresponding
+     * value.
+     */
+    int linesize_align[AV_NUM_DATA_POINTERS];
+
+    /**
+     * Minimum alignment of the plane data pointers in bytes.
+     */
+    int data_align;
+
+    /**
+     * Number of bytes after the last line of each plane, as given by width
+     * and height, which the decoder may read.
+     */
+    int padding;
+} AVCodecBufferRequirements;
+
 struct AVCodecInternal;
 
 /**
@@ -1124,7 +1168,7 @@ typedef struct AVCodecContext {
      * different thread, but not from more than one at once. Does not need to be
      * reentrant.
      *
-     * @see avcodec_align_dimensions2()
+     * @see avcodec_align_dimensions2(), buffer_requirements
      *
      * Audio:
      *
@@ -2027,6 +2071,55 @@ typedef struct AVCodecContext {
      * - decoding: unused
      */
     int (*get_encode_buffer)(struct AVCodecContext *s, AVPacket *pkt, int flags);
+
+    /**
+     * Maximum number of frames decoded at once when frame and slice
+     * threading are combined.
+     *
+     * If positive and both FF_THREAD_FRAME and FF_THREAD_SLICE are set in
+     * thread_type, decoders supporting it split thread_count between at most
+     * frame_threads frame threads, each of which uses the remaining threads
+     * for slice threading within its frame. The delay added by frame
+     * threading is then limited to frame_threads - 1 frames. After
+     * avcodec_open2() thread_count is the number of frame threads and
+     * active_thread_type has both flags set if the combination is in use.
+     * With a value of 1, slice threading is used alone if possible.
+     *
+     * 0 (the default) uses only one threading method, as before.
+     * Combining both methods is experimental.
+     *
+     * - encoding: unused
+     * - decoding: Set by user.
+     */
+    int frame_threads;
+
+    /**
+     * Called by video decoders before the first call to get_buffer2() and
+     * whenever the requirements on the frame buffers change afterwards,
+     * e.g. on a change of pixel format or dimensions. The requirements
+     * apply to all following get_buffer2() calls until the next call of
+     * this callback.
+     *
+     * This lets the caller set up its own frame storage, e.g. a ring of
+     * shared memory buffers, before providing frames from it with
+     * get_buffer2(). When this callback is set, libavcodec checks the
+     * linesizes and data pointer alignment of the frames returned by
+     * get_buffer2() against the requirements and fails the allocation if
+     * they are not met.
+     *
+     * It is not called for hardware frames. With frame threading it may be
+     * called once per thread for the same requirements, under the same
+     * conditions as get_buffer2().
+     *
+     * @param req the requirements, only valid during the call
+     * @return 0 on success, a negative AVERROR code to abort decoding of the
+     *         current frame
+     *
+     * - encoding: unused
+     * - decoding: Set by user.
+     */
+    int (*buffer_requirements)(struct AVCodecContext *s,
+                               const AVCodecBufferRequirements *req);
 } AVCodecContext;
 
 /**
@@ -2466,6 +2559,18 @@ void avcodec_align_dimensions(AVCodecContext *s, int *width, int *height);
 void avcodec_align_dimensions2(AVCodecContext *s, int *width, int *height,
                                int linesize_align[AV_NUM_DATA_POINTERS]);
 
+/**
+ * Get the requirements of an opened video decoder on the buffers of the
+ * frames it decodes, for its current pixel format and dimensions.
+ *
+ * @return the requirements, to be freed with av_free(), or NULL if the
+ *         decoder is not a video decoder, its pixel format or dimensions
+ *         are not known yet, or on allocation failure
+ *
+ * @see AVCodecContext.buffer_requirements
+ */
+AVCodecBufferRequirements *avcodec_get_buffer_requirements(AVCodecContext *avctx);
+
 /**
  * Converts AVChromaLocation to swscale x/y chroma position.
  *
@@ -1245,6 +1245,11 @@ static AVBufferRef *frame_pool_alloc(void)
     return buf;
 }
 
+static AVBufferRef *pool_alloc_zeroed(void *opaque, size_t size)
+{
+    return av_buffer_allocz(size);
+}
+
 static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
 {
     FramePool *pool = avctx->internal->pool ?
@@ -1310,10 +1315,13 @@ static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
                     ret = AVERROR(EINVAL);
                     goto fail;
                 }
-                pool->pools[i] = av_buffer_pool_init(size[i] + 16 + STRIDE_ALIGN - 1,
-                                                     CONFIG_MEMORY_POISONING ?
-                                                        NULL :
-                                                        av_buffer_allocz);
+                pool->pools[i] = av_buffer_pool_init3(size[i] + 16 + STRIDE_ALIGN - 1,
+                                                      NULL,
+                                                      CONFIG_MEMORY_POISONING ?
+                                                         NULL :
+                                                         pool_alloc_zeroed,
+                                                      NULL,
+                                                      AV_BUFFER_POOL_FLAG_LOCKLESS);
                 if (!pool->pools[i]) {
                     ret = AVERROR(ENOMEM);
                     goto fail;
@@ -1332,7 +1340,8 @@ static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
         if (ret < 0)
             goto fail;
 
-        pool->pools[0] = av_buffer_pool_init(pool->linesize[0], NULL);
+        pool->pools[0] = av_buffer_pool_init3(pool->linesize[0], NULL, NULL, NULL,
+                                              AV_BUFFER_POOL_FLAG_LOCKLESS);
         if (!pool->pools[0]) {
             ret = AVERROR(ENOMEM);
             goto fail;
@@ -1607,6 +1616,82 @@ static void validate_avframe_allocation(AVCodecContext *avctx, AVFrame *frame)
     }
 }
 
+static void fill_buffer_requirements(AVCodecContext *avctx, int width, int height,
+                                     AVCodecBufferRequirements *req)
+{
+    int linesize_align[AV_NUM_DATA_POINTERS];
+
+    avcodec_align_dimensions2(avctx, &width, &height, linesize_align);
+
+    memset(req, 0, sizeof(*req));
+    req->format = avctx->pix_fmt;
+    req->width  = width;
+    req->height = height;
+    for (int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+        req->linesize_align[i] = i < 4 ? linesize_align[i] : 1;
+    req->data_align = STRIDE_ALIGN;
+    /* matches the padding of the buffers allocated by update_frame_pool() */
+    req->padding    = 16;
+}
+
+static int update_buffer_requirements(AVCodecContext *avctx, const AVFrame *frame)
+{
+    AVCodecBufferRequirements req;
+    int ret;
+
+    fill_buffer_requirements(avctx, frame->width, frame->height, &req);
+    if (!memcmp(&req, &avctx->internal->buffer_req, sizeof(req)))
+        return 0;
+
+    ret = avctx->buffer_requirements(avctx, &req);
+    if (ret < 0)
+        return ret;
+    avctx->internal->buffer_req = req;
+
+    return 0;
+}
+
+static int check_buffer_requirements(AVCodecContext *avctx, const AVFrame *frame)
+{
+    const AVCodecBufferRequirements *req = &avctx->internal->buffer_req;
+    int num_planes = av_pix_fmt_count_planes(frame->format);
+
+    for (int i = 0; i < num_planes; i++) {
+        if (frame->linesize[i] % req->linesize_align[i] ||
+            (uintptr_t)frame->data[i] % req->data_align) {
+            av_log(avctx, AV_LOG_ERROR, "Buffer returned by get_buffer2() does "
+                   "not meet the buffer requirements: plane %d, linesize %d, "
+                   "data %p\n", i, frame->linesize[i], frame->data[i]);
+            return AVERROR(EINVAL);
+        }
+    }
+    return 0;
+}
+
+AVCodecBufferRequirements *avcodec_get_buffer_requirements(AVCodecContext *avctx)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(avctx->pix_fmt);
+    AVCodecBufferRequirements *req;
+    int width, height;
+
+    if (!avcodec_is_open(avctx) || !av_codec_is_decoder(avctx->codec) ||
+        avctx->codec_type != AVMEDIA_TYPE_VIDEO ||
+        !desc || (desc->flags & AV_PIX_FMT_FLAG_HWACCEL))
+        return NULL;
+
+    width  = FFMAX(avctx->width,  AV_CEIL_RSHIFT(avctx->coded_width,  avctx->lowres));
+    height = FFMAX(avctx->height, AV_CEIL_RSHIFT(avctx->coded_height, avctx->lowres));
+    if (width <= 0 || height <= 0)
+        return NULL;
+
+    req = av_malloc(sizeof(*req));
+    if (!req)
+        return NULL;
+    fill_buffer_requirements(avctx, width, height, req);
+
+    return req;
+}
+
 static void decode_data_free(void *opaque, uint8_t *data)
 {
     FrameDecodeData *fdd = (FrameDecodeData*)data;
@@ -1648,6 +1733,7 @@ int ff_get_buffer(AVCodecContext *avctx, AVFrame *frame, int flags)
 {
     const AVHWAccel *hwaccel = avctx->hwaccel;
     int override_dimensions = 1;
+    int check_requirements;
     int ret;
 
     if (avctx->codec_type == AVMEDIA_TYPE_VIDEO) {
@@ -1688,12 +1774,26 @@ int ff_get_buffer(AVCodecContext *avctx, AVFrame *frame, int flags)
     } else
         avctx->sw_pix_fmt = avctx->pix_fmt;
 
+    check_requirements = avctx->codec_type == AVMEDIA_TYPE_VIDEO && !hwaccel &&
+                         avctx->buffer_requirements;
+    if (check_requirements) {
+        ret = update_buffer_requirements(avctx, frame);
+        if (ret < 0)
+            goto fail;
+    }
+
     ret = avctx->get_buffer2(avctx, frame, flags);
     if (ret < 0)
         goto fail;
 
     validate_avframe_allocation(avctx, frame);
 
+    if (check_requirements) {
+        ret = check_buffer_requirements(avctx, frame);
+        if (ret < 0)
+            goto fail;
+    }
+
     ret = ff_attach_decode_data(frame);
     if (ret < 0)
         goto fail;
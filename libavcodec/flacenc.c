@@ -48,6 +48,7 @@
 #define MAX_LPC_PRECISION  15
 #define MIN_LPC_SHIFT       0
 #define MAX_LPC_SHIFT      15
+#define MAX_THREADS        16
 
 enum CodingMode {
     CODING_MODE_RICE  = 4,
@@ -90,7 +91,7 @@ typedef struct FlacSubframe {
     uint64_t rc_sums[32][MAX_PARTITIONS];
 
     int32_t samples[FLAC_MAX_BLOCKSIZE];
-    int32_t residual[FLAC_MAX_BLOCKSIZE+11];
+    int32_t residual[FLAC_MAX_BLOCKSIZE+23];
 } FlacSubframe;
 
 typedef struct FlacFrame {
@@ -128,6 +129,17 @@ typedef struct FlacEncodeContext {
 
     int flushed;
     int64_t next_pts;
+
+    /* Frames are independent, so with threading enabled up to one frame
+     * per thread is queued in a context of its own and the queued frames
+     * are encoded together. */
+    struct FlacEncodeContext *thread[MAX_THREADS];
+    int nb_threads;                 ///< number of frame contexts, 0 without threading
+    int nb_queued;                  ///< number of frames queued for encoding
+    int nb_coded;                   ///< number of packets in the frame contexts
+    int nb_output;                  ///< number of these packets already returned
+    AVPacket *pkt;                  ///< packet of a frame context
+    int64_t pts, duration;          ///< timing of the frame in a frame context
 } FlacEncodeContext;
 
 
@@ -422,14 +434,37 @@ static av_cold int flac_encode_init(AVCodecContext *avctx)
 
     ret = ff_lpc_init(&s->lpc_ctx, avctx->frame_size,
                       s->options.max_prediction_order, FF_LPC_TYPE_LEVINSON);
+    if (ret < 0)
+        return ret;
 
     ff_bswapdsp_init(&s->bdsp);
     ff_flacdsp_init(&s->flac_dsp, avctx->sample_fmt, channels,
                     avctx->bits_per_raw_sample);
 
+    if (avctx->active_thread_type & FF_THREAD_SLICE && avctx->thread_count > 1) {
+        int nb_threads = FFMIN(avctx->thread_count, MAX_THREADS);
+
+        for (i = 0; i < nb_threads; i++) {
+            FlacEncodeContext *t = av_memdup(s, sizeof(*s));
+            if (!t)
+                return AVERROR(ENOMEM);
+            s->thread[s->nb_threads++] = t;
+            ret = ff_lpc_init(&t->lpc_ctx, avctx->frame_size,
+                              s->options.max_prediction_order, FF_LPC_TYPE_LEVINSON);
+            t->md5ctx          = NULL;
+            t->md5_buffer      = NULL;
+            t->md5_buffer_size = 0;
+            t->pkt             = av_packet_alloc();
+            if (ret < 0)
+                return ret;
+            if (!t->pkt)
+                return AVERROR(ENOMEM);
+        }
+    }
+
     dprint_compression_options(s);
 
-    return ret;
+    return 0;
 }
 
 
@@ -1286,10 +1321,11 @@ static int write_frame(FlacEncodeContext *s, AVPacket *avpkt)
 }
 
 
-static int update_md5_sum(FlacEncodeContext *s, const void *samples)
+static int update_md5_sum(FlacEncodeContext *s, const void *samples,
+                          int nb_samples)
 {
     const uint8_t *buf;
-    int buf_size = s->frame.blocksize * s->channels *
+    int buf_size = nb_samples * s->channels *
                    ((s->avctx->bits_per_raw_sample + 7) / 8);
 
     if (s->avctx->bits_per_raw_sample > 16 || HAVE_BIGENDIAN) {
@@ -1310,7 +1346,7 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
         const int32_t *samples0 = samples;
         uint8_t *tmp            = s->md5_buffer;
 
-        for (i = 0; i < s->frame.blocksize * s->channels; i++) {
+        for (i = 0; i < nb_samples * s->channels; i++) {
             int32_t v = samples0[i] >> 8;
             AV_WL24(tmp + 3*i, v);
         }
@@ -1322,6 +1358,133 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
 }
 
 
+/**
+ * Encode the frame loaded in the context.
+ *
+ * @return the size of the coded frame in bytes or a negative error code
+ */
+static int encode_block(FlacEncodeContext *s)
+{
+    int frame_bytes;
+
+    channel_decorrelation(s);
+
+    remove_wasted_bits(s);
+
+    frame_bytes = encode_frame(s);
+
+    /* Fall back on verbatim mode if the compressed frame is larger than it
+       would be if encoded uncompressed. */
+    if (frame_bytes < 0 || frame_bytes > s->max_framesize) {
+        s->frame.verbatim_only = 1;
+        frame_bytes = encode_frame(s);
+        if (frame_bytes < 0) {
+            av_log(s->avctx, AV_LOG_ERROR, "Bad frame count\n");
+            return frame_bytes;
+        }
+    }
+
+    return frame_bytes;
+}
+
+
+static int encode_thread(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    FlacEncodeContext *t = s->thread[jobnr];
+    int frame_bytes, ret;
+
+    frame_bytes = encode_block(t);
+    if (frame_bytes < 0)
+        return frame_bytes;
+
+    if ((ret = av_new_packet(t->pkt, frame_bytes)) < 0)
+        return ret;
+    av_shrink_packet(t->pkt, write_frame(t, t->pkt));
+
+    return 0;
+}
+
+
+static void update_frame_stats(FlacEncodeContext *s, AVPacket *avpkt)
+{
+    if (avpkt->size > s->max_encoded_framesize)
+        s->max_encoded_framesize = avpkt->size;
+    if (avpkt->size < s->min_framesize)
+        s->min_framesize = avpkt->size;
+
+    s->next_pts = avpkt->pts + avpkt->duration;
+}
+
+
+static int flac_encode_frame_threaded(AVCodecContext *avctx, AVPacket *avpkt,
+                                      const AVFrame *frame, int *got_packet_ptr)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    int ret;
+
+    if (frame) {
+        FlacEncodeContext *t = s->thread[s->nb_queued++];
+
+        /* change max_framesize for small final frame */
+        if (frame->nb_samples < avctx->frame_size) {
+            t->max_framesize = ff_flac_get_max_frame_size(frame->nb_samples,
+                                                          s->channels,
+                                                          avctx->bits_per_raw_sample);
+        }
+
+        init_frame(t, frame->nb_samples);
+        copy_samples(t, frame->data[0]);
+        t->frame_count = s->frame_count++;
+        t->pts         = frame->pts;
+        t->duration    = ff_samples_to_time_base(avctx, frame->nb_samples);
+
+        s->sample_count += frame->nb_samples;
+        if ((ret = update_md5_sum(s, frame->data[0], frame->nb_samples)) < 0) {
+            av_log(avctx, AV_LOG_ERROR, "Error updating MD5 checksum\n");
+            return ret;
+        }
+    }
+
+    /* One packet is returned per queued frame, so the packets of the
+     * previous batch have all been returned by the time the next one is
+     * full. When flushing, they are returned before the last batch is
+     * encoded. */
+    if (s->nb_output == s->nb_coded &&
+        (s->nb_queued == s->nb_threads || (!frame && s->nb_queued))) {
+        int job_ret[MAX_THREADS];
+
+        avctx->execute2(avctx, encode_thread, NULL, job_ret, s->nb_queued);
+        s->nb_coded  = s->nb_queued;
+        s->nb_output = 0;
+        s->nb_queued = 0;
+        for (int i = 0; i < s->nb_coded; i++)
+            if (job_ret[i] < 0)
+                return job_ret[i];
+    }
+
+    if (s->nb_output < s->nb_coded) {
+        FlacEncodeContext *t = s->thread[s->nb_output++];
+
+        /* the per-thread packets are scratch space, the returned packet has
+         * to come from the user's buffer allocator */
+        ret = ff_get_encode_buffer(avctx, avpkt, t->pkt->size, 0);
+        if (ret < 0)
+            return ret;
+        memcpy(avpkt->data, t->pkt->data, t->pkt->size);
+        av_packet_unref(t->pkt);
+
+        avpkt->pts      = t->pts;
+        avpkt->duration = t->duration;
+        update_frame_stats(s, avpkt);
+
+        *got_packet_ptr = 1;
+    }
+
+    return 0;
+}
+
+
 static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                              const AVFrame *frame, int *got_packet_ptr)
 {
@@ -1330,6 +1493,12 @@ static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
 
     s = avctx->priv_data;
 
+    if (s->nb_threads) {
+        ret = flac_encode_frame_threaded(avctx, avpkt, frame, got_packet_ptr);
+        if (ret < 0 || frame || *got_packet_ptr)
+            return ret;
+    }
+
     /* when the last block is reached, update the header in extradata */
     if (!frame) {
         s->max_framesize = s->max_encoded_framesize;
@@ -1363,22 +1532,9 @@ static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
 
     copy_samples(s, frame->data[0]);
 
-    channel_decorrelation(s);
-
-    remove_wasted_bits(s);
-
-    frame_bytes = encode_frame(s);
-
-    /* Fall back on verbatim mode if the compressed frame is larger than it
-       would be if encoded uncompressed. */
-    if (frame_bytes < 0 || frame_bytes > s->max_framesize) {
-        s->frame.verbatim_only = 1;
-        frame_bytes = encode_frame(s);
-        if (frame_bytes < 0) {
-            av_log(avctx, AV_LOG_ERROR, "Bad frame count\n");
-            return frame_bytes;
-        }
-    }
+    frame_bytes = encode_block(s);
+    if (frame_bytes < 0)
+        return frame_bytes;
 
     if ((ret = ff_get_encode_buffer(avctx, avpkt, frame_bytes, 0)) < 0)
         return ret;
@@ -1387,21 +1543,16 @@ static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
 
     s->frame_count++;
     s->sample_count += frame->nb_samples;
-    if ((ret = update_md5_sum(s, frame->data[0])) < 0) {
+    if ((ret = update_md5_sum(s, frame->data[0], frame->nb_samples)) < 0) {
         av_log(avctx, AV_LOG_ERROR, "Error updating MD5 checksum\n");
         return ret;
     }
-    if (out_bytes > s->max_encoded_framesize)
-        s->max_encoded_framesize = out_bytes;
-    if (out_bytes < s->min_framesize)
-        s->min_framesize = out_bytes;
 
     avpkt->pts      = frame->pts;
     avpkt->duration = ff_samples_to_time_base(avctx, frame->nb_samples);
 
-    s->next_pts = avpkt->pts + avpkt->duration;
-
     av_shrink_packet(avpkt, out_bytes);
+    update_frame_stats(s, avpkt);
 
     *got_packet_ptr = 1;
     return 0;
@@ -1412,6 +1563,11 @@ static av_cold int flac_encode_close(AVCodecContext *avctx)
 {
     FlacEncodeContext *s = avctx->priv_data;
 
+    for (int i = 0; i < s->nb_threads; i++) {
+        ff_lpc_end(&s->thread[i]->lpc_ctx);
+        av_packet_free(&s->thread[i]->pkt);
+        av_freep(&s->thread[i]);
+    }
     av_freep(&s->md5ctx);
     av_freep(&s->md5_buffer);
     ff_lpc_end(&s->lpc_ctx);
@@ -1463,7 +1619,7 @@ const AVCodec ff_flac_encoder = {
     .type           = AVMEDIA_TYPE_AUDIO,
     .id             = AV_CODEC_ID_FLAC,
     .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
-                      AV_CODEC_CAP_SMALL_LAST_FRAME,
+                      AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_SLICE_THREADS,
     .priv_data_size = sizeof(FlacEncodeContext),
     .init           = flac_encode_init,
     .encode2        = flac_encode_frame,
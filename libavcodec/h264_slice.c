@@ -2665,7 +2665,10 @@ static void decode_finish_row(const H264Context *h, H264SliceContext *sl)
 
     ff_h264_draw_horiz_band(h, sl, top, height);
 
-    if (h->droppable || sl->h264->slice_ctx[0].er.error_occurred)
+    /* slices decoded concurrently finish their rows out of order, progress
+     * is reported by ff_h264_execute_decode_slices() once all are done */
+    if (h->droppable || sl->h264->slice_ctx[0].er.error_occurred ||
+        sl->h264->nb_slice_ctx_queued > 1)
         return;
 
     ff_thread_report_progress(&h->cur_pic_ptr->tf, top + height - 1,
@@ -2974,6 +2977,17 @@ int ff_h264_execute_decode_slices(H264Context *h)
                 }
             }
         }
+
+        /* With frame threading, report the rows above the last slice,
+         * excluding the lines the deblocking of its row may still modify. */
+        if (avctx->active_thread_type & FF_THREAD_FRAME &&
+            !h->droppable && !h->slice_ctx[0].er.error_occurred) {
+            int progress = 16 * (h->mb_y >> FIELD_PICTURE(h)) -
+                           ((16 + 4) << FRAME_MBAFF(h)) - 1;
+            if (progress >= 0)
+                ff_thread_report_progress(&h->cur_pic_ptr->tf, progress,
+                                          h->picture_structure == PICT_BOTTOM_FIELD);
+        }
     }
 
 finish:
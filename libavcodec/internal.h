@@ -84,6 +84,18 @@
  * internal logic derive them from AVCodecInternal.last_pkt_props.
  */
 #define FF_CODEC_CAP_SETS_FRAME_PROPS       (1 << 8)
+/**
+ * Codec supports using slice threads inside each frame thread, i.e. it is
+ * safe to call execute()/execute2() and the ff_thread_*_progress2() functions
+ * from frame threading workers (see AVCodecContext.frame_threads).
+ */
+#define FF_CODEC_CAP_FRAME_SLICE_THREADS    (1 << 9)
+/**
+ * The slice threading jobs of the codec wait for the progress of each other,
+ * so they must all run at the same time on threads dedicated to the codec
+ * context rather than on a shared executor.
+ */
+#define FF_CODEC_CAP_SLICE_THREAD_CONCURRENT_JOBS (1 << 10)
 
 /**
  * AVCodec.codec_tags termination value
@@ -131,7 +143,14 @@ typedef struct AVCodecInternal {
 
     AVBufferRef *pool;
 
+    /**
+     * Buffer requirements last reported to AVCodecContext.buffer_requirements,
+     * zeroed if none were reported yet.
+     */
+    AVCodecBufferRequirements buffer_req;
+
     void *thread_ctx;
+    void *slice_thread_ctx;
 
     /**
      * This packet is used to hold the packet given to decoders
@@ -75,6 +75,7 @@ typedef struct Mpeg1Context {
     int closed_gop;
     int tmpgexs;
     int first_slice;
+    int field_pending;          /* current_picture_ptr lacks its second field */
     int extradata_decoded;
     int64_t timecode_frame_start;  /*< GOP timecode frame start number, in non drop frame format */
 } Mpeg1Context;
@@ -1084,8 +1085,52 @@ static int mpeg_decode_update_thread_context(AVCodecContext *avctx,
     if (err)
         return err;
 
-    if (!ctx->mpeg_enc_ctx_allocated)
-        memcpy(s + 1, s1 + 1, sizeof(Mpeg1Context) - sizeof(MpegEncContext));
+    /* state from the headers, not covered by ff_mpeg_update_thread_context() */
+    avctx->codec_id = avctx_from->codec_id;
+    s->codec_id     = s1->codec_id;
+    memcpy(s->intra_matrix,        s1->intra_matrix,        sizeof(s->intra_matrix));
+    memcpy(s->chroma_intra_matrix, s1->chroma_intra_matrix, sizeof(s->chroma_intra_matrix));
+    memcpy(s->inter_matrix,        s1->inter_matrix,        sizeof(s->inter_matrix));
+    memcpy(s->chroma_inter_matrix, s1->chroma_inter_matrix, sizeof(s->chroma_inter_matrix));
+
+    ctx->mpeg_enc_ctx_allocated = ctx_from->mpeg_enc_ctx_allocated;
+    ctx->repeat_field           = ctx_from->repeat_field;
+    ctx->pan_scan               = ctx_from->pan_scan;
+    ctx->stereo3d               = ctx_from->stereo3d;
+    ctx->has_stereo3d           = ctx_from->has_stereo3d;
+    ctx->afd                    = ctx_from->afd;
+    ctx->has_afd                = ctx_from->has_afd;
+    ctx->aspect_ratio_info      = ctx_from->aspect_ratio_info;
+    ctx->save_aspect            = ctx_from->save_aspect;
+    ctx->save_width             = ctx_from->save_width;
+    ctx->save_height            = ctx_from->save_height;
+    ctx->save_progressive_seq   = ctx_from->save_progressive_seq;
+    ctx->rc_buffer_size         = ctx_from->rc_buffer_size;
+    ctx->frame_rate_ext         = ctx_from->frame_rate_ext;
+    ctx->frame_rate_index       = ctx_from->frame_rate_index;
+    ctx->sync                   = ctx_from->sync;
+    ctx->closed_gop             = ctx_from->closed_gop;
+    ctx->tmpgexs                = ctx_from->tmpgexs;
+    ctx->field_pending          = ctx_from->field_pending;
+    ctx->extradata_decoded      = ctx_from->extradata_decoded;
+
+    /* captions not yet attached to a picture by the previous thread */
+    err = av_buffer_replace(&ctx->a53_buf_ref, ctx_from->a53_buf_ref);
+    if (err < 0)
+        return err;
+
+    if (!ctx->field_pending) {
+        /* the picture belongs to the previous thread, which finishes it */
+        s->current_picture_ptr = NULL;
+    } else if (s->current_picture_ptr) {
+        /* The second field of the picture is in the next packet and will be
+         * decoded by this thread, carry over the error state of the first. */
+        ff_mpeg_er_frame_start(s);
+        memcpy(s->er.error_status_table, s1->er.error_status_table,
+               s->mb_stride * s->mb_height);
+        atomic_store(&s->er.error_count, atomic_load(&s1->er.error_count));
+        s->er.error_occurred = s1->er.error_occurred;
+    }
 
     return 0;
 }
@@ -1583,6 +1628,12 @@ static int mpeg_field_start(MpegEncContext *s, const uint8_t *buf, int buf_size)
     if (s->first_field || s->picture_structure == PICT_FRAME) {
         AVFrameSideData *pan_scan;
 
+        /* A picture left without its second field will not be finished,
+         * unblock the threads referencing it. */
+        if (s1->field_pending && s->current_picture_ptr)
+            ff_thread_report_progress(&s->current_picture_ptr->tf, INT_MAX, 0);
+        s1->field_pending = s->picture_structure != PICT_FRAME;
+
         if ((ret = ff_mpv_frame_start(s, avctx)) < 0)
             return ret;
 
@@ -1637,11 +1688,18 @@ static int mpeg_field_start(MpegEncContext *s, const uint8_t *buf, int buf_size)
             s1->has_afd = 0;
         }
 
-        if (HAVE_THREADS && (avctx->active_thread_type & FF_THREAD_FRAME))
+        /* Field pictures are decoded serially: the setup is only finished
+         * by the frame threading code once the whole packet is decoded, so
+         * the next thread starts from a complete field pair or from the
+         * fully decoded first field. */
+        if (HAVE_THREADS && (avctx->active_thread_type & FF_THREAD_FRAME) &&
+            s->picture_structure == PICT_FRAME)
             ff_thread_finish_setup(avctx);
     } else { // second field
         int i;
 
+        s1->field_pending = 0;
+
         if (!s->current_picture_ptr) {
             av_log(s->avctx, AV_LOG_ERROR, "first field missing\n");
             return AVERROR_INVALIDDATA;
@@ -1828,7 +1886,9 @@ static int mpeg_decode_slice(MpegEncContext *s, int mb_y,
             int left;
 
             ff_mpeg_draw_horiz_band(s, mb_size * (s->mb_y >> field_pic), mb_size);
-            ff_mpv_report_decode_progress(s);
+            /* rows of the first field are only half decoded */
+            if (!field_pic || !s->first_field)
+                ff_mpv_report_decode_progress(s);
 
             s->mb_x  = 0;
             s->mb_y += 1 << field_pic;
@@ -2818,7 +2878,10 @@ static int mpeg_decode_frame(AVCodecContext *avctx, void *data,
 
     ret = decode_chunks(avctx, picture, got_output, buf, buf_size);
     if (ret<0 || *got_output) {
+        if (s2->current_picture_ptr && (ret < 0 || s->field_pending))
+            ff_thread_report_progress(&s2->current_picture_ptr->tf, INT_MAX, 0);
         s2->current_picture_ptr = NULL;
+        s->field_pending        = 0;
 
         if (s->timecode_frame_start != -1 && *got_output) {
             char tcbuf[AV_TIMECODE_STR_SIZE];
@@ -2843,8 +2906,9 @@ static void flush(AVCodecContext *avctx)
 {
     Mpeg1Context *s = avctx->priv_data;
 
-    s->sync       = 0;
-    s->closed_gop = 0;
+    s->sync          = 0;
+    s->closed_gop    = 0;
+    s->field_pending = 0;
 
     ff_mpeg_flush(avctx);
 }
@@ -2872,9 +2936,11 @@ const AVCodec ff_mpeg1video_decoder = {
 #if FF_API_FLAG_TRUNCATED
                              AV_CODEC_CAP_TRUNCATED |
 #endif
-                             AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS,
+                             AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS |
+                             AV_CODEC_CAP_FRAME_THREADS,
     .caps_internal         = FF_CODEC_CAP_INIT_THREADSAFE |
-                             FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
+                             FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM |
+                             FF_CODEC_CAP_ALLOCATE_PROGRESS,
     .flush                 = flush,
     .max_lowres            = 3,
     .update_thread_context = ONLY_IF_THREADS_ENABLED(mpeg_decode_update_thread_context),
@@ -2905,11 +2971,14 @@ const AVCodec ff_mpeg2video_decoder = {
 #if FF_API_FLAG_TRUNCATED
                       AV_CODEC_CAP_TRUNCATED |
 #endif
-                      AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS,
+                      AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS |
+                      AV_CODEC_CAP_FRAME_THREADS,
     .caps_internal  = FF_CODEC_CAP_INIT_THREADSAFE |
-                      FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
+                      FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM |
+                      FF_CODEC_CAP_ALLOCATE_PROGRESS,
     .flush          = flush,
     .max_lowres     = 3,
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(mpeg_decode_update_thread_context),
     .profiles       = NULL_IF_CONFIG_SMALL(ff_mpeg2_video_profiles),
     .hw_configs     = (const AVCodecHWConfigInternal *const []) {
 #if CONFIG_MPEG2_DXVA2_HWACCEL
@@ -2951,11 +3020,14 @@ const AVCodec ff_mpegvideo_decoder = {
 #if FF_API_FLAG_TRUNCATED
                       AV_CODEC_CAP_TRUNCATED |
 #endif
-                      AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS,
+                      AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS |
+                      AV_CODEC_CAP_FRAME_THREADS,
     .caps_internal  = FF_CODEC_CAP_INIT_THREADSAFE |
-                      FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
+                      FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM |
+                      FF_CODEC_CAP_ALLOCATE_PROGRESS,
     .flush          = flush,
     .max_lowres     = 3,
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(mpeg_decode_update_thread_context),
 };
 
 typedef struct IPUContext {
@@ -82,6 +82,8 @@ typedef struct Picture {
 
     int64_t mb_var_sum;         ///< sum of MB variance for current frame
     int64_t mc_mb_var_sum;      ///< motion compensated MB variance for current frame
+    int64_t lookahead_mb_var_sum;    ///< mb_var_sum estimated by the rate control lookahead
+    int64_t lookahead_mc_mb_var_sum; ///< mc_mb_var_sum estimated without motion compensation
 
     int b_frame_score;
     int needs_realloc;          ///< Picture needs to be reallocated (eg due to a frame size change)
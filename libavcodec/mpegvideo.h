@@ -510,6 +510,8 @@ typedef struct MpegEncContext {
     int   rc_qmod_freq;
     float rc_initial_cplx;
     float rc_buffer_aggressivity;
+    int rc_lookahead;             ///< number of frames the rate control looks ahead
+    int64_t *lookahead_row_sums;  ///< intra and inter lookahead complexity of each MB row
     float border_masking;
     int lmin, lmax;
     int vbv_ignore_qmax;
@@ -363,6 +363,12 @@ av_cold int ff_mpv_encode_init(AVCodecContext *avctx)
         av_log(avctx, AV_LOG_ERROR, "B-frames not supported by codec\n");
         return AVERROR(EINVAL);
     }
+    if (s->max_b_frames + s->rc_lookahead > MAX_B_FRAMES) {
+        av_log(avctx, AV_LOG_ERROR, "The number of B-frames and of rate "
+               "control lookahead frames must not exceed %d in total.\n",
+               MAX_B_FRAMES);
+        return AVERROR(EINVAL);
+    }
 
     s->strict_std_compliance = avctx->strict_std_compliance;
     s->quarter_sample     = (avctx->flags & AV_CODEC_FLAG_QPEL) != 0;
@@ -796,6 +802,7 @@ av_cold int ff_mpv_encode_init(AVCodecContext *avctx)
     }
 
     avctx->has_b_frames = !s->low_delay;
+    avctx->delay       += s->rc_lookahead;
 
     s->encoding = 1;
 
@@ -898,6 +905,10 @@ av_cold int ff_mpv_encode_init(AVCodecContext *avctx)
     if ((ret = ff_rate_control_init(s)) < 0)
         return ret;
 
+    if (s->rc_lookahead &&
+        !FF_ALLOCZ_TYPED_ARRAY(s->lookahead_row_sums, 2 * s->mb_height))
+        return AVERROR(ENOMEM);
+
     if (s->b_frame_strategy == 2) {
         for (i = 0; i < s->max_b_frames + 2; i++) {
             s->tmp_frames[i] = av_frame_alloc();
@@ -952,6 +963,7 @@ av_cold int ff_mpv_encode_end(AVCodecContext *avctx)
     av_freep(&s->input_picture);
     av_freep(&s->reordered_input_picture);
     av_freep(&s->dct_offset);
+    av_freep(&s->lookahead_row_sums);
 
     return 0;
 }
@@ -1001,13 +1013,77 @@ static int alloc_picture(MpegEncContext *s, Picture *pic, int shared)
                             &s->linesize, &s->uvlinesize);
 }
 
+static uint8_t *input_luma(MpegEncContext *s, const Picture *pic)
+{
+    if (!pic->shared && !s->avctx->rc_buffer_size)
+        return pic->f->data[0] + INPLACE_OFFSET;
+    return pic->f->data[0];
+}
+
+typedef struct LookaheadJob {
+    uint8_t *cur;   ///< luma plane of the new input picture
+    uint8_t *prev;  ///< luma plane of the previous input picture or NULL
+} LookaheadJob;
+
+static int lookahead_thread(AVCodecContext *avctx, void *arg,
+                            int mb_y, int threadnr)
+{
+    MpegEncContext *s = avctx->priv_data;
+    const LookaheadJob *job = arg;
+    int64_t var_sum = 0, mc_var_sum = 0;
+    int mb_x;
+
+    for (mb_x = 0; mb_x < s->mb_width; mb_x++) {
+        ptrdiff_t offset = 16 * (mb_y * s->linesize + mb_x);
+        uint8_t *pix = job->cur + offset;
+        int sum  = s->mpvencdsp.pix_sum(pix, s->linesize);
+        int varc = s->mpvencdsp.pix_norm1(pix, s->linesize) -
+                   (((unsigned) sum * sum) >> 8) + 500;
+
+        var_sum += (varc + 128) >> 8;
+        if (job->prev) {
+            int vard = s->mecc.sse[0](NULL, pix, job->prev + offset,
+                                      s->linesize, 16);
+            mc_var_sum += (vard + 128) >> 8;
+        }
+    }
+    s->lookahead_row_sums[2 * mb_y    ] = var_sum;
+    s->lookahead_row_sums[2 * mb_y + 1] = job->prev ? mc_var_sum : var_sum;
+    return 0;
+}
+
+/**
+ * Estimate the complexity of a new input picture for the rate control
+ * lookahead, in the units of mb_var_sum and mc_mb_var_sum, using the
+ * previous input picture in place of motion compensation.
+ */
+static void lookahead_estimate(MpegEncContext *s, Picture *pic, Picture *prev)
+{
+    LookaheadJob job = {
+        .cur  = input_luma(s, pic),
+        .prev = prev ? input_luma(s, prev) : NULL,
+    };
+    int mb_y;
+
+    s->avctx->execute2(s->avctx, lookahead_thread, &job, NULL, s->mb_height);
+    emms_c();
+
+    pic->lookahead_mb_var_sum    = 0;
+    pic->lookahead_mc_mb_var_sum = 0;
+    for (mb_y = 0; mb_y < s->mb_height; mb_y++) {
+        pic->lookahead_mb_var_sum    += s->lookahead_row_sums[2 * mb_y    ];
+        pic->lookahead_mc_mb_var_sum += s->lookahead_row_sums[2 * mb_y + 1];
+    }
+}
+
 static int load_input_picture(MpegEncContext *s, const AVFrame *pic_arg)
 {
     Picture *pic = NULL;
     int64_t pts;
     int i, display_picture_number = 0, ret;
-    int encoding_delay = s->max_b_frames ? s->max_b_frames
-                                         : (s->low_delay ? 0 : 1);
+    int encoding_delay = (s->max_b_frames ? s->max_b_frames
+                                          : (s->low_delay ? 0 : 1)) +
+                         s->rc_lookahead;
     int flush_offset = 1;
     int direct = 1;
 
@@ -1149,6 +1225,9 @@ static int load_input_picture(MpegEncContext *s, const AVFrame *pic_arg)
 
     s->input_picture[encoding_delay] = (Picture*) pic;
 
+    if (pic && s->rc_lookahead)
+        lookahead_estimate(s, pic, s->input_picture[encoding_delay - 1]);
+
     return 0;
 }
 
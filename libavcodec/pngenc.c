@@ -37,6 +37,8 @@
 #include <zlib.h>
 
 #define IOBUF_SIZE 4096
+/* minimum amount of filtered data deflated by one job with slice threading */
+#define DEFLATE_CHUNK_SIZE (128 * 1024)
 
 typedef struct APNGFctlChunk {
     uint32_t sequence_number;
@@ -78,6 +80,22 @@ typedef struct PNGEncContext {
     APNGFctlChunk last_frame_fctl;
     uint8_t *last_frame_packet;
     size_t last_frame_packet_size;
+
+    // slice threading
+    int compression_level;
+    z_stream *chunk_zstream;     ///< raw deflate stream of each thread
+    int nb_chunk_zstreams;
+    int rows_per_chunk;
+    int nb_chunks;
+    uint8_t *filtered;           ///< filtered rows, each preceded by its filter type
+    unsigned int filtered_size;
+    uint8_t *crow_bufs;          ///< filter scratch buffer of each thread
+    unsigned int crow_bufs_size;
+    uint8_t *chunk_buf;          ///< deflated chunks, chunk_buf_stride bytes apart
+    unsigned int chunk_buf_size;
+    size_t chunk_buf_stride;
+    int *chunk_len;
+    uint32_t *chunk_adler;
 } PNGEncContext;
 
 static void png_get_interlaced_row(uint8_t *dst, int row_size,
@@ -429,6 +447,132 @@ static int encode_headers(AVCodecContext *avctx, const AVFrame *pict)
     return 0;
 }
 
+static int filter_rows_thread(AVCodecContext *avctx, void *arg,
+                              int jobnr, int threadnr)
+{
+    PNGEncContext *s       = avctx->priv_data;
+    const AVFrame *const p = arg;
+    int row_size    = (p->width * s->bits_per_pixel + 7) >> 3;
+    int crow_stride = FFALIGN((row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED), 32);
+    int y_start     = jobnr * s->rows_per_chunk;
+    int y_end       = FFMIN(y_start + s->rows_per_chunk, p->height);
+    // pixel data should be aligned, but there's a control byte before it
+    uint8_t *crow_buf = s->crow_bufs + threadnr * crow_stride + 15;
+
+    for (int y = y_start; y < y_end; y++) {
+        uint8_t *ptr  = p->data[0] + y * p->linesize[0];
+        uint8_t *top  = y ? ptr - p->linesize[0] : NULL;
+        uint8_t *crow = png_choose_filter(s, crow_buf, ptr, top,
+                                          row_size, s->bits_per_pixel >> 3);
+        memcpy(s->filtered + y * (row_size + 1), crow, row_size + 1);
+    }
+    return 0;
+}
+
+static int deflate_chunk_thread(AVCodecContext *avctx, void *arg,
+                                int jobnr, int threadnr)
+{
+    PNGEncContext *s       = avctx->priv_data;
+    const AVFrame *const p = arg;
+    z_stream *zstream      = &s->chunk_zstream[threadnr];
+    size_t row_size        = ((p->width * s->bits_per_pixel + 7) >> 3) + 1;
+    int last               = jobnr == s->nb_chunks - 1;
+    const uint8_t *start   = s->filtered + jobnr * s->rows_per_chunk * row_size;
+    size_t len  = FFMIN(s->rows_per_chunk, p->height - jobnr * s->rows_per_chunk) * row_size;
+    size_t dict = FFMIN(start - s->filtered, 32768);
+    int ret;
+
+    deflateReset(zstream);
+    /* prime the window with the end of the previous chunk, as a single
+     * stream would have it */
+    if (dict && deflateSetDictionary(zstream, start - dict, dict) != Z_OK)
+        return AVERROR_EXTERNAL;
+
+    zstream->next_in   = start;
+    zstream->avail_in  = len;
+    zstream->next_out  = s->chunk_buf + jobnr * s->chunk_buf_stride + 2;
+    zstream->avail_out = s->chunk_buf_stride - 6;
+    /* a sync flush ends the chunk on a byte boundary, so that the chunks
+     * can be concatenated */
+    ret = deflate(zstream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    if (last ? ret != Z_STREAM_END : ret != Z_OK || !zstream->avail_out)
+        return AVERROR_EXTERNAL;
+
+    s->chunk_adler[jobnr] = adler32(adler32(0, NULL, 0), start, len);
+    return s->chunk_buf_stride - 6 - zstream->avail_out;
+}
+
+/**
+ * Encode the image data with slice threading: the rows are filtered in
+ * parallel, then the filtered data is split in chunks of whole rows which
+ * are deflated in parallel and joined into a single zlib stream. The
+ * chunk size does not depend on the number of threads, neither does the
+ * output.
+ */
+static int encode_frame_chunked(AVCodecContext *avctx, const AVFrame *pict)
+{
+    PNGEncContext *s = avctx->priv_data;
+    int row_size     = (pict->width * s->bits_per_pixel + 7) >> 3;
+    int crow_stride  = FFALIGN((row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED), 32);
+    int level        = s->compression_level;
+    uLong adler      = adler32(0, NULL, 0);
+    unsigned header;
+    uint8_t *buf;
+
+    s->rows_per_chunk   = FFMAX(DEFLATE_CHUNK_SIZE / (row_size + 1), 1);
+    s->nb_chunks        = (pict->height + s->rows_per_chunk - 1) / s->rows_per_chunk;
+    s->chunk_buf_stride = deflateBound(&s->chunk_zstream[0],
+                                       s->rows_per_chunk * (row_size + 1)) + 16;
+    if ((int64_t)pict->height * (row_size + 1) > INT_MAX ||
+        (int64_t)s->chunk_buf_stride * s->nb_chunks > INT_MAX ||
+        (int64_t)crow_stride * avctx->thread_count > INT_MAX)
+        return AVERROR(ENOMEM);
+
+    av_fast_malloc(&s->filtered, &s->filtered_size, pict->height * (row_size + 1));
+    av_fast_malloc(&s->crow_bufs, &s->crow_bufs_size, crow_stride * avctx->thread_count);
+    av_fast_malloc(&s->chunk_buf, &s->chunk_buf_size, s->chunk_buf_stride * s->nb_chunks);
+    if (!s->filtered || !s->crow_bufs || !s->chunk_buf)
+        return AVERROR(ENOMEM);
+    if (av_reallocp_array(&s->chunk_len,   s->nb_chunks, sizeof(*s->chunk_len))   < 0 ||
+        av_reallocp_array(&s->chunk_adler, s->nb_chunks, sizeof(*s->chunk_adler)) < 0)
+        return AVERROR(ENOMEM);
+
+    avctx->execute2(avctx, filter_rows_thread, (void *)pict, NULL, s->nb_chunks);
+    avctx->execute2(avctx, deflate_chunk_thread, (void *)pict, s->chunk_len, s->nb_chunks);
+
+    /* zlib header, as deflateInit2() would write it for this level */
+    if (level == Z_DEFAULT_COMPRESSION)
+        level = 6;
+    header  = 0x78 << 8 | (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+    header += 31 - header % 31;
+
+    for (int i = 0; i < s->nb_chunks; i++) {
+        int y   = i * s->rows_per_chunk;
+        int len = s->chunk_len[i];
+
+        if (len < 0)
+            return len;
+        adler = adler32_combine(adler, s->chunk_adler[i],
+                                FFMIN(s->rows_per_chunk, pict->height - y) * (row_size + 1));
+
+        buf = s->chunk_buf + i * s->chunk_buf_stride + 2;
+        if (!i) {
+            buf -= 2;
+            AV_WB16(buf, header);
+            len += 2;
+        }
+        if (i == s->nb_chunks - 1) {
+            AV_WB32(buf + len, adler);
+            len += 4;
+        }
+        if (s->bytestream_end - s->bytestream < len + 16)
+            return AVERROR_BUG;
+        png_write_image_data(avctx, buf, len);
+    }
+
+    return 0;
+}
+
 static int encode_frame(AVCodecContext *avctx, const AVFrame *pict)
 {
     PNGEncContext *s       = avctx->priv_data;
@@ -440,6 +584,9 @@ static int encode_frame(AVCodecContext *avctx, const AVFrame *pict)
     uint8_t *progressive_buf = NULL;
     uint8_t *top_buf         = NULL;
 
+    if (s->nb_chunk_zstreams && !s->is_progressive)
+        return encode_frame_chunked(avctx, pict);
+
     row_size = (pict->width * s->bits_per_pixel + 7) >> 3;
 
     crow_base = av_malloc((row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED));
@@ -1075,6 +1222,24 @@ static av_cold int png_enc_init(AVCodecContext *avctx)
                       : av_clip(avctx->compression_level, 0, 9);
     if (deflateInit2(&s->zstream, compression_level, Z_DEFLATED, 15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
         return -1;
+    s->compression_level = compression_level;
+
+    if (avctx->active_thread_type & FF_THREAD_SLICE && avctx->thread_count > 1) {
+        s->chunk_zstream = av_calloc(avctx->thread_count, sizeof(*s->chunk_zstream));
+        if (!s->chunk_zstream)
+            return AVERROR(ENOMEM);
+        for (int i = 0; i < avctx->thread_count; i++) {
+            z_stream *zstream = &s->chunk_zstream[i];
+
+            zstream->zalloc = ff_png_zalloc;
+            zstream->zfree  = ff_png_zfree;
+            zstream->opaque = NULL;
+            if (deflateInit2(zstream, compression_level, Z_DEFLATED, -15, 8,
+                             Z_DEFAULT_STRATEGY) != Z_OK)
+                return AVERROR_EXTERNAL;
+            s->nb_chunk_zstreams++;
+        }
+    }
 
     return 0;
 }
@@ -1084,6 +1249,14 @@ static av_cold int png_enc_close(AVCodecContext *avctx)
     PNGEncContext *s = avctx->priv_data;
 
     deflateEnd(&s->zstream);
+    for (int i = 0; i < s->nb_chunk_zstreams; i++)
+        deflateEnd(&s->chunk_zstream[i]);
+    av_freep(&s->chunk_zstream);
+    av_freep(&s->filtered);
+    av_freep(&s->crow_bufs);
+    av_freep(&s->chunk_buf);
+    av_freep(&s->chunk_len);
+    av_freep(&s->chunk_adler);
     av_frame_free(&s->last_frame);
     av_frame_free(&s->prev_frame);
     av_freep(&s->last_frame_packet);
@@ -1123,7 +1296,7 @@ const AVCodec ff_png_encoder = {
     .init           = png_enc_init,
     .close          = png_enc_close,
     .encode2        = encode_png,
-    .capabilities   = AV_CODEC_CAP_FRAME_THREADS,
+    .capabilities   = AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS,
     .pix_fmts       = (const enum AVPixelFormat[]) {
         AV_PIX_FMT_RGB24, AV_PIX_FMT_RGBA,
         AV_PIX_FMT_RGB48BE, AV_PIX_FMT_RGBA64BE,
@@ -1133,7 +1306,7 @@ const AVCodec ff_png_encoder = {
         AV_PIX_FMT_MONOBLACK, AV_PIX_FMT_NONE
     },
     .priv_class     = &pngenc_class,
-    .caps_internal  = FF_CODEC_CAP_INIT_THREADSAFE,
+    .caps_internal  = FF_CODEC_CAP_INIT_THREADSAFE | FF_CODEC_CAP_INIT_CLEANUP,
 };
 
 const AVCodec ff_apng_encoder = {
@@ -1141,7 +1314,8 @@ const AVCodec ff_apng_encoder = {
     .long_name      = NULL_IF_CONFIG_SMALL("APNG (Animated Portable Network Graphics) image"),
     .type           = AVMEDIA_TYPE_VIDEO,
     .id             = AV_CODEC_ID_APNG,
-    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY,
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .priv_data_size = sizeof(PNGEncContext),
     .init           = png_enc_init,
     .close          = png_enc_close,
@@ -1155,5 +1329,5 @@ const AVCodec ff_apng_encoder = {
         AV_PIX_FMT_NONE
     },
     .priv_class     = &pngenc_class,
-    .caps_internal  = FF_CODEC_CAP_INIT_THREADSAFE,
+    .caps_internal  = FF_CODEC_CAP_INIT_THREADSAFE | FF_CODEC_CAP_INIT_CLEANUP,
 };
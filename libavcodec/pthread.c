@@ -42,6 +42,7 @@
  * Threading requires more than one thread.
  * Frame threading requires entire frames to be passed to the codec,
  * and introduces extra decoding delay, so is incompatible with low_delay.
+ * If frame_threads is set, codecs which support it combine both methods.
  *
  * @param avctx The context.
  */
@@ -53,12 +54,19 @@ static void validate_thread_parameters(AVCodecContext *avctx)
 #endif
                                 && !(avctx->flags  & AV_CODEC_FLAG_LOW_DELAY)
                                 && !(avctx->flags2 & AV_CODEC_FLAG2_CHUNKS);
+    int slice_threading_supported = (avctx->codec->capabilities & AV_CODEC_CAP_SLICE_THREADS)
+                                && (avctx->thread_type & FF_THREAD_SLICE);
     if (avctx->thread_count == 1) {
         avctx->active_thread_type = 0;
-    } else if (frame_threading_supported && (avctx->thread_type & FF_THREAD_FRAME)) {
+    } else if (frame_threading_supported && (avctx->thread_type & FF_THREAD_FRAME) &&
+               !(avctx->frame_threads == 1 && slice_threading_supported)) {
         avctx->active_thread_type = FF_THREAD_FRAME;
-    } else if (avctx->codec->capabilities & AV_CODEC_CAP_SLICE_THREADS &&
-               avctx->thread_type & FF_THREAD_SLICE) {
+        /* The split of thread_count between frame and slice threads is done
+         * in ff_frame_thread_init(), once the thread count is known. */
+        if (avctx->frame_threads > 0 && slice_threading_supported &&
+            avctx->codec->caps_internal & FF_CODEC_CAP_FRAME_SLICE_THREADS)
+            avctx->active_thread_type |= FF_THREAD_SLICE;
+    } else if (slice_threading_supported) {
         avctx->active_thread_type = FF_THREAD_SLICE;
     } else if (!(avctx->codec->caps_internal & FF_CODEC_CAP_AUTO_THREADS)) {
         avctx->thread_count       = 1;
@@ -75,10 +83,10 @@ int ff_thread_init(AVCodecContext *avctx)
 {
     validate_thread_parameters(avctx);
 
-    if (avctx->active_thread_type&FF_THREAD_SLICE)
-        return ff_slice_thread_init(avctx);
-    else if (avctx->active_thread_type&FF_THREAD_FRAME)
+    if (avctx->active_thread_type&FF_THREAD_FRAME)
         return ff_frame_thread_init(avctx);
+    else if (avctx->active_thread_type&FF_THREAD_SLICE)
+        return ff_slice_thread_init(avctx);
 
     return 0;
 }
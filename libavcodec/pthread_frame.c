@@ -146,6 +146,8 @@ typedef struct FrameThreadContext {
                                     * Set for the first N packets, where N is the number of threads.
                                     * While it is set, ff_thread_en/decode_frame won't return any results.
                                     */
+
+    int slice_thread_count;        ///< Number of slice threads used by each frame thread, 0 if none.
 } FrameThreadContext;
 
 #if FF_API_THREAD_SAFE_CALLBACKS
@@ -342,6 +344,7 @@ static int update_context_from_user(AVCodecContext *dst, AVCodecContext *src)
 
     dst->draw_horiz_band= src->draw_horiz_band;
     dst->get_buffer2    = src->get_buffer2;
+    dst->buffer_requirements = src->buffer_requirements;
 
     dst->opaque   = src->opaque;
     dst->debug    = src->debug;
@@ -741,6 +744,9 @@ void ff_frame_thread_free(AVCodecContext *avctx, int thread_count)
 
             av_freep(&ctx->slice_offset);
 
+            if (ctx->internal->slice_thread_ctx)
+                ff_slice_thread_free(ctx);
+
             av_buffer_unref(&ctx->internal->pool);
             av_freep(&ctx->internal);
             av_buffer_unref(&ctx->hw_frames_ctx);
@@ -788,6 +794,13 @@ static av_cold int init_thread(PerThreadContext *p, int *threads_to_free,
 
     copy->delay = avctx->delay;
 
+    if (fctx->slice_thread_count) {
+        copy->thread_count = fctx->slice_thread_count;
+        err = ff_slice_thread_init(copy);
+        if (err < 0)
+            return err;
+    }
+
     if (codec->priv_data_size) {
         copy->priv_data = av_mallocz(codec->priv_data_size);
         if (!copy->priv_data)
@@ -841,6 +854,7 @@ int ff_frame_thread_init(AVCodecContext *avctx)
     int thread_count = avctx->thread_count;
     const AVCodec *codec = avctx->codec;
     FrameThreadContext *fctx;
+    int slice_thread_count = 0;
     int err, i = 0;
 
     if (!thread_count) {
@@ -857,10 +871,25 @@ int ff_frame_thread_init(AVCodecContext *avctx)
         return 0;
     }
 
+    if (avctx->active_thread_type & FF_THREAD_SLICE) {
+        /* Hybrid threading: use at most frame_threads frame threads and
+         * share the remaining threads between them for slice threading. */
+        int frame_threads = FFMIN(avctx->frame_threads, thread_count);
+        slice_thread_count = thread_count / frame_threads;
+        if (slice_thread_count > 1) {
+            thread_count = avctx->thread_count = frame_threads;
+        } else {
+            slice_thread_count = 0;
+            avctx->active_thread_type = FF_THREAD_FRAME;
+        }
+    }
+
     avctx->internal->thread_ctx = fctx = av_mallocz(sizeof(FrameThreadContext));
     if (!fctx)
         return AVERROR(ENOMEM);
 
+    fctx->slice_thread_count = slice_thread_count;
+
     err = ff_pthread_init(fctx, thread_ctx_offsets);
     if (err < 0) {
         ff_pthread_free(fctx, thread_ctx_offsets);
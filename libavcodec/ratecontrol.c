@@ -232,17 +232,16 @@ static double modify_qscale(MpegEncContext *s, RateControlEntry *rce,
 }
 
 /**
- * Modify the bitrate curve from pass1 for one frame.
+ * Evaluate the rate control equation for one frame.
+ * @return the unscaled number of bits for the frame or NAN on error
  */
-static double get_qscale(MpegEncContext *s, RateControlEntry *rce,
-                         double rate_factor, int frame_num)
+static double eval_rc_eq(MpegEncContext *s, RateControlEntry *rce)
 {
     RateControlContext *rcc = &s->rc_context;
     AVCodecContext *a       = s->avctx;
     const int pict_type     = rce->new_pict_type;
     const double mb_num     = s->mb_num;
-    double q, bits;
-    int i;
+    double bits;
 
     double const_values[] = {
         M_PI,
@@ -269,10 +268,26 @@ static double get_qscale(MpegEncContext *s, RateControlEntry *rce,
     };
 
     bits = av_expr_eval(rcc->rc_eq_eval, const_values, rce);
-    if (isnan(bits)) {
+    if (isnan(bits))
         av_log(s->avctx, AV_LOG_ERROR, "Error evaluating rc_eq \"%s\"\n", s->rc_eq);
+
+    return bits;
+}
+
+/**
+ * Modify the bitrate curve from pass1 for one frame.
+ */
+static double get_qscale(MpegEncContext *s, RateControlEntry *rce,
+                         double rate_factor, int frame_num)
+{
+    RateControlContext *rcc = &s->rc_context;
+    const int pict_type     = rce->new_pict_type;
+    double q, bits;
+    int i;
+
+    bits = eval_rc_eq(s, rce);
+    if (isnan(bits))
         return -1;
-    }
 
     rcc->pass1_rc_eq_output_sum += bits;
     bits *= rate_factor;
@@ -535,6 +550,7 @@ av_cold int ff_rate_control_init(MpegEncContext *s)
         rcc->frame_count[i] = 1; // 1 is better because of 1/0 and such
 
         rcc->last_qscale_for[i] = FF_QP2LAMBDA * 5;
+        rcc->lookahead_mc_ratio[i] = 1.0;
     }
     rcc->buffer_index = s->avctx->rc_initial_buffer_occupancy;
     if (!rcc->buffer_index)
@@ -864,10 +880,131 @@ void ff_get_2pass_fcode(MpegEncContext *s)
 
 // FIXME rd or at least approx for dquant
 
+static void init_1pass_rce(MpegEncContext *s, RateControlEntry *rce,
+                           int pict_type, int64_t mb_var_sum,
+                           int64_t mc_mb_var_sum)
+{
+    RateControlContext *rcc = &s->rc_context;
+    int64_t var = pict_type == AV_PICTURE_TYPE_I ? mb_var_sum : mc_mb_var_sum;
+    double bits;
+
+    rce->pict_type     =
+    rce->new_pict_type = pict_type;
+    rce->mc_mb_var_sum = mc_mb_var_sum;
+    rce->mb_var_sum    = mb_var_sum;
+    rce->qscale        = FF_QP2LAMBDA * 2;
+    rce->f_code        = s->f_code;
+    rce->b_code        = s->b_code;
+    rce->misc_bits     = 1;
+
+    bits = predict_size(&rcc->pred[pict_type], rce->qscale, sqrt(var));
+    if (pict_type == AV_PICTURE_TYPE_I) {
+        rce->i_count    = s->mb_num;
+        rce->i_tex_bits = bits;
+        rce->p_tex_bits = 0;
+        rce->mv_bits    = 0;
+    } else {
+        rce->i_count    = 0;    // FIXME we do know this approx
+        rce->i_tex_bits = 0;
+        rce->p_tex_bits = bits * 0.9;
+        rce->mv_bits    = bits * 0.1;
+    }
+}
+
+static void add_lookahead_frame(MpegEncContext *s, RateControlEntry *la,
+                                int *nb_frames, const Picture *pic, int pict_type)
+{
+    RateControlContext *rcc = &s->rc_context;
+    int64_t mc_mb_var_sum = pic->lookahead_mc_mb_var_sum *
+                            rcc->lookahead_mc_ratio[pict_type];
+
+    init_1pass_rce(s, &la[(*nb_frames)++], pict_type,
+                   pic->lookahead_mb_var_sum, mc_mb_var_sum);
+}
+
+/**
+ * Build rate control entries for the frames following the current one in
+ * coded order, from the complexity estimated when they were buffered.
+ * Frames whose type has not been decided yet are assumed to follow the
+ * regular B-frame pattern.
+ *
+ * @return the number of frames stored in la
+ */
+static int get_lookahead(MpegEncContext *s, RateControlEntry *la)
+{
+    int nb_frames = 0, nb_input, i, k;
+    int last_selected = s->next_picture_ptr->f->display_picture_number;
+
+    /* frames already reordered, waiting to be coded */
+    for (i = 1; i < MAX_PICTURE_COUNT && s->reordered_input_picture[i] &&
+                nb_frames < s->rc_lookahead; i++)
+        add_lookahead_frame(s, la, &nb_frames, s->reordered_input_picture[i],
+                            s->reordered_input_picture[i]->f->pict_type);
+
+    /* the input queue also holds already selected frames in front of the
+     * unselected ones, so look for the latter from its end */
+    for (nb_input = 0; nb_input < MAX_PICTURE_COUNT && s->input_picture[nb_input]; nb_input++)
+        ;
+    for (i = nb_input; i > 0; i--)
+        if (s->input_picture[i - 1]->f->display_picture_number <= last_selected)
+            break;
+    for (k = 1; i < nb_input && nb_frames < s->rc_lookahead; i++, k++)
+        add_lookahead_frame(s, la, &nb_frames, s->input_picture[i],
+                            k % (s->max_b_frames + 1) ? AV_PICTURE_TYPE_B
+                                                      : AV_PICTURE_TYPE_P);
+
+    return nb_frames;
+}
+
+/**
+ * Raise q until the sizes predicted for the current frame and the lookahead
+ * frames at that quantizer fit in the VBV buffer. B-frames of the window are
+ * assumed to be quantized relative to q as get_diff_limited_q() does.
+ */
+static double lookahead_vbv_limit(MpegEncContext *s, RateControlEntry *rce,
+                                  double q, RateControlEntry *la, int nb_frames)
+{
+    RateControlContext *rcc  = &s->rc_context;
+    AVCodecContext *a        = s->avctx;
+    const double buffer_size = a->rc_buffer_size;
+    const double max_rate    = a->rc_max_rate / get_fps(a);
+    const int pict_type      = rce->new_pict_type;
+    int qmin, qmax, i;
+
+    get_qminmax(&qmin, &qmax, s, pict_type);
+
+    while (q < qmax) {
+        double var   = pict_type == AV_PICTURE_TYPE_I ? rce->mb_var_sum : rce->mc_mb_var_sum;
+        double level = rcc->buffer_index -
+                       predict_size(&rcc->pred[pict_type], q, sqrt(var));
+
+        for (i = 0; i < nb_frames && level >= 0; i++) {
+            double frame_q = q;
+
+            if (la[i].pict_type == AV_PICTURE_TYPE_B && a->b_quant_factor > 0.0)
+                frame_q = q * a->b_quant_factor + a->b_quant_offset;
+            var    = la[i].pict_type == AV_PICTURE_TYPE_I ? la[i].mb_var_sum
+                                                          : la[i].mc_mb_var_sum;
+            level  = FFMIN(level + max_rate, buffer_size);
+            level -= predict_size(&rcc->pred[la[i].pict_type], frame_q, sqrt(var));
+        }
+        if (level >= 0)
+            break;
+
+        if (a->debug & FF_DEBUG_RC)
+            av_log(a, AV_LOG_DEBUG,
+                   "lookahead predicts VBV underflow at frame %d, raising QP %f\n",
+                   i, q);
+        q = FFMIN(q * 1.05, qmax);
+    }
+
+    return q;
+}
+
 float ff_rate_estimate_qscale(MpegEncContext *s, int dry_run)
 {
     float q;
-    int qmin, qmax;
+    int qmin, qmax, i;
     float br_compensation;
     double diff;
     double short_term_q;
@@ -877,7 +1014,9 @@ float ff_rate_estimate_qscale(MpegEncContext *s, int dry_run)
     RateControlContext *rcc = &s->rc_context;
     AVCodecContext *a       = s->avctx;
     RateControlEntry local_rce, *rce;
-    double bits;
+    RateControlEntry lookahead[MAX_B_FRAMES];
+    int lookahead_frames = 0;
+    double lookahead_bits = 0, lookahead_eq_sum = 0;
     double rate_factor;
     int64_t var;
     const int pict_type = s->pict_type;
@@ -941,34 +1080,34 @@ float ff_rate_estimate_qscale(MpegEncContext *s, int dry_run)
         ff_dlog(s, "%f %f %f last:%d var:%"PRId64" type:%d//\n", q, rce->new_qscale,
                 br_compensation, s->frame_bits, var, pict_type);
     } else {
-        rce->pict_type     =
-        rce->new_pict_type = pict_type;
-        rce->mc_mb_var_sum = pic->mc_mb_var_sum;
-        rce->mb_var_sum    = pic->mb_var_sum;
-        rce->qscale        = FF_QP2LAMBDA * 2;
-        rce->f_code        = s->f_code;
-        rce->b_code        = s->b_code;
-        rce->misc_bits     = 1;
-
-        bits = predict_size(&rcc->pred[pict_type], rce->qscale, sqrt(var));
-        if (pict_type == AV_PICTURE_TYPE_I) {
-            rce->i_count    = s->mb_num;
-            rce->i_tex_bits = bits;
-            rce->p_tex_bits = 0;
-            rce->mv_bits    = 0;
-        } else {
-            rce->i_count    = 0;    // FIXME we do know this approx
-            rce->i_tex_bits = 0;
-            rce->p_tex_bits = bits * 0.9;
-            rce->mv_bits    = bits * 0.1;
-        }
+        init_1pass_rce(s, rce, pict_type, pic->mb_var_sum, pic->mc_mb_var_sum);
         rcc->i_cplx_sum[pict_type]  += rce->i_tex_bits * rce->qscale;
         rcc->p_cplx_sum[pict_type]  += rce->p_tex_bits * rce->qscale;
         rcc->mv_bits_sum[pict_type] += rce->mv_bits;
         rcc->frame_count[pict_type]++;
 
-        rate_factor = rcc->pass1_wanted_bits /
-                      rcc->pass1_rc_eq_output_sum * br_compensation;
+        if (s->rc_lookahead) {
+            const Picture *input = s->reordered_input_picture[0];
+
+            if (pict_type != AV_PICTURE_TYPE_I &&
+                pic->mc_mb_var_sum && input->lookahead_mc_mb_var_sum)
+                rcc->lookahead_mc_ratio[pict_type] = (double)pic->mc_mb_var_sum /
+                                                     input->lookahead_mc_mb_var_sum;
+
+            /* account for the frames ahead as if they had been coded already,
+             * so that bits are saved ahead of complex scenes */
+            lookahead_frames = get_lookahead(s, lookahead);
+            for (i = 0; i < lookahead_frames; i++) {
+                double eq = eval_rc_eq(s, &lookahead[i]);
+                if (isnan(eq))
+                    return -1;
+                lookahead_eq_sum += eq;
+            }
+            lookahead_bits = lookahead_frames * s->bit_rate / fps;
+        }
+
+        rate_factor = (rcc->pass1_wanted_bits + lookahead_bits) /
+                      (rcc->pass1_rc_eq_output_sum + lookahead_eq_sum) * br_compensation;
 
         q = get_qscale(s, rce, rate_factor, picture_number);
         if (q < 0)
@@ -991,6 +1130,10 @@ float ff_rate_estimate_qscale(MpegEncContext *s, int dry_run)
 
         q = modify_qscale(s, rce, q, picture_number);
 
+        if (lookahead_frames && pict_type != AV_PICTURE_TYPE_B &&
+            a->rc_buffer_size && a->rc_max_rate)
+            q = lookahead_vbv_limit(s, rce, q, lookahead, lookahead_frames);
+
         rcc->pass1_wanted_bits += s->bit_rate / fps;
 
         av_assert0(q > 0.0);
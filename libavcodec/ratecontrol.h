@@ -79,6 +79,7 @@ typedef struct RateControlContext{
     uint64_t qscale_sum[5];
     int frame_count[5];
     int last_non_b_pict_type;
+    double lookahead_mc_ratio[5]; ///< mc_mb_var_sum of the last frame of each type relative to its lookahead estimate
 
     void *non_lavc_opaque;        ///< context for non lavc rc code (for example xvid)
     float dry_run_qscale;         ///< for xvid rc
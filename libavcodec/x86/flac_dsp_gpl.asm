@@ -24,7 +24,7 @@
 
 SECTION .text
 
-INIT_XMM sse4
+%macro FLAC_ENC_LPC_16 0
 %if ARCH_X86_64
     cglobal flac_enc_lpc_16, 5, 7, 8, 0, res, smp, len, order, coefs
     DECLARE_REG_TMP 5, 6
@@ -51,7 +51,7 @@ lea  resq,   [resq+orderq*4]
 lea  smpq,   [smpq+orderq*4]
 lea  coefsq, [coefsq+orderq*4]
 sub  length,  orderd
-movd m3,      r5m
+movd xm3,     r5m
 neg  orderq
 
 %define posj t0q
@@ -65,8 +65,12 @@ neg  orderq
     xor  negj, negj
 
     .looporder:
+%if cpuflag(avx2)
+        vpbroadcastd m2, [coefsq+posj*4] ; c = coefs[j]
+%else
         movd   m2, [coefsq+posj*4] ; c = coefs[j]
         SPLATD m2
+%endif
         movu   m1, [smpq+negj*4-4] ; s = smp[i-j-1]
         movu   m5, [smpq+negj*4-4+mmsize]
         movu   m7, [smpq+negj*4-4+mmsize*2]
@@ -81,9 +85,9 @@ neg  orderq
         inc    posj
     jnz .looporder
 
-    psrad  m0,     m3              ; p >>= shift
-    psrad  m4,     m3
-    psrad  m6,     m3
+    psrad  m0,     xm3             ; p >>= shift
+    psrad  m4,     xm3
+    psrad  m6,     xm3
     movu   m1,    [smpq]
     movu   m5,    [smpq+mmsize]
     movu   m7,    [smpq+mmsize*2]
@@ -99,3 +103,12 @@ neg  orderq
     sub length, (3*mmsize)/4
 jg .looplen
 RET
+%endmacro
+
+INIT_XMM sse4
+FLAC_ENC_LPC_16
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+FLAC_ENC_LPC_16
+%endif
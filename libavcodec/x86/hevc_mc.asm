@@ -20,25 +20,23 @@
 ; */
 %include "libavutil/x86/x86util.asm"
 
-SECTION_RODATA 32
+SECTION_RODATA 64
+; 10-bit constants are wide enough for zmm operands
+pw_10:                  times 32 dw  (1 << 11)
+pw_bi_10:               times 32 dw  (1 << 10)
+max_pixels_10:          times 32 dw ((1 << 10)-1)
+pb_0:                   times 64 db 0
 cextern pw_255
 cextern pw_512
-cextern pw_2048
 cextern pw_8192
-cextern pw_1023
-cextern pw_1024
 cextern pw_4096
 %define pw_8 pw_512
-%define pw_10 pw_2048
 %define pw_12 pw_8192
-%define pw_bi_10 pw_1024
 %define pw_bi_12 pw_4096
 %define max_pixels_8 pw_255
-%define max_pixels_10 pw_1023
 pw_bi_8:                times 16 dw  (1 <<  8)
 max_pixels_12:          times 16 dw ((1 << 12)-1)
 cextern pd_1
-cextern pb_0
 
 %macro EPEL_TABLE 4
 hevc_epel_filters_%4_%1 times %2 d%3 -2, 58
@@ -116,6 +114,8 @@ SECTION .text
     movdqa            %3, [%2]                                              ; load data from source2
     movdqa            %4, [%2+16]                                           ; load data from source2
 %endif ; avx
+%elif mmsize == 64
+    movu              %3, [%2]
 %else ; %1 = 32
     mova              %3, [%2]
     mova              %4, [%2+32]
@@ -138,6 +138,18 @@ SECTION .text
 
 
 %macro EPEL_FILTER 5 ; bit depth, filter index, xmma, xmmb, gprtmp
+%if cpuflag(avx512)
+%ifdef PIC
+    lea              %5q, [hevc_epel_filters_sse4_%1]
+    %define FILTER %5q
+%else
+    %define FILTER hevc_epel_filters_sse4_%1
+%endif
+    sub              %2q, 1
+    shl              %2q, 5                      ; multiply by 32
+    vpbroadcastd      %3, [FILTER + %2q]         ; get 2 first values of filters
+    vpbroadcastd      %4, [FILTER + %2q+16]      ; get 2 last values of filters
+%else
 %if cpuflag(avx2)
 %assign %%offset 32
 %ifdef PIC
@@ -163,6 +175,7 @@ SECTION .text
 %endif
     mova           %3, [FILTER + %2q]        ; get 2 first values of filters
     mova           %4, [FILTER + %2q+%%offset]     ; get 2 last values of filters
+%endif ;cpuflag(avx512)
 %endmacro
 
 %macro EPEL_HV_FILTER 1
@@ -207,7 +220,11 @@ SECTION .text
 
 %macro QPEL_FILTER 2
 
-%if cpuflag(avx2)
+%if cpuflag(avx512)
+%assign %%offset 16
+%assign %%shift  6
+%define %%table  hevc_qpel_filters_sse4_%1
+%elif cpuflag(avx2)
 %assign %%offset 32
 %assign %%shift  7
 %define %%table  hevc_qpel_filters_avx2_%1
@@ -224,10 +241,17 @@ SECTION .text
 %endif
     sub              %2q, 1
     shl              %2q, %%shift                        ; multiply by 32
+%if cpuflag(avx512)
+    vpbroadcastd     m12, [rfilterq + %2q]               ; broadcast the coefficient pairs
+    vpbroadcastd     m13, [rfilterq + %2q +   %%offset]
+    vpbroadcastd     m14, [rfilterq + %2q + 2*%%offset]
+    vpbroadcastd     m15, [rfilterq + %2q + 3*%%offset]
+%else
     mova             m12, [rfilterq + %2q]               ; get 4 first values of filters
     mova             m13, [rfilterq + %2q +   %%offset]  ; get 4 first values of filters
     mova             m14, [rfilterq + %2q + 2*%%offset]  ; get 4 first values of filters
     mova             m15, [rfilterq + %2q + 3*%%offset]  ; get 4 first values of filters
+%endif
 %endmacro
 
 %macro EPEL_LOAD 4
@@ -413,8 +437,12 @@ SECTION .text
 %endmacro
 
 %macro PEL_10STORE32 3
+%if mmsize == 64
+    movu            [%1], %2
+%else
     PEL_10STORE16     %1, %2, %3
     movu         [%1+32], %3
+%endif
 %endmacro
 
 %macro PEL_8STORE2 3
@@ -662,7 +690,7 @@ SECTION .text
     packuswb          %3, %4
 %else
     CLIPW             %3, [pb_0], [max_pixels_%2]
-%if (%1 > 8 && notcpuflag(avx)) || %1 > 16
+%if %1 > 8 && notcpuflag(avx)
     CLIPW             %4, [pb_0], [max_pixels_%2]
 %endif
 %endif
@@ -1669,4 +1697,15 @@ HEVC_PUT_HEVC_QPEL 16, 10
 HEVC_PUT_HEVC_QPEL_HV 16, 10
 
 %endif ;AVX2
+
+%if HAVE_AVX512_EXTERNAL
+INIT_ZMM avx512
+
+HEVC_PUT_HEVC_PEL_PIXELS 32, 10
+
+HEVC_PUT_HEVC_EPEL 32, 10
+
+HEVC_PUT_HEVC_QPEL 32, 10
+
+%endif ;AVX512
 %endif ; ARCH_X86_64
@@ -70,7 +70,11 @@ SECTION .text
 %endif
 
 %if ARCH_X86_64
+%if mmsize > 32
+    SPLATW           m13, [pw_mask %+ %1]
+%else
     mova             m13, [pw_mask %+ %1]
+%endif
     pxor             m14, m14
 
 %else ; ARCH_X86_32
@@ -104,6 +108,20 @@ align 16
 %assign i 0
 %assign j 0
 %rep %3
+%if cpuflag(avx512)
+    movu              m8, [srcq + i]
+    psraw             m9, m8, %1-5
+    vpcmpeqw          k1, m9, m0
+    vpcmpeqw          k2, m9, m1
+    vpcmpeqw          k3, m9, m2
+    vpcmpeqw          k4, m9, m3
+    vpaddw        m8{k1}, m8, m4
+    vpaddw        m8{k2}, m8, m5
+    vpaddw        m8{k3}, m8, m6
+    vpaddw        m8{k4}, m8, m7
+    CLIPW             m8, m14, m13
+    movu      [dstq + i], m8
+%else
 %assign k 8+(j&1)
 %assign l 9-(j&1)
     mova          m %+ k, [srcq + i]
@@ -137,6 +155,7 @@ align 16
 %endif ; ARCH
     CLIPW             m %+ k, m14, m13
     mova      [dstq + i], m %+ k
+%endif
 %assign i i+mmsize
 %assign j j+1
 %endrep
@@ -185,6 +204,15 @@ HEVC_SAO_BAND_FILTER 12, 48, 3
 HEVC_SAO_BAND_FILTER 12, 64, 4
 %endif
 
+%if HAVE_AVX512_EXTERNAL && ARCH_X86_64
+INIT_ZMM avx512
+HEVC_SAO_BAND_FILTER 10, 32, 1
+HEVC_SAO_BAND_FILTER 10, 64, 2
+
+HEVC_SAO_BAND_FILTER 12, 32, 1
+HEVC_SAO_BAND_FILTER 12, 64, 2
+%endif
+
 ;******************************************************************************
 ;SAO Edge Filter
 ;******************************************************************************
@@ -229,6 +229,26 @@ PEL_PROTOTYPE(qpel_hv32,10, avx2);
 PEL_PROTOTYPE(qpel_hv48,10, avx2);
 PEL_PROTOTYPE(qpel_hv64,10, avx2);
 
+PEL_PROTOTYPE(pel_pixels32,10, avx512);
+PEL_PROTOTYPE(pel_pixels48,10, avx512);
+PEL_PROTOTYPE(pel_pixels64,10, avx512);
+
+PEL_PROTOTYPE(epel_h32,10, avx512);
+PEL_PROTOTYPE(epel_h48,10, avx512);
+PEL_PROTOTYPE(epel_h64,10, avx512);
+
+PEL_PROTOTYPE(epel_v32,10, avx512);
+PEL_PROTOTYPE(epel_v48,10, avx512);
+PEL_PROTOTYPE(epel_v64,10, avx512);
+
+PEL_PROTOTYPE(qpel_h32,10, avx512);
+PEL_PROTOTYPE(qpel_h48,10, avx512);
+PEL_PROTOTYPE(qpel_h64,10, avx512);
+
+PEL_PROTOTYPE(qpel_v32,10, avx512);
+PEL_PROTOTYPE(qpel_v48,10, avx512);
+PEL_PROTOTYPE(qpel_v64,10, avx512);
+
 WEIGHTING_PROTOTYPES(8, sse4);
 WEIGHTING_PROTOTYPES(10, sse4);
 WEIGHTING_PROTOTYPES(12, sse4);
@@ -256,4 +276,6 @@ void ff_hevc_add_residual_32_10_sse2(uint8_t *dst, int16_t *res, ptrdiff_t strid
 void ff_hevc_add_residual_16_10_avx2(uint8_t *dst, int16_t *res, ptrdiff_t stride);
 void ff_hevc_add_residual_32_10_avx2(uint8_t *dst, int16_t *res, ptrdiff_t stride);
 
+void ff_hevc_add_residual_32_10_avx512(uint8_t *dst, int16_t *res, ptrdiff_t stride);
+
 #endif // AVCODEC_X86_HEVCDSP_H
@@ -317,6 +317,25 @@ mc_rep_funcs(qpel_hv, 10, 32, 64, avx2)
 
 #endif //AVX2
 
+#if HAVE_AVX512_EXTERNAL
+
+mc_rep_mix_10(pel_pixels,   48, 32, 16, avx512, avx2, 64)
+mc_bi_rep_mix_10(pel_pixels,48, 32, 16, avx512, avx2, 64)
+mc_rep_mixs_10(epel_h ,     48, 32, 16, avx512, avx2, 64)
+mc_rep_mixs_10(epel_v ,     48, 32, 16, avx512, avx2, 64)
+mc_rep_mixs_10(qpel_h ,     48, 32, 16, avx512, avx2, 64)
+mc_rep_mixs_10(qpel_v ,     48, 32, 16, avx512, avx2, 64)
+
+mc_rep_func(pel_pixels, 10, 32, 64, avx512)
+mc_rep_bi_func(pel_pixels, 10, 32, 64, avx512)
+
+mc_rep_funcs(epel_h, 10, 32, 64, avx512)
+mc_rep_funcs(epel_v, 10, 32, 64, avx512)
+mc_rep_funcs(qpel_h, 10, 32, 64, avx512)
+mc_rep_funcs(qpel_v, 10, 32, 64, avx512)
+
+#endif //AVX512
+
 mc_rep_funcs(pel_pixels, 8, 16, 64, sse4)
 mc_rep_funcs(pel_pixels, 8, 16, 48, sse4)
 mc_rep_funcs(pel_pixels, 8, 16, 32, sse4)
@@ -651,6 +670,15 @@ SAO_BAND_FILTER_FUNCS(8,  avx2)
 SAO_BAND_FILTER_FUNCS(10, avx2)
 SAO_BAND_FILTER_FUNCS(12, avx2)
 
+void ff_hevc_sao_band_filter_32_10_avx512(uint8_t *_dst, uint8_t *_src, ptrdiff_t _stride_dst, ptrdiff_t _stride_src,
+                                          int16_t *sao_offset_val, int sao_left_class, int width, int height);
+void ff_hevc_sao_band_filter_64_10_avx512(uint8_t *_dst, uint8_t *_src, ptrdiff_t _stride_dst, ptrdiff_t _stride_src,
+                                          int16_t *sao_offset_val, int sao_left_class, int width, int height);
+void ff_hevc_sao_band_filter_32_12_avx512(uint8_t *_dst, uint8_t *_src, ptrdiff_t _stride_dst, ptrdiff_t _stride_src,
+                                          int16_t *sao_offset_val, int sao_left_class, int width, int height);
+void ff_hevc_sao_band_filter_64_12_avx512(uint8_t *_dst, uint8_t *_src, ptrdiff_t _stride_dst, ptrdiff_t _stride_src,
+                                          int16_t *sao_offset_val, int sao_left_class, int width, int height);
+
 #define SAO_BAND_INIT(bitd, opt) do {                                       \
     c->sao_band_filter[0]      = ff_hevc_sao_band_filter_8_##bitd##_##opt;  \
     c->sao_band_filter[1]      = ff_hevc_sao_band_filter_16_##bitd##_##opt; \
@@ -1095,6 +1123,76 @@ void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
             c->add_residual[2] = ff_hevc_add_residual_16_10_avx2;
             c->add_residual[3] = ff_hevc_add_residual_32_10_avx2;
         }
+        if (EXTERNAL_AVX512(cpu_flags)) {
+            if (ARCH_X86_64) {
+                c->put_hevc_epel[7][0][0] = ff_hevc_put_hevc_pel_pixels32_10_avx512;
+                c->put_hevc_epel[8][0][0] = ff_hevc_put_hevc_pel_pixels48_10_avx512;
+                c->put_hevc_epel[9][0][0] = ff_hevc_put_hevc_pel_pixels64_10_avx512;
+
+                c->put_hevc_qpel[7][0][0] = ff_hevc_put_hevc_pel_pixels32_10_avx512;
+                c->put_hevc_qpel[8][0][0] = ff_hevc_put_hevc_pel_pixels48_10_avx512;
+                c->put_hevc_qpel[9][0][0] = ff_hevc_put_hevc_pel_pixels64_10_avx512;
+
+                c->put_hevc_epel_bi[7][0][0] = ff_hevc_put_hevc_bi_pel_pixels32_10_avx512;
+                c->put_hevc_epel_bi[8][0][0] = ff_hevc_put_hevc_bi_pel_pixels48_10_avx512;
+                c->put_hevc_epel_bi[9][0][0] = ff_hevc_put_hevc_bi_pel_pixels64_10_avx512;
+                c->put_hevc_qpel_bi[7][0][0] = ff_hevc_put_hevc_bi_pel_pixels32_10_avx512;
+                c->put_hevc_qpel_bi[8][0][0] = ff_hevc_put_hevc_bi_pel_pixels48_10_avx512;
+                c->put_hevc_qpel_bi[9][0][0] = ff_hevc_put_hevc_bi_pel_pixels64_10_avx512;
+
+                c->put_hevc_epel[7][0][1] = ff_hevc_put_hevc_epel_h32_10_avx512;
+                c->put_hevc_epel[8][0][1] = ff_hevc_put_hevc_epel_h48_10_avx512;
+                c->put_hevc_epel[9][0][1] = ff_hevc_put_hevc_epel_h64_10_avx512;
+
+                c->put_hevc_epel_uni[7][0][1] = ff_hevc_put_hevc_uni_epel_h32_10_avx512;
+                c->put_hevc_epel_uni[8][0][1] = ff_hevc_put_hevc_uni_epel_h48_10_avx512;
+                c->put_hevc_epel_uni[9][0][1] = ff_hevc_put_hevc_uni_epel_h64_10_avx512;
+
+                c->put_hevc_epel_bi[7][0][1] = ff_hevc_put_hevc_bi_epel_h32_10_avx512;
+                c->put_hevc_epel_bi[8][0][1] = ff_hevc_put_hevc_bi_epel_h48_10_avx512;
+                c->put_hevc_epel_bi[9][0][1] = ff_hevc_put_hevc_bi_epel_h64_10_avx512;
+
+                c->put_hevc_epel[7][1][0] = ff_hevc_put_hevc_epel_v32_10_avx512;
+                c->put_hevc_epel[8][1][0] = ff_hevc_put_hevc_epel_v48_10_avx512;
+                c->put_hevc_epel[9][1][0] = ff_hevc_put_hevc_epel_v64_10_avx512;
+
+                c->put_hevc_epel_uni[7][1][0] = ff_hevc_put_hevc_uni_epel_v32_10_avx512;
+                c->put_hevc_epel_uni[8][1][0] = ff_hevc_put_hevc_uni_epel_v48_10_avx512;
+                c->put_hevc_epel_uni[9][1][0] = ff_hevc_put_hevc_uni_epel_v64_10_avx512;
+
+                c->put_hevc_epel_bi[7][1][0] = ff_hevc_put_hevc_bi_epel_v32_10_avx512;
+                c->put_hevc_epel_bi[8][1][0] = ff_hevc_put_hevc_bi_epel_v48_10_avx512;
+                c->put_hevc_epel_bi[9][1][0] = ff_hevc_put_hevc_bi_epel_v64_10_avx512;
+
+                c->put_hevc_qpel[7][0][1] = ff_hevc_put_hevc_qpel_h32_10_avx512;
+                c->put_hevc_qpel[8][0][1] = ff_hevc_put_hevc_qpel_h48_10_avx512;
+                c->put_hevc_qpel[9][0][1] = ff_hevc_put_hevc_qpel_h64_10_avx512;
+
+                c->put_hevc_qpel_uni[7][0][1] = ff_hevc_put_hevc_uni_qpel_h32_10_avx512;
+                c->put_hevc_qpel_uni[8][0][1] = ff_hevc_put_hevc_uni_qpel_h48_10_avx512;
+                c->put_hevc_qpel_uni[9][0][1] = ff_hevc_put_hevc_uni_qpel_h64_10_avx512;
+
+                c->put_hevc_qpel_bi[7][0][1] = ff_hevc_put_hevc_bi_qpel_h32_10_avx512;
+                c->put_hevc_qpel_bi[8][0][1] = ff_hevc_put_hevc_bi_qpel_h48_10_avx512;
+                c->put_hevc_qpel_bi[9][0][1] = ff_hevc_put_hevc_bi_qpel_h64_10_avx512;
+
+                c->put_hevc_qpel[7][1][0] = ff_hevc_put_hevc_qpel_v32_10_avx512;
+                c->put_hevc_qpel[8][1][0] = ff_hevc_put_hevc_qpel_v48_10_avx512;
+                c->put_hevc_qpel[9][1][0] = ff_hevc_put_hevc_qpel_v64_10_avx512;
+
+                c->put_hevc_qpel_uni[7][1][0] = ff_hevc_put_hevc_uni_qpel_v32_10_avx512;
+                c->put_hevc_qpel_uni[8][1][0] = ff_hevc_put_hevc_uni_qpel_v48_10_avx512;
+                c->put_hevc_qpel_uni[9][1][0] = ff_hevc_put_hevc_uni_qpel_v64_10_avx512;
+
+                c->put_hevc_qpel_bi[7][1][0] = ff_hevc_put_hevc_bi_qpel_v32_10_avx512;
+                c->put_hevc_qpel_bi[8][1][0] = ff_hevc_put_hevc_bi_qpel_v48_10_avx512;
+                c->put_hevc_qpel_bi[9][1][0] = ff_hevc_put_hevc_bi_qpel_v64_10_avx512;
+
+                c->sao_band_filter[2] = ff_hevc_sao_band_filter_32_10_avx512;
+                c->sao_band_filter[4] = ff_hevc_sao_band_filter_64_10_avx512;
+            }
+            c->add_residual[3] = ff_hevc_add_residual_32_10_avx512;
+        }
     } else if (bit_depth == 12) {
         if (EXTERNAL_MMXEXT(cpu_flags)) {
             c->idct_dc[0] = ff_hevc_idct_4x4_dc_12_mmxext;
@@ -1148,5 +1246,9 @@ void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
             SAO_BAND_INIT(12, avx2);
             SAO_EDGE_INIT(12, avx2);
         }
+        if (EXTERNAL_AVX512(cpu_flags) && ARCH_X86_64) {
+            c->sao_band_filter[2] = ff_hevc_sao_band_filter_32_12_avx512;
+            c->sao_band_filter[4] = ff_hevc_sao_band_filter_64_12_avx512;
+        }
     }
 }
@@ -20,27 +20,49 @@
 
 /**
  * @file
- * audio noise filter.
+ * audio automatic gain control filter.
  *
- * Based on af_aresample.c
+ * The signal is processed in blocks of 10 ms. A peak envelope with instant
+ * attack and exponential release is tracked over all channels and the gain
+ * is steered so that the envelope reaches targetDBFS. Gain reductions are
+ * applied within one block, increases are rate limited, and the gain is
+ * held while the input is below the noise gate. Gain changes are linearly
+ * ramped over each block.
  */
 
-#include "libavutil/avstring.h"
 #include "libavutil/channel_layout.h"
+#include "libavutil/common.h"
+#include "libavutil/ffmath.h"
 #include "libavutil/opt.h"
 #include "libavutil/samplefmt.h"
-#include "libavutil/avassert.h"
 #include "avfilter.h"
 #include "audio.h"
 #include "internal.h"
-#include "AGC_API.h"
+#include "af_agc.h"
+
+#define BLOCK_DURATION  0.01    ///< block length in seconds
+#define RELEASE_TIME    0.4     ///< envelope release time constant in seconds
+#define MAX_GAIN_DB     30.0    ///< maximum amplification
+#define MAX_RISE_DB     10.0    ///< maximum gain increase per second
+#define GATE_DB        -50.0    ///< gain is held below this level
 
 typedef struct AGCContext {
     const AVClass *class;
+    int targetDBFS;
+
     int channels;
     int sample_rate;
-    int targetDBFS;
-    void *l_handler;
+    int block_size;
+    float target;
+    float max_gain;
+    float max_rise;
+    float gate;
+    float release;
+
+    float envelope;
+    float gain;
+
+    AGCDSPContext dsp;
 } AGCContext;
 
 #define OFFSET(x) offsetof(AGCContext, x)
@@ -53,22 +75,141 @@ static const AVOption agc_options[] = {
 
 AVFILTER_DEFINE_CLASS(agc);
 
+static float peak_flt_c(const float *src, ptrdiff_t len)
+{
+    float peak = 0.f;
+
+    for (int i = 0; i < len; i++)
+        peak = FFMAX(peak, fabsf(src[i]));
+
+    return peak;
+}
+
+static int peak_s16_c(const int16_t *src, ptrdiff_t len)
+{
+    int max = 0, min = 0;
+
+    for (int i = 0; i < len; i++) {
+        max = FFMAX(max, src[i]);
+        min = FFMIN(min, src[i]);
+    }
+
+    return FFMAX(max, -min);
+}
+
+static void ramp_flt_c(float *dst, const float *src, ptrdiff_t len,
+                       float gain, float step)
+{
+    for (int i = 0; i < len; i++)
+        dst[i] = src[i] * (gain + (float)i * step);
+}
+
+static void ramp_s16_c(int16_t *dst, const int16_t *src, ptrdiff_t len,
+                       float gain, float step)
+{
+    for (int i = 0; i < len; i++)
+        dst[i] = av_clip_int16(lrintf(src[i] * (gain + (float)i * step)));
+}
+
+void ff_agc_init(AGCDSPContext *s)
+{
+    s->peak_flt = peak_flt_c;
+    s->peak_s16 = peak_s16_c;
+    s->ramp_flt = ramp_flt_c;
+    s->ramp_s16 = ramp_s16_c;
+
+    if (ARCH_X86)
+        ff_agc_init_x86(s);
+}
+
+static void setup(AVFilterContext *ctx, int channels, int sample_rate)
+{
+    AGCContext *s = ctx->priv;
+    double block_duration;
+
+    s->channels    = channels;
+    s->sample_rate = sample_rate;
+    s->block_size  = FFMAX(lrint(sample_rate * BLOCK_DURATION), 1);
+    block_duration = s->block_size / (double)sample_rate;
+
+    s->target   = ff_exp10(-FFMIN(s->targetDBFS, 100) / 20.);
+    s->max_gain = ff_exp10(MAX_GAIN_DB / 20.);
+    s->max_rise = ff_exp10(MAX_RISE_DB * block_duration / 20.);
+    s->gate     = ff_exp10(GATE_DB / 20.);
+    s->release  = exp(-block_duration / RELEASE_TIME);
+
+    s->envelope = 0.f;
+    s->gain     = 1.f;
+
+    av_log(ctx, AV_LOG_VERBOSE, "channels:%d sample_rate:%d block_size:%d target:%f\n",
+           channels, sample_rate, s->block_size, s->target);
+}
+
 static av_cold int init(AVFilterContext *ctx)
 {
     AGCContext *s = ctx->priv;
 
-    s->l_handler = NULL;
+    ff_agc_init(&s->dsp);
 
     return 0;
 }
 
-static av_cold void uninit(AVFilterContext *ctx)
+static int config_input(AVFilterLink *inlink)
 {
-    AGCContext *s = ctx->priv;
-    //clear resource
-    terminate_AGC_API(s->l_handler);
-    s->l_handler = NULL;
-    av_log(ctx, AV_LOG_INFO,"uninit agc resource success\n");
+    setup(inlink->dst, inlink->channels, inlink->sample_rate);
+
+    return 0;
+}
+
+static float block_peak(AGCContext *s, AVFrame *in, int offset, int len)
+{
+    const int body = len & ~15;
+    float peak = 0.f;
+
+    for (int ch = 0; ch < s->channels; ch++) {
+        if (in->format == AV_SAMPLE_FMT_FLTP) {
+            const float *src = (const float *)in->extended_data[ch] + offset;
+
+            if (body)
+                peak = FFMAX(peak, s->dsp.peak_flt(src, body));
+            peak = FFMAX(peak, peak_flt_c(src + body, len - body));
+        } else {
+            const int16_t *src = (const int16_t *)in->extended_data[ch] + offset;
+            int ipeak = 0;
+
+            if (body)
+                ipeak = s->dsp.peak_s16(src, body);
+            ipeak = FFMAX(ipeak, peak_s16_c(src + body, len - body));
+            peak  = FFMAX(peak, ipeak / 32768.f);
+        }
+    }
+
+    return peak;
+}
+
+static void block_ramp(AGCContext *s, AVFrame *out, AVFrame *in,
+                       int offset, int len, float gain, float step)
+{
+    const int body = len & ~15;
+    const float tail_gain = gain + (float)body * step;
+
+    for (int ch = 0; ch < s->channels; ch++) {
+        if (in->format == AV_SAMPLE_FMT_FLTP) {
+            const float *src = (const float *)in->extended_data[ch] + offset;
+            float *dst = (float *)out->extended_data[ch] + offset;
+
+            if (body)
+                s->dsp.ramp_flt(dst, src, body, gain, step);
+            ramp_flt_c(dst + body, src + body, len - body, tail_gain, step);
+        } else {
+            const int16_t *src = (const int16_t *)in->extended_data[ch] + offset;
+            int16_t *dst = (int16_t *)out->extended_data[ch] + offset;
+
+            if (body)
+                s->dsp.ramp_s16(dst, src, body, gain, step);
+            ramp_s16_c(dst + body, src + body, len - body, tail_gain, step);
+        }
+    }
 }
 
 static int filter_frame(AVFilterLink *inlink, AVFrame *in)
@@ -76,72 +217,57 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
     AVFilterContext *ctx = inlink->dst;
     AGCContext *s = ctx->priv;
     AVFilterLink *outlink = ctx->outputs[0];
-    AVFrame *out = NULL;
-    char *data;
-    int out_size, ret;
-
-    if (s->l_handler != NULL) {
-        if (s->channels != in->channels || s->sample_rate != in->sample_rate) {
-            terminate_AGC_API(s->l_handler);
-            s->l_handler = NULL;
-            av_log(ctx, AV_LOG_INFO,"channels or sample_rate change uninit agc\n");
+    AVFrame *out;
+
+    if (ctx->is_disabled)
+        return ff_filter_frame(outlink, in);
+
+    if (s->channels != in->channels || s->sample_rate != in->sample_rate)
+        setup(ctx, in->channels, in->sample_rate);
+
+    if (av_frame_is_writable(in)) {
+        out = in;
+    } else {
+        int ret;
+
+        out = ff_get_audio_buffer(outlink, in->nb_samples);
+        if (!out) {
+            av_frame_free(&in);
+            return AVERROR(ENOMEM);
+        }
+        ret = av_frame_copy_props(out, in);
+        if (ret < 0) {
+            av_frame_free(&in);
+            av_frame_free(&out);
+            return ret;
         }
     }
 
-    if (s->l_handler == NULL) {
-        av_log(ctx, AV_LOG_INFO,
-        "\n"
-        "config_input param is :\n"
-        "Input l_channel:    %d\n"
-        "Input l_sampleRate:   %d\n"
-        "Input l_targetDBFS:   %d\n",
-        in->channels,in->sample_rate,s->targetDBFS
-        );
-
-        s->channels = in->channels;
-        s->sample_rate = in->sample_rate;
-
-        s->l_handler = init_AGC_API(s->sample_rate, s->channels, s->targetDBFS);
-        if (s->l_handler == NULL) {
-            av_log(ctx, AV_LOG_INFO,"init agc resource failed\n");
-            return -1;
+    for (int offset = 0; offset < in->nb_samples; offset += s->block_size) {
+        const int len = FFMIN(s->block_size, in->nb_samples - offset);
+        float peak = block_peak(s, in, offset, len);
+        float gain = s->gain;
+
+        s->envelope = FFMAX(peak, s->envelope * s->release);
+        if (s->envelope > s->gate) {
+            gain = FFMIN(s->target / s->envelope, s->max_gain);
+            gain = FFMIN(gain, s->gain * s->max_rise);
         }
-        av_log(ctx, AV_LOG_INFO,"init agc resource success\n");
-    } 
-
-    data = (char*)runAGC_API(s->l_handler, in->data[0], in->nb_samples*s->channels, &out_size);
-    av_log(ctx, AV_LOG_DEBUG,
-           "\n"
-           "Input frameSize:    %d\n"
-           "output frameSize: %d\n",
-           in->nb_samples*s->channels,
-           out_size
-    );
-
-    out = ff_get_audio_buffer(outlink, out_size/s->channels);
-    if (!out) {
-        ret = AVERROR(ENOMEM);
-        goto fail;
-    }
-    ret = av_frame_copy_props(out, in);
-    if (ret < 0)
-        goto fail;
 
-    memcpy(out->data[0], data, out_size*sizeof(int16_t));
-    av_frame_free(&in);
+        block_ramp(s, out, in, offset, len, s->gain, (gain - s->gain) / len);
+        s->gain = gain;
+    }
 
+    if (out != in)
+        av_frame_free(&in);
     return ff_filter_frame(outlink, out);
-
-    fail:
-    av_frame_free(&in);
-    av_frame_free(&out);
-    return ret;
 }
 
 static const AVFilterPad agc_inputs[] = {
     {
         .name         = "default",
         .type         = AVMEDIA_TYPE_AUDIO,
+        .config_props = config_input,
         .filter_frame = filter_frame,
     },
 };
@@ -155,12 +281,12 @@ static const AVFilterPad agc_outputs[] = {
 
 const AVFilter ff_af_agc = {
     .name          = "agc",
-    .description   = NULL_IF_CONFIG_SMALL("audio agc."),
+    .description   = NULL_IF_CONFIG_SMALL("Apply automatic gain control."),
     .priv_size     = sizeof(AGCContext),
     .init          = init,
-    .uninit        = uninit,
     FILTER_INPUTS(agc_inputs),
     FILTER_OUTPUTS(agc_outputs),
+    FILTER_SAMPLEFMTS(AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_S16P),
     .priv_class    = &agc_class,
     .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL,
 };
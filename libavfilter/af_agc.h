@@ -0,0 +1,42 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_AGC_H
+#define AVFILTER_AGC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * All functions operate on len samples, len being a multiple of 16.
+ * The ramp functions scale sample i by (gain + i * step); dst may be
+ * equal to src.
+ */
+typedef struct AGCDSPContext {
+    float (*peak_flt)(const float *src, ptrdiff_t len);
+    int   (*peak_s16)(const int16_t *src, ptrdiff_t len);
+    void  (*ramp_flt)(float *dst, const float *src, ptrdiff_t len,
+                      float gain, float step);
+    void  (*ramp_s16)(int16_t *dst, const int16_t *src, ptrdiff_t len,
+                      float gain, float step);
+} AGCDSPContext;
+
+void ff_agc_init(AGCDSPContext *s);
+void ff_agc_init_x86(AGCDSPContext *s);
+
+#endif /* AVFILTER_AGC_H */
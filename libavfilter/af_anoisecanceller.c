@@ -25,13 +25,13 @@
  * Based on af_aresample.c
  */
 
-#include "libavutil/avstring.h"
 #include "libavutil/channel_layout.h"
-#include "libavutil/opt.h"
+#include "libavutil/common.h"
+#include "libavutil/mem.h"
 #include "libavutil/samplefmt.h"
-#include "libavutil/avassert.h"
 #include "avfilter.h"
 #include "audio.h"
+#include "filters.h"
 #include "internal.h"
 #include "NS_API.h"
 
@@ -40,28 +40,102 @@ typedef struct ANoiseCancellerContext {
 
     int channels;
     int sample_rate;
-    void *l_handler;
+    int block_size;         ///< native block size of the suppressor, 10 ms
+    void **handles;         ///< one mono suppressor instance per channel
+    int16_t *pad;           ///< zero padded blocks for the final partial block
+    int *job_ret;           ///< return values of the channel jobs
 } ANoiseCancellerContext;
 
-#define OFFSET(x) offsetof(ANoiseCancellerContext, x)
-#define A AV_OPT_FLAG_AUDIO_PARAM|AV_OPT_FLAG_FILTERING_PARAM
+typedef struct ThreadData {
+    AVFrame *in, *out;
+} ThreadData;
 
-static av_cold int init(AVFilterContext *ctx)
+static void free_handles(ANoiseCancellerContext *s)
 {
+    for (int ch = 0; ch < s->channels && s->handles; ch++)
+        terminate_NS_API(s->handles[ch]);
+    av_freep(&s->handles);
+    av_freep(&s->pad);
+    av_freep(&s->job_ret);
+    s->channels = 0;
+}
+
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    ANoiseCancellerContext *s = ctx->priv;
+
+    free_handles(s);
+}
+
+static int config_input(AVFilterLink *inlink)
+{
+    AVFilterContext *ctx = inlink->dst;
     ANoiseCancellerContext *s = ctx->priv;
 
-    s->l_handler = NULL;
+    free_handles(s);
+
+    if (inlink->sample_rate < 100) {
+        av_log(ctx, AV_LOG_ERROR, "Unsupported sample rate %d.\n",
+               inlink->sample_rate);
+        return AVERROR(EINVAL);
+    }
+
+    s->block_size = inlink->sample_rate / 100;
+    s->handles    = av_calloc(inlink->channels, sizeof(*s->handles));
+    s->pad        = av_calloc(inlink->channels, s->block_size * sizeof(*s->pad));
+    s->job_ret    = av_calloc(inlink->channels, sizeof(*s->job_ret));
+    if (!s->handles || !s->pad || !s->job_ret)
+        return AVERROR(ENOMEM);
+
+    for (s->channels = 0; s->channels < inlink->channels; s->channels++) {
+        s->handles[s->channels] = init_NS_API(1, inlink->sample_rate, kVeryHigh);
+        if (!s->handles[s->channels]) {
+            av_log(ctx, AV_LOG_ERROR, "Failed to create noise suppressor.\n");
+            return AVERROR_EXTERNAL;
+        }
+    }
+    s->sample_rate = inlink->sample_rate;
+
+    av_log(ctx, AV_LOG_VERBOSE, "channels:%d sample_rate:%d block_size:%d\n",
+           s->channels, s->sample_rate, s->block_size);
 
     return 0;
 }
 
-static av_cold void uninit(AVFilterContext *ctx)
+static int suppress_channels(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
     ANoiseCancellerContext *s = ctx->priv;
-    //clear resource
-    terminate_NS_API(s->l_handler);
-    s->l_handler = NULL;
-    av_log(ctx, AV_LOG_INFO,"uninit anoisecanceller resource success\n");
+    ThreadData *td = arg;
+    AVFrame *in = td->in;
+    AVFrame *out = td->out;
+    const int nb_samples = in->nb_samples;
+    const int start = (s->channels * jobnr) / nb_jobs;
+    const int end = (s->channels * (jobnr+1)) / nb_jobs;
+
+    for (int ch = start; ch < end; ch++) {
+        int16_t *src = (int16_t *)in->extended_data[ch];
+        int16_t *dst = (int16_t *)out->extended_data[ch];
+        int16_t *res;
+        int len = s->block_size;
+
+        if (nb_samples < s->block_size) {
+            int16_t *pad = s->pad + ch * s->block_size;
+
+            memcpy(pad, src, nb_samples * sizeof(*pad));
+            memset(pad + nb_samples, 0, (s->block_size - nb_samples) * sizeof(*pad));
+            src = pad;
+        }
+
+        /* a native size block must give a full block back */
+        res = runNS_API(s->handles[ch], src, s->block_size, &len);
+        if (!res || len < s->block_size) {
+            av_log(ctx, AV_LOG_ERROR, "Noise suppression failed on channel %d.\n", ch);
+            return AVERROR_EXTERNAL;
+        }
+        memcpy(dst, res, nb_samples * sizeof(*dst));
+    }
+
+    return 0;
 }
 
 static int filter_frame(AVFilterLink *inlink, AVFrame *in)
@@ -69,73 +143,75 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
     AVFilterContext *ctx = inlink->dst;
     ANoiseCancellerContext *s = ctx->priv;
     AVFilterLink *outlink = ctx->outputs[0];
-    AVFrame *out = NULL;
-    char *data;
-    int out_size, ret;
-
-    if (s->l_handler != NULL) {
-        if (s->channels != in->channels || s->sample_rate != in->sample_rate) {
-            terminate_NS_API(s->l_handler);
-            s->l_handler = NULL;
-            av_log(ctx, AV_LOG_INFO,"channels or sample_rate change uninit anoisecanceller\n");
+    AVFrame *out;
+    ThreadData td;
+    int nb_jobs = FFMIN(s->channels, ff_filter_get_nb_threads(ctx));
+
+    if (ctx->is_disabled)
+        return ff_filter_frame(outlink, in);
+
+    if (av_frame_is_writable(in)) {
+        out = in;
+    } else {
+        int ret;
+
+        out = ff_get_audio_buffer(outlink, in->nb_samples);
+        if (!out) {
+            av_frame_free(&in);
+            return AVERROR(ENOMEM);
+        }
+        ret = av_frame_copy_props(out, in);
+        if (ret < 0) {
+            av_frame_free(&in);
+            av_frame_free(&out);
+            return ret;
         }
     }
 
-    if (s->l_handler == NULL) {
-        av_log(ctx, AV_LOG_INFO,
-        "\n"
-        "config_input param is :\n"
-        "Input l_channel:    %d\n"
-        "Input l_sampleRate:   %d\n",
-        in->channels,in->sample_rate
-        );
-
-        s->channels = in->channels;
-        s->sample_rate = in->sample_rate;
-
-        s->l_handler = init_NS_API(s->channels, s->sample_rate, kVeryHigh);
-        if (s->l_handler == NULL) {
-            av_log(ctx, AV_LOG_INFO,"init anoisecanceller resource failed\n");
-            return -1;
+    td.in = in; td.out = out;
+    ff_filter_execute(ctx, suppress_channels, &td, s->job_ret, nb_jobs);
+
+    if (out != in)
+        av_frame_free(&in);
+    for (int i = 0; i < nb_jobs; i++) {
+        if (s->job_ret[i] < 0) {
+            int ret = s->job_ret[i];
+
+            av_frame_free(&out);
+            return ret;
         }
-        av_log(ctx, AV_LOG_INFO,"init anoisecanceller resource success\n");
-    } 
-
-
-    data = (char*)runNS_API(s->l_handler, in->data[0], in->nb_samples*s->channels, &out_size);
-    av_log(ctx, AV_LOG_DEBUG,
-           "\n"
-           "Input frameSize:    %d\n"
-           "output frameSize: %d\n",
-           in->nb_samples*s->channels,
-           out_size
-    );
-
-    out = ff_get_audio_buffer(outlink, out_size/s->channels);
-    if (!out) {
-        ret = AVERROR(ENOMEM);
-        goto fail;
     }
-    ret = av_frame_copy_props(out, in);
+    return ff_filter_frame(outlink, out);
+}
+
+static int activate(AVFilterContext *ctx)
+{
+    ANoiseCancellerContext *s = ctx->priv;
+    AVFilterLink *inlink = ctx->inputs[0];
+    AVFilterLink *outlink = ctx->outputs[0];
+    AVFrame *in = NULL;
+    int ret;
+
+    FF_FILTER_FORWARD_STATUS_BACK(outlink, inlink);
+
+    ret = ff_inlink_consume_samples(inlink, s->block_size, s->block_size, &in);
     if (ret < 0)
-        goto fail;
+        return ret;
 
-    memcpy(out->data[0], data, out_size*sizeof(int16_t));
-    av_frame_free(&in);
+    if (ret > 0)
+        return filter_frame(inlink, in);
 
-    return ff_filter_frame(outlink, out);
+    FF_FILTER_FORWARD_STATUS(inlink, outlink);
+    FF_FILTER_FORWARD_WANTED(outlink, inlink);
 
-    fail:
-    av_frame_free(&in);
-    av_frame_free(&out);
-    return ret;
+    return FFERROR_NOT_READY;
 }
 
 static const AVFilterPad anoisecanceller_inputs[] = {
     {
         .name         = "default",
         .type         = AVMEDIA_TYPE_AUDIO,
-        .filter_frame = filter_frame,
+        .config_props = config_input,
     },
 };
 
@@ -150,9 +226,11 @@ const AVFilter ff_af_anoisecanceller = {
     .name          = "anoisecanceller",
     .description   = NULL_IF_CONFIG_SMALL("audio noise canceller."),
     .priv_size     = sizeof(ANoiseCancellerContext),
-    .init          = init,
     .uninit        = uninit,
+    .activate      = activate,
     FILTER_INPUTS(anoisecanceller_inputs),
     FILTER_OUTPUTS(anoisecanceller_outputs),
-    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL,
+    FILTER_SINGLE_SAMPLEFMT(AV_SAMPLE_FMT_S16P),
+    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL |
+                     AVFILTER_FLAG_SLICE_THREADS,
 };
@@ -89,11 +89,17 @@ AVFrame *ff_get_audio_buffer(AVFilterLink *link, int nb_samples)
 {
     AVFrame *ret = NULL;
 
-    if (link->dstpad->get_buffer.audio)
+    if (link->dstpad->get_buffer.audio) {
+        link->dst->internal->in_get_buffer++;
         ret = link->dstpad->get_buffer.audio(link, nb_samples);
+        link->dst->internal->in_get_buffer--;
+    }
 
     if (!ret)
         ret = ff_default_get_audio_buffer(link, nb_samples);
 
+    if (ret)
+        ff_filter_profile_alloc(link->src, ret);
+
     return ret;
 }
@@ -33,6 +33,7 @@
 #include "libavutil/rational.h"
 #include "libavutil/samplefmt.h"
 #include "libavutil/thread.h"
+#include "libavutil/time.h"
 
 #define FF_INTERNAL_FIELDS 1
 #include "framequeue.h"
@@ -43,6 +44,7 @@
 #include "formats.h"
 #include "framepool.h"
 #include "internal.h"
+#include "thread.h"
 
 #include "libavutil/ffversion.h"
 const char av_filter_ffversion[] = "FFmpeg version " FFMPEG_VERSION;
@@ -210,6 +212,14 @@ void avfilter_link_free(AVFilterLink **link)
 
 void ff_filter_set_ready(AVFilterContext *filter, unsigned priority)
 {
+    AVFilterGraph *graph = filter->graph;
+
+    if (graph->internal->parallel_activation) {
+        ff_graph_frame_lock(graph);
+        filter->ready = FFMAX(filter->ready, priority);
+        ff_graph_frame_unlock(graph);
+        return;
+    }
     filter->ready = FFMAX(filter->ready, priority);
 }
 
@@ -219,10 +229,16 @@ void ff_filter_set_ready(AVFilterContext *filter, unsigned priority)
  */
 static void filter_unblock(AVFilterContext *filter)
 {
+    AVFilterGraph *graph = filter->graph;
+    int locked = graph->internal->parallel_activation;
     unsigned i;
 
+    if (locked)
+        ff_graph_frame_lock(graph);
     for (i = 0; i < filter->nb_outputs; i++)
         filter->outputs[i]->frame_blocked_in = 0;
+    if (locked)
+        ff_graph_frame_unlock(graph);
 }
 
 
@@ -545,8 +561,17 @@ void ff_update_link_current_pts(AVFilterLink *link, int64_t pts)
     link->current_pts = pts;
     link->current_pts_us = av_rescale_q(pts, link->time_base, AV_TIME_BASE_Q);
     /* TODO use duration */
-    if (link->graph && link->age_index >= 0)
-        ff_avfilter_graph_update_heap(link->graph, link);
+    if (link->graph && link->age_index >= 0) {
+        AVFilterGraph *graph = link->graph;
+        /* the sink heap is shared by all concurrently activated filters */
+        int locked = graph->internal->parallel_activation;
+
+        if (locked)
+            ff_graph_frame_lock(graph);
+        ff_avfilter_graph_update_heap(graph, link);
+        if (locked)
+            ff_graph_frame_unlock(graph);
+    }
 }
 
 int avfilter_process_command(AVFilterContext *filter, const char *cmd, const char *arg, char *res, int res_len, int flags)
@@ -1353,6 +1378,25 @@ static int ff_filter_activate_default(AVFilterContext *filter)
      [buffersrc1][testsrc1][buffersrc2][testsrc2]concat=v=2).
  */
 
+static int filter_activate_profiled(AVFilterContext *filter)
+{
+    AVFilterProfile *profile = &filter->internal->profile;
+    int64_t wall = av_gettime_relative();
+    int64_t cpu  = av_gettime_thread_cpu();
+    int ret;
+
+    ret = filter->filter->activate ? filter->filter->activate(filter) :
+          ff_filter_activate_default(filter);
+
+    profile->nb_activations++;
+    profile->wall_time += av_gettime_relative() - wall;
+    if (cpu >= 0 && profile->cpu_time >= 0)
+        profile->cpu_time += av_gettime_thread_cpu() - cpu;
+    else
+        profile->cpu_time = -1;
+    return ret;
+}
+
 int ff_filter_activate(AVFilterContext *filter)
 {
     int ret;
@@ -1361,13 +1405,44 @@ int ff_filter_activate(AVFilterContext *filter)
     av_assert1(!(filter->filter->flags & AVFILTER_FLAG_SUPPORT_TIMELINE_GENERIC &&
                  filter->filter->activate));
     filter->ready = 0;
-    ret = filter->filter->activate ? filter->filter->activate(filter) :
-          ff_filter_activate_default(filter);
+    if (filter->graph->profile)
+        ret = filter_activate_profiled(filter);
+    else
+        ret = filter->filter->activate ? filter->filter->activate(filter) :
+              ff_filter_activate_default(filter);
     if (ret == FFERROR_NOT_READY)
         ret = 0;
     return ret;
 }
 
+void ff_filter_profile_alloc(AVFilterContext *filter, const AVFrame *frame)
+{
+    AVFilterProfile *profile = &filter->internal->profile;
+
+    if (!filter->graph->profile || filter->internal->in_get_buffer)
+        return;
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(frame->buf) && frame->buf[i]; i++)
+        profile->bytes_allocated += frame->buf[i]->size;
+    for (int i = 0; i < frame->nb_extended_buf; i++)
+        profile->bytes_allocated += frame->extended_buf[i]->size;
+}
+
+const AVFilterProfile *avfilter_get_profile(AVFilterContext *filter)
+{
+    AVFilterProfile *profile = &filter->internal->profile;
+
+    profile->frames_in = profile->frames_out = 0;
+    for (unsigned i = 0; i < filter->nb_inputs; i++)
+        if (filter->inputs[i])
+            profile->frames_in += filter->inputs[i]->frame_count_out;
+    for (unsigned i = 0; i < filter->nb_outputs; i++)
+        if (filter->outputs[i])
+            profile->frames_out += filter->outputs[i]->frame_count_in;
+
+    return profile;
+}
+
 int ff_inlink_acknowledge_status(AVFilterLink *link, int *rstatus, int64_t *rpts)
 {
     *rpts = link->current_pts;
@@ -1541,10 +1616,19 @@ void ff_inlink_request_frame(AVFilterLink *link)
 
 void ff_inlink_set_status(AVFilterLink *link, int status)
 {
+    AVFilterGraph *graph = link->dst->graph;
+
     if (link->status_out)
         return;
     link->frame_wanted_out = 0;
-    link->frame_blocked_in = 0;
+    /* may be cleared concurrently by filter_unblock() on the source */
+    if (graph->internal->parallel_activation) {
+        ff_graph_frame_lock(graph);
+        link->frame_blocked_in = 0;
+        ff_graph_frame_unlock(graph);
+    } else {
+        link->frame_blocked_in = 0;
+    }
     ff_avfilter_link_set_out_status(link, status, AV_NOPTS_VALUE);
     while (ff_framequeue_queued_frames(&link->fifo)) {
            AVFrame *frame = ff_framequeue_take(&link->fifo);
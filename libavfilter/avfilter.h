@@ -396,6 +396,13 @@ unsigned avfilter_filter_pad_count(const AVFilter *filter, int is_output);
  */
 #define AVFILTER_THREAD_SLICE (1 << 0)
 
+/**
+ * Activate independent filters of the graph concurrently, e.g. the branches
+ * following a split filter. Only meaningful for AVFilterGraph.thread_type,
+ * and never enabled by default.
+ */
+#define AVFILTER_THREAD_FRAME (1 << 1)
+
 typedef struct AVFilterInternal AVFilterInternal;
 
 /** An instance of a filter */
@@ -745,6 +752,59 @@ int avfilter_config_links(AVFilterContext *filter);
  */
 int avfilter_process_command(AVFilterContext *filter, const char *cmd, const char *arg, char *res, int res_len, int flags);
 
+/**
+ * Profiling counters of a filter instance.
+ *
+ * The counters are only collected while the profile field of the graph
+ * containing the filter is set.
+ */
+typedef struct AVFilterProfile {
+    /**
+     * Number of times the filter was activated.
+     */
+    uint64_t nb_activations;
+
+    /**
+     * Wall clock time spent in the filter, in microseconds.
+     */
+    int64_t wall_time;
+
+    /**
+     * CPU time spent in the filter by the threads activating it, in
+     * microseconds. Time spent in the slice threads of the filter is not
+     * included. Negative if not available on this platform.
+     */
+    int64_t cpu_time;
+
+    /**
+     * Number of frames consumed from all inputs of the filter.
+     */
+    uint64_t frames_in;
+
+    /**
+     * Number of frames sent on all outputs of the filter.
+     */
+    uint64_t frames_out;
+
+    /**
+     * Total size in bytes of the frame buffers the filter requested for its
+     * outputs, including the ones reused from a buffer pool. Buffers that
+     * pass-through filters downstream allocate on its behalf are included.
+     */
+    uint64_t bytes_allocated;
+} AVFilterProfile;
+
+/**
+ * Get the profiling counters of a filter instance.
+ *
+ * This must not be called while the graph containing the filter is
+ * processing frames.
+ *
+ * @return the counters, valid until the next call to this function for the
+ *         same filter or until the filter is freed
+ */
+const AVFilterProfile *avfilter_get_profile(AVFilterContext *filter);
+
 /**
  * Iterate over all registered filters.
  *
@@ -876,6 +936,10 @@ typedef struct AVFilterGraph {
      * bit AND with AVFilterContext.thread_type to get the final mask used for
      * determining allowed threading types. I.e. a threading type needs to be
      * set in both to be allowed.
+     *
+     * AVFILTER_THREAD_FRAME applies to the graph as a whole: it must be set
+     * before adding any filters to the graph and is not combined with
+     * AVFilterContext.thread_type.
      */
     int thread_type;
 
@@ -914,6 +978,15 @@ typedef struct AVFilterGraph {
 
     char *aresample_swr_opts; ///< swr options to use for the auto-inserted aresample filters, Access ONLY through AVOptions
 
+    /**
+     * If nonzero, collect the profiling counters returned by
+     * avfilter_get_profile() for all filters of the graph.
+     * Profiling adds clock reads around every filter activation.
+     *
+     * May be set by the caller before processing any frames.
+     */
+    int profile;
+
     /**
      * Private fields
      *
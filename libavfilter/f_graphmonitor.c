@@ -411,6 +411,7 @@ const AVFilter ff_vf_graphmonitor = {
     .priv_size     = sizeof(GraphMonitorContext),
     .priv_class    = &graphmonitor_class,
     .activate      = activate,
+    .flags_internal = FF_FILTER_FLAG_GRAPH_EXCLUSIVE,
     FILTER_INPUTS(graphmonitor_inputs),
     FILTER_OUTPUTS(graphmonitor_outputs),
     FILTER_QUERY_FUNC(query_formats),
@@ -441,6 +442,7 @@ const AVFilter ff_avf_agraphmonitor = {
     .priv_class    = &graphmonitor_class,
     .priv_size     = sizeof(GraphMonitorContext),
     .activate      = activate,
+    .flags_internal = FF_FILTER_FLAG_GRAPH_EXCLUSIVE,
     FILTER_INPUTS(agraphmonitor_inputs),
     FILTER_OUTPUTS(agraphmonitor_outputs),
     FILTER_QUERY_FUNC(query_formats),
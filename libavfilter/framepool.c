@@ -45,9 +45,17 @@ struct FFFramePool {
     int align;
     int linesize[4];
     AVBufferPool *pools[4];
+    AVBufferRef* (*alloc)(size_t size);
 
 };
 
+static AVBufferRef *frame_pool_alloc_buffer(void *opaque, size_t size)
+{
+    FFFramePool *pool = opaque;
+
+    return pool->alloc ? pool->alloc(size) : av_buffer_alloc(size);
+}
+
 FFFramePool *ff_frame_pool_video_init(AVBufferRef* (*alloc)(size_t size),
                                       int width,
                                       int height,
@@ -70,6 +78,7 @@ FFFramePool *ff_frame_pool_video_init(AVBufferRef* (*alloc)(size_t size),
     pool->height = height;
     pool->format = format;
     pool->align = align;
+    pool->alloc = alloc;
 
     if ((ret = av_image_check_size2(width, height, INT64_MAX, format, 0, NULL)) < 0) {
         goto fail;
@@ -96,14 +105,17 @@ FFFramePool *ff_frame_pool_video_init(AVBufferRef* (*alloc)(size_t size),
         if (i == 1 || i == 2)
             h = AV_CEIL_RSHIFT(h, desc->log2_chroma_h);
 
-        pool->pools[i] = av_buffer_pool_init(pool->linesize[i] * h + 16 + 16 - 1,
-                                             alloc);
+        pool->pools[i] = av_buffer_pool_init3(pool->linesize[i] * h + 16 + 16 - 1,
+                                              pool, frame_pool_alloc_buffer, NULL,
+                                              AV_BUFFER_POOL_FLAG_LOCKLESS);
         if (!pool->pools[i])
             goto fail;
     }
 
     if (desc->flags & AV_PIX_FMT_FLAG_PAL) {
-        pool->pools[1] = av_buffer_pool_init(AVPALETTE_SIZE, alloc);
+        pool->pools[1] = av_buffer_pool_init3(AVPALETTE_SIZE, pool,
+                                              frame_pool_alloc_buffer, NULL,
+                                              AV_BUFFER_POOL_FLAG_LOCKLESS);
         if (!pool->pools[1])
             goto fail;
     }
@@ -142,7 +154,8 @@ FFFramePool *ff_frame_pool_audio_init(AVBufferRef* (*alloc)(size_t size),
     if (ret < 0)
         goto fail;
 
-    pool->pools[0] = av_buffer_pool_init(pool->linesize[0], NULL);
+    pool->pools[0] = av_buffer_pool_init3(pool->linesize[0], NULL, NULL, NULL,
+                                          AV_BUFFER_POOL_FLAG_LOCKLESS);
     if (!pool->pools[0])
         goto fail;
 
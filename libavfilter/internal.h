@@ -134,12 +134,41 @@ struct AVFilterGraphInternal {
     void *thread;
     avfilter_execute_func *thread_execute;
     FFFrameQueueGlobal frame_queues;
+
+    void *frame_thread;
+    /**
+     * Set while several filters are being activated concurrently. The state
+     * that neighbouring filters share (ready, frame_blocked_in) must then only
+     * be modified with ff_graph_frame_lock() held.
+     */
+    int parallel_activation;
 };
 
 struct AVFilterInternal {
     avfilter_execute_func *execute;
+
+    /**
+     * Last frame threading round in which this filter or one of its
+     * neighbours was scheduled for activation.
+     */
+    unsigned wave;
+
+    AVFilterProfile profile;
+
+    /**
+     * Nonzero while a get_buffer callback of one of the inputs runs. Buffers
+     * such a callback requests on the outputs are accounted to the filter
+     * upstream instead.
+     */
+    unsigned in_get_buffer;
 };
 
+/**
+ * Account the buffers of a frame requested on an output of the filter to
+ * its profiling counters.
+ */
+void ff_filter_profile_alloc(AVFilterContext *filter, const AVFrame *frame);
+
 static av_always_inline int ff_filter_execute(AVFilterContext *ctx, avfilter_action_func *func,
                                               void *arg, int *ret, int nb_jobs)
 {
@@ -370,6 +399,12 @@ void ff_filter_graph_remove_filter(AVFilterGraph *graph, AVFilterContext *filter
  */
 #define FF_FILTER_FLAG_HWFRAME_AWARE (1 << 0)
 
+/**
+ * The filter accesses other filters of the graph than its direct neighbours,
+ * so it must never be activated concurrently with any other filter.
+ */
+#define FF_FILTER_FLAG_GRAPH_EXCLUSIVE (1 << 1)
+
 /**
  * Run one round of processing on a filter graph.
  */
@@ -37,12 +37,28 @@ typedef struct ThreadContext {
     AVSliceThread *thread;
     avfilter_action_func *func;
 
+    /* serializes execute() calls from concurrently activated filters */
+    pthread_mutex_t lock;
+
     /* per-execute parameters */
     AVFilterContext *ctx;
     void *arg;
     int   *rets;
 } ThreadContext;
 
+typedef struct FrameThreadContext {
+    AVSliceThread *thread;
+    int nb_threads;
+
+    /* protects the state shared between neighbouring filters */
+    pthread_mutex_t lock;
+
+    /* current round of activations */
+    unsigned wave;
+    AVFilterContext **filters;
+    int *rets;
+} FrameThreadContext;
+
 static void worker_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
 {
     ThreadContext *c = priv;
@@ -54,6 +70,7 @@ static void worker_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb
 static void slice_thread_uninit(ThreadContext *c)
 {
     avpriv_slicethread_free(&c->thread);
+    pthread_mutex_destroy(&c->lock);
 }
 
 static int thread_execute(AVFilterContext *ctx, avfilter_action_func *func,
@@ -63,21 +80,153 @@ static int thread_execute(AVFilterContext *ctx, avfilter_action_func *func,
 
     if (nb_jobs <= 0)
         return 0;
+    pthread_mutex_lock(&c->lock);
     c->ctx         = ctx;
     c->arg         = arg;
     c->func        = func;
     c->rets        = ret;
 
     avpriv_slicethread_execute(c->thread, nb_jobs, 0);
+    pthread_mutex_unlock(&c->lock);
     return 0;
 }
 
 static int thread_init_internal(ThreadContext *c, int nb_threads)
 {
+    int ret;
+
     nb_threads = avpriv_slicethread_create(&c->thread, c, worker_func, NULL, nb_threads);
-    if (nb_threads <= 1)
+    if (nb_threads <= 1) {
+        avpriv_slicethread_free(&c->thread);
+        return FFMAX(nb_threads, 1);
+    }
+    if ((ret = pthread_mutex_init(&c->lock, NULL))) {
+        avpriv_slicethread_free(&c->thread);
+        return AVERROR(ret);
+    }
+    return nb_threads;
+}
+
+static void frame_worker_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
+{
+    FrameThreadContext *c = priv;
+    c->rets[jobnr] = ff_filter_activate(c->filters[jobnr]);
+}
+
+static void frame_thread_free(AVFilterGraph *graph)
+{
+    FrameThreadContext *c = graph->internal->frame_thread;
+
+    if (!c)
+        return;
+    avpriv_slicethread_free(&c->thread);
+    pthread_mutex_destroy(&c->lock);
+    av_freep(&c->filters);
+    av_freep(&c->rets);
+    av_freep(&graph->internal->frame_thread);
+}
+
+static int frame_thread_init(AVFilterGraph *graph)
+{
+    FrameThreadContext *c;
+    int ret;
+
+    c = graph->internal->frame_thread = av_mallocz(sizeof(*c));
+    if (!c)
+        return AVERROR(ENOMEM);
+
+    ret = avpriv_slicethread_create(&c->thread, c, frame_worker_func, NULL,
+                                    graph->nb_threads);
+    if (ret <= 1) {
+        avpriv_slicethread_free(&c->thread);
+        av_freep(&graph->internal->frame_thread);
+        graph->thread_type &= ~AVFILTER_THREAD_FRAME;
+        return 0;
+    }
+    c->nb_threads = ret;
+
+    c->filters = av_calloc(c->nb_threads, sizeof(*c->filters));
+    c->rets    = av_calloc(c->nb_threads, sizeof(*c->rets));
+    if (!c->filters || !c->rets) {
+        avpriv_slicethread_free(&c->thread);
+        av_freep(&c->filters);
+        av_freep(&c->rets);
+        av_freep(&graph->internal->frame_thread);
+        return AVERROR(ENOMEM);
+    }
+    if ((ret = pthread_mutex_init(&c->lock, NULL))) {
         avpriv_slicethread_free(&c->thread);
-    return FFMAX(nb_threads, 1);
+        av_freep(&c->filters);
+        av_freep(&c->rets);
+        av_freep(&graph->internal->frame_thread);
+        return AVERROR(ret);
+    }
+
+    return 0;
+}
+
+static void claim_filter(AVFilterContext *filter, unsigned wave)
+{
+    unsigned i;
+
+    filter->internal->wave = wave;
+    for (i = 0; i < filter->nb_inputs; i++)
+        filter->inputs[i]->src->internal->wave = wave;
+    for (i = 0; i < filter->nb_outputs; i++)
+        filter->outputs[i]->dst->internal->wave = wave;
+}
+
+int ff_graph_activate_concurrently(AVFilterGraph *graph, AVFilterContext *filter)
+{
+    FrameThreadContext *c = graph->internal->frame_thread;
+    int i, nb_filters = 0;
+
+    /*
+     * Filters activated together must not be linked to each other: a filter
+     * only ever modifies its own state, its links, and the ready and
+     * frame_blocked_in fields of its neighbours, the latter under the lock.
+     * Only filters as urgent as the first one are picked, to keep the
+     * priorities of the serial scheduling.
+     */
+    c->wave++;
+    claim_filter(filter, c->wave);
+    c->filters[nb_filters++] = filter;
+
+    if (!(filter->filter->flags_internal & FF_FILTER_FLAG_GRAPH_EXCLUSIVE)) {
+        for (i = 0; i < graph->nb_filters && nb_filters < c->nb_threads; i++) {
+            AVFilterContext *f = graph->filters[i];
+
+            if (f->ready != filter->ready || f->internal->wave == c->wave ||
+                f->filter->flags_internal & FF_FILTER_FLAG_GRAPH_EXCLUSIVE)
+                continue;
+            claim_filter(f, c->wave);
+            c->filters[nb_filters++] = f;
+        }
+    }
+
+    if (nb_filters == 1)
+        return ff_filter_activate(filter);
+
+    graph->internal->parallel_activation = 1;
+    avpriv_slicethread_execute(c->thread, nb_filters, 0);
+    graph->internal->parallel_activation = 0;
+
+    for (i = 0; i < nb_filters; i++)
+        if (c->rets[i] < 0)
+            return c->rets[i];
+    return c->rets[0];
+}
+
+void ff_graph_frame_lock(AVFilterGraph *graph)
+{
+    FrameThreadContext *c = graph->internal->frame_thread;
+    pthread_mutex_lock(&c->lock);
+}
+
+void ff_graph_frame_unlock(AVFilterGraph *graph)
+{
+    FrameThreadContext *c = graph->internal->frame_thread;
+    pthread_mutex_unlock(&c->lock);
 }
 
 int ff_graph_thread_init(AVFilterGraph *graph)
@@ -104,11 +253,15 @@ int ff_graph_thread_init(AVFilterGraph *graph)
 
     graph->internal->thread_execute = thread_execute;
 
+    if (graph->thread_type & AVFILTER_THREAD_FRAME)
+        return frame_thread_init(graph);
+
     return 0;
 }
 
 void ff_graph_thread_free(AVFilterGraph *graph)
 {
+    frame_thread_free(graph);
     if (graph->internal->thread)
         slice_thread_uninit(graph->internal->thread);
     av_freep(&graph->internal->thread);
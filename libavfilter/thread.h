@@ -25,4 +25,21 @@ int ff_graph_thread_init(AVFilterGraph *graph);
 
 void ff_graph_thread_free(AVFilterGraph *graph);
 
+/**
+ * Activate filter, the first ready filter of the graph, together with all
+ * other filters of the same readiness that can safely be run concurrently
+ * with it. Only used when AVFILTER_THREAD_FRAME is enabled.
+ *
+ * @return the first error returned by one of the filters, or the return
+ *         value of the activation of filter otherwise
+ */
+int ff_graph_activate_concurrently(AVFilterGraph *graph, AVFilterContext *filter);
+
+/**
+ * Lock and unlock the state shared between neighbouring filters while
+ * AVFilterGraphInternal.parallel_activation is set.
+ */
+void ff_graph_frame_lock(AVFilterGraph *graph);
+void ff_graph_frame_unlock(AVFilterGraph *graph);
+
 #endif /* AVFILTER_THREAD_H */
@@ -0,0 +1,439 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * scale the input video to several sizes at once
+ */
+
+#include "libavutil/avstring.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/parseutils.h"
+#include "libavutil/pixdesc.h"
+#include "libswscale/swscale.h"
+
+#include "avfilter.h"
+#include "filters.h"
+#include "formats.h"
+#include "internal.h"
+#include "video.h"
+
+typedef struct Rendition {
+    int w, h;
+    struct SwsContext *sws;
+    int source;                 ///< rendition scaled from, -1 for the input
+    enum AVColorRange range;    ///< range of the output
+} Rendition;
+
+typedef struct ScaleLadderContext {
+    const AVClass *class;
+    char *sizes_str;
+    char *flags_str;
+    int cascade;
+
+    int flags;
+    Rendition *renditions;
+    int nb_renditions;
+    int *order;                 ///< renditions by decreasing area
+
+    /* input properties the contexts were set up for */
+    int in_w, in_h, in_format;
+    enum AVColorSpace in_colorspace;
+    enum AVColorRange in_range;
+
+    AVFrame **out;              ///< frames being produced, one per rendition
+    /* scratch arrays for sws_scale_frame_multi() */
+    struct SwsContext **multi_sws;
+    AVFrame **multi_dst;
+} ScaleLadderContext;
+
+static int config_output(AVFilterLink *outlink)
+{
+    AVFilterContext *ctx = outlink->src;
+    ScaleLadderContext *s = ctx->priv;
+    AVFilterLink *inlink = ctx->inputs[0];
+    const Rendition *r = &s->renditions[FF_OUTLINK_IDX(outlink)];
+
+    outlink->w = r->w;
+    outlink->h = r->h;
+
+    if (inlink->sample_aspect_ratio.num)
+        outlink->sample_aspect_ratio = av_mul_q((AVRational){ outlink->h * inlink->w,
+                                                              outlink->w * inlink->h },
+                                                inlink->sample_aspect_ratio);
+    else
+        outlink->sample_aspect_ratio = inlink->sample_aspect_ratio;
+
+    return 0;
+}
+
+static av_cold int init(AVFilterContext *ctx)
+{
+    ScaleLadderContext *s = ctx->priv;
+    const AVClass *class = sws_get_class();
+    const AVOption *o = av_opt_find(&class, "sws_flags", NULL, 0,
+                                    AV_OPT_SEARCH_FAKE_OBJ);
+    char *sizes, *p, *saveptr = NULL;
+    int ret = 0;
+
+    if (!s->sizes_str || !*s->sizes_str) {
+        av_log(ctx, AV_LOG_ERROR, "No output sizes specified\n");
+        return AVERROR(EINVAL);
+    }
+
+    if (s->flags_str && *s->flags_str) {
+        ret = av_opt_eval_flags(&class, o, s->flags_str, &s->flags);
+        if (ret < 0)
+            return ret;
+    }
+
+    sizes = av_strdup(s->sizes_str);
+    if (!sizes)
+        return AVERROR(ENOMEM);
+
+    for (p = av_strtok(sizes, "|", &saveptr); p; p = av_strtok(NULL, "|", &saveptr)) {
+        AVFilterPad pad = { 0 };
+        Rendition *r;
+
+        r = av_realloc_array(s->renditions, s->nb_renditions + 1, sizeof(*r));
+        if (!r) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        s->renditions = r;
+        r = &s->renditions[s->nb_renditions];
+        memset(r, 0, sizeof(*r));
+        r->source = -1;
+
+        ret = av_parse_video_size(&r->w, &r->h, p);
+        if (ret < 0) {
+            av_log(ctx, AV_LOG_ERROR, "Invalid size '%s'\n", p);
+            goto end;
+        }
+        s->nb_renditions++;
+
+        pad.type         = AVMEDIA_TYPE_VIDEO;
+        pad.config_props = config_output;
+        pad.name = av_asprintf("output%d", s->nb_renditions - 1);
+        if (!pad.name) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        if ((ret = ff_append_outpad_free_name(ctx, &pad)) < 0)
+            goto end;
+    }
+
+    if (!s->nb_renditions) {
+        av_log(ctx, AV_LOG_ERROR, "No output sizes specified\n");
+        ret = AVERROR(EINVAL);
+        goto end;
+    }
+
+    s->order     = av_calloc(s->nb_renditions, sizeof(*s->order));
+    s->multi_sws = av_calloc(s->nb_renditions, sizeof(*s->multi_sws));
+    s->multi_dst = av_calloc(s->nb_renditions, sizeof(*s->multi_dst));
+    s->out       = av_calloc(s->nb_renditions, sizeof(*s->out));
+    if (!s->order || !s->multi_sws || !s->multi_dst || !s->out) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    /* stable insertion sort, the largest renditions come first */
+    for (int i = 0; i < s->nb_renditions; i++) {
+        int64_t area = (int64_t)s->renditions[i].w * s->renditions[i].h;
+        int j = i;
+
+        while (j > 0 && (int64_t)s->renditions[s->order[j - 1]].w *
+                                 s->renditions[s->order[j - 1]].h < area) {
+            s->order[j] = s->order[j - 1];
+            j--;
+        }
+        s->order[j] = i;
+    }
+
+end:
+    av_free(sizes);
+    return ret;
+}
+
+static void free_contexts(ScaleLadderContext *s)
+{
+    for (int i = 0; i < s->nb_renditions; i++) {
+        sws_freeContext(s->renditions[i].sws);
+        s->renditions[i].sws    = NULL;
+        s->renditions[i].source = -1;
+    }
+}
+
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    ScaleLadderContext *s = ctx->priv;
+
+    if (s->renditions)
+        free_contexts(s);
+    av_freep(&s->renditions);
+    av_freep(&s->order);
+    av_freep(&s->multi_sws);
+    av_freep(&s->multi_dst);
+    av_freep(&s->out);
+}
+
+static int query_formats(AVFilterContext *ctx)
+{
+    const AVPixFmtDescriptor *desc = NULL;
+    AVFilterFormats *formats = NULL;
+    int ret;
+
+    while ((desc = av_pix_fmt_desc_next(desc))) {
+        enum AVPixelFormat pix_fmt = av_pix_fmt_desc_get_id(desc);
+        if (sws_isSupportedInput(pix_fmt) &&
+            (ret = ff_add_format(&formats, pix_fmt)) < 0)
+            return ret;
+    }
+    if ((ret = ff_formats_ref(formats, &ctx->inputs[0]->outcfg.formats)) < 0)
+        return ret;
+
+    for (int i = 0; i < ctx->nb_outputs; i++) {
+        desc    = NULL;
+        formats = NULL;
+        while ((desc = av_pix_fmt_desc_next(desc))) {
+            enum AVPixelFormat pix_fmt = av_pix_fmt_desc_get_id(desc);
+            if (sws_isSupportedOutput(pix_fmt) &&
+                (ret = ff_add_format(&formats, pix_fmt)) < 0)
+                return ret;
+        }
+        if ((ret = ff_formats_ref(formats, &ctx->outputs[i]->incfg.formats)) < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static int alloc_context(AVFilterContext *ctx, Rendition *r,
+                         int src_w, int src_h, enum AVPixelFormat src_format,
+                         enum AVColorRange src_range, enum AVPixelFormat dst_format)
+{
+    ScaleLadderContext *s = ctx->priv;
+    enum AVColorSpace colorspace = s->in_colorspace;
+    int in_full, out_full, brightness, contrast, saturation;
+    int *inv_table, *table;
+    struct SwsContext *sws;
+    int ret;
+
+    sws = r->sws = sws_alloc_context();
+    if (!sws)
+        return AVERROR(ENOMEM);
+
+    av_opt_set_int(sws, "srcw", src_w, 0);
+    av_opt_set_int(sws, "srch", src_h, 0);
+    av_opt_set_int(sws, "src_format", src_format, 0);
+    av_opt_set_int(sws, "dstw", r->w, 0);
+    av_opt_set_int(sws, "dsth", r->h, 0);
+    av_opt_set_int(sws, "dst_format", dst_format, 0);
+    av_opt_set_int(sws, "sws_flags", s->flags, 0);
+    /* MPEG-2 chroma positions for YUV420P, as the scale filter uses them */
+    if (src_format == AV_PIX_FMT_YUV420P)
+        av_opt_set_int(sws, "src_v_chr_pos", 128, 0);
+    if (dst_format == AV_PIX_FMT_YUV420P)
+        av_opt_set_int(sws, "dst_v_chr_pos", 128, 0);
+
+    if ((ret = sws_init_context(sws, NULL, NULL)) < 0)
+        return ret;
+
+    /* Set up the colorspace details as the scale filter does by default:
+     * keep the input matrix and take the input range from the frame, but
+     * leave the output range to libswscale. */
+    if (colorspace < 1 || colorspace > 10 || colorspace == 8)
+        colorspace = AVCOL_SPC_BT470BG;
+
+    sws_getColorspaceDetails(sws, &inv_table, &in_full, &table, &out_full,
+                             &brightness, &contrast, &saturation);
+    inv_table = table = (int *)sws_getCoefficients(colorspace);
+    if (src_range != AVCOL_RANGE_UNSPECIFIED)
+        in_full = src_range == AVCOL_RANGE_JPEG;
+    sws_setColorspaceDetails(sws, inv_table, in_full, table, out_full,
+                             brightness, contrast, saturation);
+    r->range = out_full ? AVCOL_RANGE_JPEG : AVCOL_RANGE_MPEG;
+
+    return 0;
+}
+
+static int init_contexts(AVFilterContext *ctx, const AVFrame *in)
+{
+    ScaleLadderContext *s = ctx->priv;
+    int ret;
+
+    free_contexts(s);
+
+    s->in_w          = in->width;
+    s->in_h          = in->height;
+    s->in_format     = in->format;
+    s->in_colorspace = in->colorspace;
+    s->in_range      = in->color_range;
+
+    for (int n = 0; n < s->nb_renditions; n++) {
+        const int i = s->order[n];
+        Rendition *r = &s->renditions[i];
+        int src_w = in->width, src_h = in->height, src_format = in->format;
+        enum AVColorRange src_range = in->color_range;
+
+        /* scale from the smallest rendition made so far which is at least
+         * twice as large in both dimensions */
+        for (int m = n - 1; s->cascade && m >= 0; m--) {
+            const int j = s->order[m];
+            const Rendition *src = &s->renditions[j];
+            const int fmt = ctx->outputs[j]->format;
+
+            if (src->w >= 2 * r->w && src->h >= 2 * r->h &&
+                sws_isSupportedInput(fmt)) {
+                r->source  = j;
+                src_w      = src->w;
+                src_h      = src->h;
+                src_format = fmt;
+                src_range  = src->range;
+                break;
+            }
+        }
+
+        ret = alloc_context(ctx, r, src_w, src_h, src_format, src_range,
+                            ctx->outputs[i]->format);
+        if (ret < 0)
+            return ret;
+
+        av_log(ctx, AV_LOG_VERBOSE, "output%d: %dx%d from %s\n", i, r->w, r->h,
+               r->source < 0 ? "input" : "a larger rendition");
+    }
+
+    return 0;
+}
+
+static int filter_frame(AVFilterLink *inlink, AVFrame *in)
+{
+    AVFilterContext *ctx = inlink->dst;
+    ScaleLadderContext *s = ctx->priv;
+    int nb_multi = 0, ret = 0;
+
+    if (!s->renditions[0].sws || in->width != s->in_w || in->height != s->in_h ||
+        in->format != s->in_format || in->colorspace != s->in_colorspace ||
+        in->color_range != s->in_range) {
+        ret = init_contexts(ctx, in);
+        if (ret < 0)
+            goto end;
+    }
+
+    for (int i = 0; i < s->nb_renditions; i++) {
+        AVFilterLink *outlink = ctx->outputs[i];
+        const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(outlink->format);
+        AVFrame *out;
+
+        out = s->out[i] = ff_get_video_buffer(outlink, outlink->w, outlink->h);
+        if (!out) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        av_frame_copy_props(out, in);
+        out->width  = outlink->w;
+        out->height = outlink->h;
+
+        if (in->sample_aspect_ratio.num)
+            out->sample_aspect_ratio = av_mul_q((AVRational){ outlink->h * in->width,
+                                                              outlink->w * in->height },
+                                                in->sample_aspect_ratio);
+
+        if (desc->flags & AV_PIX_FMT_FLAG_RGB)
+            out->colorspace = AVCOL_SPC_RGB;
+        else if (out->colorspace == AVCOL_SPC_RGB)
+            out->colorspace = AVCOL_SPC_UNSPECIFIED;
+        out->color_range = s->renditions[i].range;
+
+        if (s->renditions[i].source < 0) {
+            s->multi_sws[nb_multi]   = s->renditions[i].sws;
+            s->multi_dst[nb_multi++] = out;
+        }
+    }
+
+    /* all the renditions scaled from the input share one pass over it */
+    ret = sws_scale_frame_multi(s->multi_sws, s->multi_dst, nb_multi, in);
+    if (ret < 0)
+        goto end;
+
+    /* the cascaded ones follow, larger sources having been produced first */
+    for (int n = 0; n < s->nb_renditions; n++) {
+        const int i = s->order[n];
+        const Rendition *r = &s->renditions[i];
+
+        if (r->source < 0)
+            continue;
+        ret = sws_scale_frame(r->sws, s->out[i], s->out[r->source]);
+        if (ret < 0)
+            goto end;
+    }
+
+    for (int i = 0; i < s->nb_renditions; i++) {
+        AVFrame *out = s->out[i];
+
+        s->out[i] = NULL;
+        if (ff_outlink_get_status(ctx->outputs[i])) {
+            av_frame_free(&out);
+            continue;
+        }
+        ret = ff_filter_frame(ctx->outputs[i], out);
+        if (ret < 0)
+            goto end;
+    }
+
+end:
+    for (int i = 0; i < s->nb_renditions; i++)
+        av_frame_free(&s->out[i]);
+    av_frame_free(&in);
+    return ret;
+}
+
+#define OFFSET(x) offsetof(ScaleLadderContext, x)
+#define FLAGS AV_OPT_FLAG_VIDEO_PARAM | AV_OPT_FLAG_FILTERING_PARAM
+static const AVOption scale_ladder_options[] = {
+    { "sizes",   "set the output sizes, separated by '|'", OFFSET(sizes_str), AV_OPT_TYPE_STRING, { .str = NULL },      .flags = FLAGS },
+    { "flags",   "set libswscale flags",                   OFFSET(flags_str), AV_OPT_TYPE_STRING, { .str = "bicubic" }, .flags = FLAGS },
+    { "cascade", "scale small outputs from larger ones",   OFFSET(cascade),   AV_OPT_TYPE_BOOL,   { .i64 = 0 }, 0, 1,   FLAGS },
+    { NULL }
+};
+
+AVFILTER_DEFINE_CLASS(scale_ladder);
+
+static const AVFilterPad scale_ladder_inputs[] = {
+    {
+        .name         = "default",
+        .type         = AVMEDIA_TYPE_VIDEO,
+        .filter_frame = filter_frame,
+    },
+};
+
+const AVFilter ff_vf_scale_ladder = {
+    .name          = "scale_ladder",
+    .description   = NULL_IF_CONFIG_SMALL("Scale the input video to several sizes in one pass."),
+    .init          = init,
+    .uninit        = uninit,
+    .priv_size     = sizeof(ScaleLadderContext),
+    .priv_class    = &scale_ladder_class,
+    FILTER_INPUTS(scale_ladder_inputs),
+    .outputs       = NULL,
+    FILTER_QUERY_FUNC(query_formats),
+    .flags         = AVFILTER_FLAG_DYNAMIC_OUTPUTS,
+};
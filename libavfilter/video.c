@@ -101,11 +101,17 @@ AVFrame *ff_get_video_buffer(AVFilterLink *link, int w, int h)
 
     FF_TPRINTF_START(NULL, get_video_buffer); ff_tlog_link(NULL, link, 0);
 
-    if (link->dstpad->get_buffer.video)
+    if (link->dstpad->get_buffer.video) {
+        link->dst->internal->in_get_buffer++;
         ret = link->dstpad->get_buffer.video(link, w, h);
+        link->dst->internal->in_get_buffer--;
+    }
 
     if (!ret)
         ret = ff_default_get_video_buffer(link, w, h);
 
+    if (ret)
+        ff_filter_profile_alloc(link->src, ret);
+
     return ret;
 }
@@ -0,0 +1,224 @@
+;*****************************************************************************
+;* x86-optimized functions for agc filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+ramp_idx:  dd 0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0
+ramp_inc4: times 4 dd 4.0
+ramp_inc8: times 8 dd 8.0
+abs_mask:  times 8 dd 0x7fffffff
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; float ff_agc_peak_flt(const float *src, ptrdiff_t len)
+;------------------------------------------------------------------------------
+
+%macro PEAK_FLT 0
+cglobal agc_peak_flt, 2,2,3, src, len
+    shl       lenq, 2
+    add       srcq, lenq
+    neg       lenq
+    xorps       m0, m0
+    mova        m2, [abs_mask]
+.loop:
+    movu        m1, [srcq+lenq]
+    andps       m1, m2
+    maxps       m0, m1
+    add       lenq, mmsize
+    jl .loop
+%if mmsize == 32
+    vextractf128 xm1, m0, 1
+    maxps       xm0, xm1
+%endif
+    movhlps     xm1, xm0
+    maxps       xm0, xm1
+    movss       xm1, xm0
+    shufps      xm0, xm0, 1
+    maxss       xm0, xm1
+%if ARCH_X86_64 == 0
+    movss       r0m, xm0
+    fld dword   r0m
+%endif
+    RET
+%endmacro
+
+INIT_XMM sse
+PEAK_FLT
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+PEAK_FLT
+%endif
+
+;------------------------------------------------------------------------------
+; int ff_agc_peak_s16(const int16_t *src, ptrdiff_t len)
+;------------------------------------------------------------------------------
+
+%macro PEAK_S16 0
+cglobal agc_peak_s16, 2,2,4, src, len
+    add       lenq, lenq
+    add       srcq, lenq
+    neg       lenq
+    pxor        m0, m0
+    pxor        m1, m1
+.loop:
+    movu        m2, [srcq+lenq]
+    pmaxsw      m0, m2
+    pminsw      m1, m2
+    add       lenq, mmsize
+    jl .loop
+%if mmsize == 32
+    vextracti128 xm2, m0, 1
+    vextracti128 xm3, m1, 1
+    pmaxsw      xm0, xm2
+    pminsw      xm1, xm3
+%endif
+    pshufd      xm2, xm0, q1032
+    pshufd      xm3, xm1, q1032
+    pmaxsw      xm0, xm2
+    pminsw      xm1, xm3
+    pshufd      xm2, xm0, q0001
+    pshufd      xm3, xm1, q0001
+    pmaxsw      xm0, xm2
+    pminsw      xm1, xm3
+    pshuflw     xm2, xm0, q0001
+    pshuflw     xm3, xm1, q0001
+    pmaxsw      xm0, xm2
+    pminsw      xm1, xm3
+    movd        eax, xm0
+    movd        r1d, xm1
+    movsx       eax, ax
+    movsx       r1d, r1w
+    neg         r1d
+    cmp         eax, r1d
+    cmovl       eax, r1d
+    RET
+%endmacro
+
+INIT_XMM sse2
+PEAK_S16
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+PEAK_S16
+%endif
+
+; loads gain into m0 and step into m1, broadcast
+%macro LOAD_GAIN_STEP 0
+%if ARCH_X86_32
+    movss      xm0, gainm
+    movss      xm1, stepm
+%elif WIN64
+    SWAP        0, 3
+    movss      xm1, stepm
+%endif
+    VBROADCASTSS m0, xm0
+    VBROADCASTSS m1, xm1
+    mova        m2, [ramp_idx]
+%if mmsize == 32
+    mova        m4, [ramp_inc8]
+%else
+    mova        m4, [ramp_inc4]
+%endif
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_agc_ramp_flt(float *dst, const float *src, ptrdiff_t len,
+;                      float gain, float step)
+;------------------------------------------------------------------------------
+
+%macro RAMP_FLT 0
+cglobal agc_ramp_flt, 3,3,6, dst, src, len, gain, step
+    LOAD_GAIN_STEP
+    shl       lenq, 2
+    add       dstq, lenq
+    add       srcq, lenq
+    neg       lenq
+.loop:
+    mulps       m3, m2, m1
+    addps       m3, m0
+    movu        m5, [srcq+lenq]
+    mulps       m5, m3
+    movu [dstq+lenq], m5
+    addps       m2, m4
+    add       lenq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse
+RAMP_FLT
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+RAMP_FLT
+%endif
+
+;------------------------------------------------------------------------------
+; void ff_agc_ramp_s16(int16_t *dst, const int16_t *src, ptrdiff_t len,
+;                      float gain, float step)
+;------------------------------------------------------------------------------
+
+%macro RAMP_S16 0
+cglobal agc_ramp_s16, 3,3,8, dst, src, len, gain, step
+    LOAD_GAIN_STEP
+    add       lenq, lenq
+    add       dstq, lenq
+    add       srcq, lenq
+    neg       lenq
+.loop:
+%if cpuflag(avx2)
+    pmovsxwd    m5, [srcq+lenq]
+    pmovsxwd    m6, [srcq+lenq+mmsize/2]
+%else
+    movu        m6, [srcq+lenq]
+    punpcklwd   m5, m6
+    punpckhwd   m6, m6
+    psrad       m5, 16
+    psrad       m6, 16
+%endif
+    cvtdq2ps    m5, m5
+    cvtdq2ps    m6, m6
+    mulps       m3, m2, m1
+    addps       m3, m0
+    addps       m2, m4
+    mulps       m7, m2, m1
+    addps       m7, m0
+    addps       m2, m4
+    mulps       m5, m3
+    mulps       m6, m7
+    cvtps2dq    m5, m5
+    cvtps2dq    m6, m6
+    packssdw    m5, m6
+%if cpuflag(avx2)
+    vpermq      m5, m5, q3120
+%endif
+    movu [dstq+lenq], m5
+    add       lenq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse2
+RAMP_S16
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+RAMP_S16
+%endif
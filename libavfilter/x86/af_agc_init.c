@@ -0,0 +1,59 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/af_agc.h"
+
+float ff_agc_peak_flt_sse(const float *src, ptrdiff_t len);
+float ff_agc_peak_flt_avx(const float *src, ptrdiff_t len);
+int ff_agc_peak_s16_sse2(const int16_t *src, ptrdiff_t len);
+int ff_agc_peak_s16_avx2(const int16_t *src, ptrdiff_t len);
+
+void ff_agc_ramp_flt_sse(float *dst, const float *src, ptrdiff_t len,
+                         float gain, float step);
+void ff_agc_ramp_flt_avx(float *dst, const float *src, ptrdiff_t len,
+                         float gain, float step);
+void ff_agc_ramp_s16_sse2(int16_t *dst, const int16_t *src, ptrdiff_t len,
+                          float gain, float step);
+void ff_agc_ramp_s16_avx2(int16_t *dst, const int16_t *src, ptrdiff_t len,
+                          float gain, float step);
+
+av_cold void ff_agc_init_x86(AGCDSPContext *s)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE(cpu_flags)) {
+        s->peak_flt = ff_agc_peak_flt_sse;
+        s->ramp_flt = ff_agc_ramp_flt_sse;
+    }
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        s->peak_s16 = ff_agc_peak_s16_sse2;
+        s->ramp_s16 = ff_agc_ramp_s16_sse2;
+    }
+    if (EXTERNAL_AVX_FAST(cpu_flags)) {
+        s->peak_flt = ff_agc_peak_flt_avx;
+        s->ramp_flt = ff_agc_ramp_flt_avx;
+    }
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        s->peak_s16 = ff_agc_peak_s16_avx2;
+        s->ramp_s16 = ff_agc_ramp_s16_avx2;
+    }
+}
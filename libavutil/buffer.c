@@ -16,14 +16,20 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include "config.h"
+
 #include <stdatomic.h>
 #include <stdint.h>
 #include <string.h>
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #include "avassert.h"
 #include "buffer_internal.h"
 #include "common.h"
 #include "mem.h"
+#include "mem_internal.h"
 #include "thread.h"
 
 static AVBufferRef *buffer_create(AVBuffer *buf, uint8_t *data, size_t size,
@@ -256,9 +262,13 @@ int av_buffer_replace(AVBufferRef **pdst, const AVBufferRef *src)
     return 0;
 }
 
-AVBufferPool *av_buffer_pool_init2(size_t size, void *opaque,
+#define POOL_IDX_NONE  UINT32_MAX
+#define POOL_IDX_MASK  UINT32_MAX
+#define POOL_TAG_ONE   (UINT64_C(1) << 32)
+
+AVBufferPool *av_buffer_pool_init3(size_t size, void *opaque,
                                    AVBufferRef* (*alloc)(void *opaque, size_t size),
-                                   void (*pool_free)(void *opaque))
+                                   void (*pool_free)(void *opaque), int flags)
 {
     AVBufferPool *pool = av_mallocz(sizeof(*pool));
     if (!pool)
@@ -272,11 +282,24 @@ AVBufferPool *av_buffer_pool_init2(size_t size, void *opaque,
     pool->alloc     = av_buffer_alloc; // fallback
     pool->pool_free = pool_free;
 
+    /* the tagged free list needs a real 64-bit atomic */
+    if (sizeof(pool->head) >= sizeof(uint64_t))
+        pool->flags = flags & AV_BUFFER_POOL_FLAG_LOCKLESS;
+    pool->flags |= flags & AV_BUFFER_POOL_FLAG_HUGEPAGES;
+    atomic_init(&pool->head, POOL_IDX_NONE);
+
     atomic_init(&pool->refcount, 1);
 
     return pool;
 }
 
+AVBufferPool *av_buffer_pool_init2(size_t size, void *opaque,
+                                   AVBufferRef* (*alloc)(void *opaque, size_t size),
+                                   void (*pool_free)(void *opaque))
+{
+    return av_buffer_pool_init3(size, opaque, alloc, pool_free, 0);
+}
+
 AVBufferPool *av_buffer_pool_init(size_t size, AVBufferRef* (*alloc)(size_t size))
 {
     AVBufferPool *pool = av_mallocz(sizeof(*pool));
@@ -288,13 +311,88 @@ AVBufferPool *av_buffer_pool_init(size_t size, AVBufferRef* (*alloc)(size_t size
     pool->size     = size;
     pool->alloc    = alloc ? alloc : av_buffer_alloc;
 
+    atomic_init(&pool->head, POOL_IDX_NONE);
     atomic_init(&pool->refcount, 1);
 
     return pool;
 }
 
+static BufferPoolEntry *pool_entry(AVBufferPool *pool, unsigned idx)
+{
+    unsigned pos   = idx + POOL_CHUNK_SIZE;
+    unsigned chunk = av_log2(pos) - av_log2(POOL_CHUNK_SIZE);
+
+    return pool->entries[chunk][pos - (POOL_CHUNK_SIZE << chunk)];
+}
+
+/* must be called with the pool mutex held */
+static int pool_add_entry(AVBufferPool *pool, BufferPoolEntry *buf)
+{
+    unsigned pos = pool->nb_entries + POOL_CHUNK_SIZE;
+    unsigned chunk = av_log2(pos) - av_log2(POOL_CHUNK_SIZE);
+
+    if (chunk >= POOL_MAX_CHUNKS)
+        return AVERROR(ENOMEM);
+    if (!pool->entries[chunk]) {
+        pool->entries[chunk] = av_calloc(POOL_CHUNK_SIZE << chunk,
+                                         sizeof(*pool->entries[chunk]));
+        if (!pool->entries[chunk])
+            return AVERROR(ENOMEM);
+    }
+    pool->entries[chunk][pos - (POOL_CHUNK_SIZE << chunk)] = buf;
+    buf->idx = pool->nb_entries++;
+
+    return 0;
+}
+
+static void pool_push(AVBufferPool *pool, BufferPoolEntry *buf)
+{
+    uint64_t head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    uint64_t new;
+
+    do {
+        atomic_store_explicit(&buf->next_idx, head & POOL_IDX_MASK,
+                              memory_order_relaxed);
+        new = ((head + POOL_TAG_ONE) & ~(uint64_t)POOL_IDX_MASK) | buf->idx;
+    } while (!atomic_compare_exchange_weak_explicit(&pool->head, &head, new,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+static BufferPoolEntry *pool_pop(AVBufferPool *pool)
+{
+    uint64_t head = atomic_load_explicit(&pool->head, memory_order_acquire);
+    BufferPoolEntry *buf;
+    uint64_t new;
+
+    do {
+        unsigned idx = head & POOL_IDX_MASK;
+
+        if (idx == POOL_IDX_NONE)
+            return NULL;
+
+        /* Entries are only freed together with the pool, so buf stays valid
+         * even if another thread pops it first; the tag makes the exchange
+         * fail in that case. */
+        buf = pool_entry(pool, idx);
+        new = ((head + POOL_TAG_ONE) & ~(uint64_t)POOL_IDX_MASK) |
+              atomic_load_explicit(&buf->next_idx, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&pool->head, &head, new,
+                                                    memory_order_acquire,
+                                                    memory_order_acquire));
+
+    return buf;
+}
+
 static void buffer_pool_flush(AVBufferPool *pool)
 {
+    BufferPoolEntry *entry;
+
+    while ((entry = pool_pop(pool))) {
+        entry->free(entry->opaque, entry->data);
+        av_freep(&entry);
+    }
+
     while (pool->pool) {
         BufferPoolEntry *buf = pool->pool;
         pool->pool = buf->next;
@@ -313,6 +411,9 @@ static void buffer_pool_free(AVBufferPool *pool)
     buffer_pool_flush(pool);
     ff_mutex_destroy(&pool->mutex);
 
+    for (int i = 0; i < POOL_MAX_CHUNKS; i++)
+        av_freep(&pool->entries[i]);
+
     if (pool->pool_free)
         pool->pool_free(pool->opaque);
 
@@ -344,15 +445,61 @@ static void pool_release_buffer(void *opaque, uint8_t *data)
     if(CONFIG_MEMORY_POISONING)
         memset(buf->data, FF_MEMORY_POISON, pool->size);
 
-    ff_mutex_lock(&pool->mutex);
-    buf->next = pool->pool;
-    pool->pool = buf;
-    ff_mutex_unlock(&pool->mutex);
+    if (pool->flags & AV_BUFFER_POOL_FLAG_LOCKLESS) {
+        pool_push(pool, buf);
+    } else {
+        ff_mutex_lock(&pool->mutex);
+        buf->next = pool->pool;
+        pool->pool = buf;
+        ff_mutex_unlock(&pool->mutex);
+    }
 
     if (atomic_fetch_sub_explicit(&pool->refcount, 1, memory_order_acq_rel) == 1)
         buffer_pool_free(pool);
 }
 
+#if HAVE_MMAP && defined(MAP_ANONYMOUS)
+static void pool_unmap_huge(void *opaque, uint8_t *data)
+{
+    AVBufferPool *pool = opaque;
+    munmap(data, FFALIGN(pool->size, FF_HUGEPAGE_SIZE));
+}
+
+static void pool_unmap(void *opaque, uint8_t *data)
+{
+    AVBufferPool *pool = opaque;
+    munmap(data, pool->size);
+}
+
+static AVBufferRef *pool_alloc_hugepages(AVBufferPool *pool)
+{
+    void (*unmap)(void *opaque, uint8_t *data) = pool_unmap;
+    AVBufferRef *ret;
+    void *ptr = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    ptr = mmap(NULL, FFALIGN(pool->size, FF_HUGEPAGE_SIZE), PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) {
+        unmap = pool_unmap_huge;
+        ff_mem_apply_policy(ptr, FFALIGN(pool->size, FF_HUGEPAGE_SIZE), 0);
+    }
+#endif
+    if (ptr == MAP_FAILED) {
+        ptr = mmap(NULL, pool->size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            return NULL;
+        ff_mem_apply_policy(ptr, pool->size, AV_MEM_POLICY_HUGEPAGES);
+    }
+
+    ret = av_buffer_create(ptr, pool->size, unmap, pool, 0);
+    if (!ret)
+        unmap(pool, ptr);
+    return ret;
+}
+#endif
+
 /* allocate a new buffer and override its free() callback so that
  * it is returned to the pool on free */
 static AVBufferRef *pool_alloc_buffer(AVBufferPool *pool)
@@ -362,6 +509,12 @@ static AVBufferRef *pool_alloc_buffer(AVBufferPool *pool)
 
     av_assert0(pool->alloc || pool->alloc2);
 
+#if HAVE_MMAP && defined(MAP_ANONYMOUS)
+    if (pool->flags & AV_BUFFER_POOL_FLAG_HUGEPAGES && !pool->alloc2 &&
+        pool->alloc == av_buffer_alloc && pool->size >= FF_HUGEPAGE_SIZE)
+        ret = pool_alloc_hugepages(pool);
+    else
+#endif
     ret = pool->alloc2 ? pool->alloc2(pool->opaque, pool->size) :
                          pool->alloc(pool->size);
     if (!ret)
@@ -378,17 +531,54 @@ static AVBufferRef *pool_alloc_buffer(AVBufferPool *pool)
     buf->free   = ret->buffer->free;
     buf->pool   = pool;
 
+    if (pool->flags & AV_BUFFER_POOL_FLAG_LOCKLESS &&
+        pool_add_entry(pool, buf) < 0) {
+        av_freep(&buf);
+        av_buffer_unref(&ret);
+        return NULL;
+    }
+
     ret->buffer->opaque = buf;
     ret->buffer->free   = pool_release_buffer;
 
     return ret;
 }
 
+static AVBufferRef *pool_get_lockless(AVBufferPool *pool)
+{
+    AVBufferRef *ret;
+    BufferPoolEntry *buf = pool_pop(pool);
+
+    if (buf) {
+        memset(&buf->buffer, 0, sizeof(buf->buffer));
+        ret = buffer_create(&buf->buffer, buf->data, pool->size,
+                            pool_release_buffer, buf, 0);
+        if (!ret) {
+            pool_push(pool, buf);
+            return NULL;
+        }
+        buf->buffer.flags_internal |= BUFFER_FLAG_NO_FREE;
+    } else {
+        ff_mutex_lock(&pool->mutex);
+        ret = pool_alloc_buffer(pool);
+        ff_mutex_unlock(&pool->mutex);
+    }
+
+    return ret;
+}
+
 AVBufferRef *av_buffer_pool_get(AVBufferPool *pool)
 {
     AVBufferRef *ret;
     BufferPoolEntry *buf;
 
+    if (pool->flags & AV_BUFFER_POOL_FLAG_LOCKLESS) {
+        ret = pool_get_lockless(pool);
+        if (ret)
+            atomic_fetch_add_explicit(&pool->refcount, 1, memory_order_relaxed);
+        return ret;
+    }
+
     ff_mutex_lock(&pool->mutex);
     buf = pool->pool;
     if (buf) {
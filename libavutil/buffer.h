@@ -284,6 +284,40 @@ AVBufferPool *av_buffer_pool_init2(size_t size, void *opaque,
                                    AVBufferRef* (*alloc)(void *opaque, size_t size),
                                    void (*pool_free)(void *opaque));
 
+/**
+ * Use a lock-free free list in the pool. Getting a buffer from and returning
+ * a buffer to the pool then never blocks; only allocating a new buffer when
+ * the pool is empty takes a lock. This reduces contention when many threads
+ * share one pool.
+ */
+#define AV_BUFFER_POOL_FLAG_LOCKLESS (1 << 0)
+
+/**
+ * Allocate the buffers with huge pages, using explicit huge pages when
+ * available and transparent huge pages otherwise. The NUMA node set with
+ * av_mem_set_policy() is respected. Only has an effect for pools with the
+ * default allocator and buffers of at least 2 MiB.
+ */
+#define AV_BUFFER_POOL_FLAG_HUGEPAGES (1 << 1)
+
+/**
+ * Allocate and initialize a buffer pool with a more complex allocator and
+ * pool flags.
+ *
+ * @param size size of each buffer in this pool
+ * @param opaque arbitrary user data used by the allocator
+ * @param alloc a function that will be used to allocate new buffers when the
+ *              pool is empty. May be NULL, then the default allocator will be
+ *              used (av_buffer_alloc()).
+ * @param pool_free a function that will be called immediately before the pool
+ *                  is freed, see av_buffer_pool_init2(). May be NULL.
+ * @param flags a combination of AV_BUFFER_POOL_FLAG_*
+ * @return newly created buffer pool on success, NULL on error.
+ */
+AVBufferPool *av_buffer_pool_init3(size_t size, void *opaque,
+                                   AVBufferRef* (*alloc)(void *opaque, size_t size),
+                                   void (*pool_free)(void *opaque), int flags);
+
 /**
  * Mark the pool as being available for freeing. It will actually be freed only
  * once all the allocated buffers associated with the pool are released. Thus it
@@ -79,6 +79,13 @@ typedef struct BufferPoolEntry {
     AVBufferPool *pool;
     struct BufferPoolEntry *next;
 
+    /*
+     * Used in lockless mode only: the index of this entry in the pool's
+     * entry table and the index of the next free entry.
+     */
+    unsigned idx;
+    atomic_uint next_idx;
+
     /*
      * An AVBuffer structure to (re)use as AVBuffer for subsequent uses
      * of this BufferPoolEntry.
@@ -86,10 +93,30 @@ typedef struct BufferPoolEntry {
     AVBuffer buffer;
 } BufferPoolEntry;
 
+/*
+ * Entry table of a lockless pool. Chunk n holds (POOL_CHUNK_SIZE << n)
+ * entries, so the table never has to be reallocated and entries can be
+ * looked up without locking.
+ */
+#define POOL_CHUNK_SIZE 16
+#define POOL_MAX_CHUNKS 27
+
 struct AVBufferPool {
     AVMutex mutex;
     BufferPoolEntry *pool;
 
+    int flags;
+
+    /*
+     * Free list of a lockless pool: a stack of entry indices. The low 32 bits
+     * of head are the index of the top entry (UINT32_MAX if empty), the high
+     * 32 bits are a tag incremented on every update to prevent ABA.
+     * Only allocating new entries takes the mutex.
+     */
+    atomic_uint_least64_t head;
+    BufferPoolEntry **entries[POOL_MAX_CHUNKS];
+    unsigned nb_entries;
+
     /*
      * This is used to track when the pool is to be freed.
      * The pointer to the pool itself held by the caller is considered to
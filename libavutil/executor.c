@@ -0,0 +1,351 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+
+#include <stdatomic.h>
+
+#include "cpu.h"
+#include "error.h"
+#include "executor.h"
+#include "executor_internal.h"
+#include "macros.h"
+#include "mem.h"
+#include "thread.h"
+
+static void run_serially(void (*func)(void *opaque, int jobnr, int threadnr),
+                         void *opaque, int nb_jobs)
+{
+    for (int i = 0; i < nb_jobs; i++)
+        func(opaque, i, 0);
+}
+
+#if HAVE_THREADS
+
+typedef struct ExecutorBatch {
+    struct ExecutorBatch *next;
+    int priority;
+
+    void (*func)(void *opaque, int jobnr, int threadnr);
+    void *opaque;
+    int nb_jobs;
+    int max_threads;
+    atomic_int next_job;
+
+    /* protected by the executor lock */
+    int nb_threads;                 ///< threads which joined, including the submitter
+    int nb_running;                 ///< workers still running jobs of the batch
+    pthread_cond_t done_cond;
+} ExecutorBatch;
+
+struct AVExecutor {
+    pthread_t *threads;
+    int nb_threads;
+
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    ExecutorBatch  *batches;        ///< batches needing threads, by decreasing priority
+    int finished;
+
+    unsigned refcount;              ///< protected by global_lock
+};
+
+static AVMutex global_lock = AV_MUTEX_INITIALIZER;
+static AVExecutor *global_executor;
+
+static void run_batch(ExecutorBatch *b, int threadnr)
+{
+    int jobnr;
+
+    while ((jobnr = atomic_fetch_add_explicit(&b->next_job, 1, memory_order_relaxed)) < b->nb_jobs)
+        b->func(b->opaque, jobnr, threadnr);
+}
+
+static void unlink_batch(AVExecutor *e, ExecutorBatch *b)
+{
+    ExecutorBatch **p;
+
+    for (p = &e->batches; *p; p = &(*p)->next) {
+        if (*p == b) {
+            *p = b->next;
+            break;
+        }
+    }
+}
+
+/* Must be called with the lock held. */
+static ExecutorBatch *pick_batch(AVExecutor *e)
+{
+    while (e->batches) {
+        ExecutorBatch *b = e->batches;
+
+        if (b->nb_threads < b->max_threads &&
+            atomic_load_explicit(&b->next_job, memory_order_relaxed) < b->nb_jobs)
+            return b;
+        /* batch is full or has no jobs left to start */
+        e->batches = b->next;
+    }
+    return NULL;
+}
+
+static void *attribute_align_arg executor_worker(void *arg)
+{
+    AVExecutor *e = arg;
+
+    pthread_mutex_lock(&e->lock);
+    while (!e->finished) {
+        ExecutorBatch *b = pick_batch(e);
+        int threadnr;
+
+        if (!b) {
+            pthread_cond_wait(&e->cond, &e->lock);
+            continue;
+        }
+
+        threadnr = b->nb_threads++;
+        b->nb_running++;
+        pthread_mutex_unlock(&e->lock);
+
+        run_batch(b, threadnr);
+
+        pthread_mutex_lock(&e->lock);
+        if (!--b->nb_running)
+            pthread_cond_signal(&b->done_cond);
+    }
+    pthread_mutex_unlock(&e->lock);
+
+    return NULL;
+}
+
+static void executor_stop(AVExecutor *e)
+{
+    pthread_mutex_lock(&e->lock);
+    e->finished = 1;
+    pthread_cond_broadcast(&e->cond);
+    pthread_mutex_unlock(&e->lock);
+
+    for (int i = 0; i < e->nb_threads; i++)
+        pthread_join(e->threads[i], NULL);
+
+    pthread_cond_destroy(&e->cond);
+    pthread_mutex_destroy(&e->lock);
+    av_freep(&e->threads);
+    av_free(e);
+}
+
+AVExecutor *av_executor_alloc(int nb_threads)
+{
+    AVExecutor *e;
+
+    if (nb_threads < 0)
+        return NULL;
+    if (!nb_threads)
+        nb_threads = av_cpu_count();
+
+    e = av_mallocz(sizeof(*e));
+    if (!e)
+        return NULL;
+    e->refcount = 1;
+
+    e->threads = av_calloc(nb_threads, sizeof(*e->threads));
+    if (!e->threads) {
+        av_free(e);
+        return NULL;
+    }
+    if (pthread_mutex_init(&e->lock, NULL)) {
+        av_free(e->threads);
+        av_free(e);
+        return NULL;
+    }
+    if (pthread_cond_init(&e->cond, NULL)) {
+        pthread_mutex_destroy(&e->lock);
+        av_free(e->threads);
+        av_free(e);
+        return NULL;
+    }
+
+    for (; e->nb_threads < nb_threads; e->nb_threads++) {
+        if (pthread_create(&e->threads[e->nb_threads], NULL, executor_worker, e)) {
+            executor_stop(e);
+            return NULL;
+        }
+    }
+
+    return e;
+}
+
+void av_executor_free(AVExecutor **pe)
+{
+    AVExecutor *e = *pe;
+    unsigned refcount;
+
+    if (!e)
+        return;
+    *pe = NULL;
+
+    ff_mutex_lock(&global_lock);
+    refcount = --e->refcount;
+    ff_mutex_unlock(&global_lock);
+
+    if (!refcount)
+        executor_stop(e);
+}
+
+int av_executor_execute(AVExecutor *e, int priority,
+                        void (*func)(void *opaque, int jobnr, int threadnr),
+                        void *opaque, int nb_jobs, int max_threads)
+{
+    ExecutorBatch b = { 0 };
+    ExecutorBatch **p;
+    int nb_wake, ret;
+
+    if (nb_jobs <= 0)
+        return 0;
+
+    if (max_threads <= 0 || max_threads > e->nb_threads + 1)
+        max_threads = e->nb_threads + 1;
+    if (nb_jobs == 1 || max_threads == 1) {
+        run_serially(func, opaque, nb_jobs);
+        return 0;
+    }
+
+    if ((ret = pthread_cond_init(&b.done_cond, NULL))) {
+        run_serially(func, opaque, nb_jobs);
+        return AVERROR(ret);
+    }
+    b.priority    = priority;
+    b.func        = func;
+    b.opaque      = opaque;
+    b.nb_jobs     = nb_jobs;
+    b.max_threads = max_threads;
+    b.nb_threads  = 1;
+    /* job 0 is reserved for the caller */
+    atomic_init(&b.next_job, 1);
+
+    pthread_mutex_lock(&e->lock);
+    for (p = &e->batches; *p && (*p)->priority >= priority; p = &(*p)->next)
+        ;
+    b.next = *p;
+    *p     = &b;
+    nb_wake = FFMIN(nb_jobs, max_threads) - 1;
+    while (nb_wake--)
+        pthread_cond_signal(&e->cond);
+    pthread_mutex_unlock(&e->lock);
+
+    func(opaque, 0, 0);
+    run_batch(&b, 0);
+
+    pthread_mutex_lock(&e->lock);
+    unlink_batch(e, &b);
+    while (b.nb_running)
+        pthread_cond_wait(&b.done_cond, &e->lock);
+    pthread_mutex_unlock(&e->lock);
+
+    pthread_cond_destroy(&b.done_cond);
+    return 0;
+}
+
+int av_executor_get_nb_threads(const AVExecutor *e)
+{
+    return e->nb_threads;
+}
+
+int av_executor_global_init(int nb_threads)
+{
+    AVExecutor *e = av_executor_alloc(nb_threads);
+    int ret = 0;
+
+    if (!e)
+        return AVERROR(ENOMEM);
+
+    ff_mutex_lock(&global_lock);
+    if (global_executor)
+        ret = AVERROR(EEXIST);
+    else
+        global_executor = e;
+    ff_mutex_unlock(&global_lock);
+
+    if (ret < 0)
+        av_executor_free(&e);
+    return ret;
+}
+
+void av_executor_global_uninit(void)
+{
+    AVExecutor *e;
+
+    ff_mutex_lock(&global_lock);
+    e = global_executor;
+    global_executor = NULL;
+    ff_mutex_unlock(&global_lock);
+
+    av_executor_free(&e);
+}
+
+AVExecutor *ff_executor_ref_global(void)
+{
+    AVExecutor *e;
+
+    ff_mutex_lock(&global_lock);
+    e = global_executor;
+    if (e)
+        e->refcount++;
+    ff_mutex_unlock(&global_lock);
+
+    return e;
+}
+
+#else /* HAVE_THREADS */
+
+AVExecutor *av_executor_alloc(int nb_threads)
+{
+    return NULL;
+}
+
+void av_executor_free(AVExecutor **pe)
+{
+}
+
+int av_executor_execute(AVExecutor *e, int priority,
+                        void (*func)(void *opaque, int jobnr, int threadnr),
+                        void *opaque, int nb_jobs, int max_threads)
+{
+    run_serially(func, opaque, nb_jobs);
+    return 0;
+}
+
+int av_executor_get_nb_threads(const AVExecutor *e)
+{
+    return 0;
+}
+
+int av_executor_global_init(int nb_threads)
+{
+    return AVERROR(ENOSYS);
+}
+
+void av_executor_global_uninit(void)
+{
+}
+
+AVExecutor *ff_executor_ref_global(void)
+{
+    return NULL;
+}
+
+#endif /* HAVE_THREADS */
@@ -0,0 +1,117 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * @ingroup lavu_executor
+ * Shared worker thread pool.
+ */
+
+#ifndef AVUTIL_EXECUTOR_H
+#define AVUTIL_EXECUTOR_H
+
+/**
+ * @defgroup lavu_executor Executor
+ * @ingroup lavu_data
+ *
+ * A pool of worker threads running batches of jobs submitted by any number
+ * of clients.
+ *
+ * The thread submitting a batch takes part in running it, and the workers
+ * of the pool join the pending batches of highest priority first. The
+ * number of worker threads therefore caps the number of jobs running
+ * concurrently on behalf of all clients, apart from one job per submitting
+ * thread.
+ *
+ * When a process-wide executor is installed with av_executor_global_init(),
+ * the slice threading of libavcodec and libavfilter contexts created
+ * afterwards runs on it instead of starting threads of their own.
+ *
+ * @{
+ */
+
+typedef struct AVExecutor AVExecutor;
+
+/**
+ * Allocate an executor and start its worker threads.
+ *
+ * @param nb_threads number of worker threads, 0 for one per CPU core
+ * @return the new executor or NULL on failure
+ */
+AVExecutor *av_executor_alloc(int nb_threads);
+
+/**
+ * Drop a reference to an executor and set the pointer to NULL.
+ *
+ * The worker threads are stopped once the last user has released the
+ * executor. No batch may be running on it from the caller's side.
+ */
+void av_executor_free(AVExecutor **executor);
+
+/**
+ * Run a batch of jobs and wait for its completion.
+ *
+ * Jobs are started in increasing jobnr order, so a job may wait for the
+ * progress of jobs with lower numbers, but jobs are not guaranteed to run
+ * concurrently. threadnr is unique among the jobs of the batch running at
+ * the same time and lower than max_threads. The calling thread runs job 0
+ * first and all its jobs with threadnr 0.
+ *
+ * @param priority    batches with higher values are served first by the
+ *                    worker threads, equal priorities are served in order
+ * @param func        function called for every job
+ * @param opaque      passed to func
+ * @param nb_jobs     number of jobs
+ * @param max_threads maximum number of threads running the jobs of this
+ *                    batch, including the calling thread; 0 for no limit
+ * @return 0 on success, a negative AVERROR code on failure, in which case
+ *         the jobs have all been run by the calling thread
+ */
+int av_executor_execute(AVExecutor *executor, int priority,
+                        void (*func)(void *opaque, int jobnr, int threadnr),
+                        void *opaque, int nb_jobs, int max_threads);
+
+/**
+ * @return the number of worker threads of the executor
+ */
+int av_executor_get_nb_threads(const AVExecutor *executor);
+
+/**
+ * Install a process-wide executor with the given number of worker threads.
+ *
+ * This should be called before any libavcodec or libavfilter context is
+ * created, as contexts only attach to the executor when their threading
+ * is initialized.
+ *
+ * @param nb_threads number of worker threads, 0 for one per CPU core
+ * @return 0 on success, AVERROR(EEXIST) if a process-wide executor is
+ *         already installed, another negative AVERROR code on failure
+ */
+int av_executor_global_init(int nb_threads);
+
+/**
+ * Uninstall the process-wide executor. Contexts still attached to it keep
+ * using it until they are freed.
+ */
+void av_executor_global_uninit(void);
+
+/**
+ * @}
+ */
+
+#endif /* AVUTIL_EXECUTOR_H */
@@ -0,0 +1,32 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVUTIL_EXECUTOR_INTERNAL_H
+#define AVUTIL_EXECUTOR_INTERNAL_H
+
+#include "executor.h"
+
+/**
+ * Get a new reference to the process-wide executor.
+ *
+ * @return the executor, to be released with av_executor_free(), or NULL if
+ *         none is installed
+ */
+AVExecutor *ff_executor_ref_global(void);
+
+#endif /* AVUTIL_EXECUTOR_INTERNAL_H */
@@ -24,6 +24,7 @@
  * default memory allocator for libavutil
  */
 
+#define _DEFAULT_SOURCE
 #define _XOPEN_SOURCE 600
 
 #include "config.h"
@@ -36,6 +37,13 @@
 #if HAVE_MALLOC_H
 #include <malloc.h>
 #endif
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#if defined(__linux__) && HAVE_UNISTD_H
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "avutil.h"
 #include "common.h"
@@ -74,6 +82,57 @@ void av_max_alloc(size_t max){
     atomic_store_explicit(&max_alloc_size, max, memory_order_relaxed);
 }
 
+#if HAVE_MMAP && defined(MADV_HUGEPAGE)
+#define HAVE_HUGEPAGES 1
+#else
+#define HAVE_HUGEPAGES 0
+#endif
+#if defined(SYS_mbind)
+#define HAVE_NUMA_BIND 1
+#define MPOL_PREFERRED 1
+#else
+#define HAVE_NUMA_BIND 0
+#endif
+
+static atomic_int mem_policy    = ATOMIC_VAR_INIT(0);
+static atomic_int mem_numa_node = ATOMIC_VAR_INIT(-1);
+
+int av_mem_set_policy(int flags, int numa_node)
+{
+    if (flags & ~AV_MEM_POLICY_HUGEPAGES || numa_node < -1 || numa_node >= 64)
+        return AVERROR(EINVAL);
+    if ((flags & AV_MEM_POLICY_HUGEPAGES && !HAVE_HUGEPAGES) ||
+        (numa_node >= 0 && !HAVE_NUMA_BIND))
+        return AVERROR(ENOSYS);
+
+    atomic_store_explicit(&mem_numa_node, numa_node, memory_order_relaxed);
+    atomic_store_explicit(&mem_policy,    flags,     memory_order_relaxed);
+    return 0;
+}
+
+void ff_mem_apply_policy(void *ptr, size_t size, int flags)
+{
+    uintptr_t start = FFALIGN((uintptr_t)ptr, FF_HUGEPAGE_SIZE);
+    uintptr_t end   = ((uintptr_t)ptr + size) & ~(uintptr_t)(FF_HUGEPAGE_SIZE - 1);
+    int node = atomic_load_explicit(&mem_numa_node, memory_order_relaxed);
+
+    if (end <= start)
+        return;
+
+    flags |= atomic_load_explicit(&mem_policy, memory_order_relaxed);
+#if HAVE_HUGEPAGES
+    if (flags & AV_MEM_POLICY_HUGEPAGES)
+        madvise((void *)start, end - start, MADV_HUGEPAGE);
+#endif
+#if HAVE_NUMA_BIND
+    if (node >= 0) {
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, (void *)start, (unsigned long)(end - start),
+                MPOL_PREFERRED, &mask, sizeof(mask) * 8 + 1, 0);
+    }
+#endif
+}
+
 static int size_mult(size_t a, size_t b, size_t *r)
 {
     size_t t;
@@ -100,6 +159,14 @@ void *av_malloc(size_t size)
         return NULL;
 
 #if HAVE_POSIX_MEMALIGN
+    if (size >= FF_HUGEPAGE_SIZE &&
+        (atomic_load_explicit(&mem_policy, memory_order_relaxed) ||
+         atomic_load_explicit(&mem_numa_node, memory_order_relaxed) >= 0)) {
+        if (posix_memalign(&ptr, FF_HUGEPAGE_SIZE, size))
+            ptr = NULL;
+        else
+            ff_mem_apply_policy(ptr, size, 0);
+    } else
     if (size) //OS X on SDK 10.6 has a broken posix_memalign implementation
     if (posix_memalign(&ptr, ALIGN, size))
         ptr = NULL;
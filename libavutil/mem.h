@@ -689,6 +689,32 @@ int av_size_mult(size_t a, size_t b, size_t *r);
  */
 void av_max_alloc(size_t max);
 
+/**
+ * Back large allocations with transparent huge pages.
+ */
+#define AV_MEM_POLICY_HUGEPAGES (1 << 0)
+
+/**
+ * Set the global placement policy for large blocks.
+ *
+ * The policy applies to blocks of at least 2 MiB allocated with the @ref
+ * lavu_mem_funcs "heap management functions" after the call, and to buffer
+ * pools created with AV_BUFFER_POOL_FLAG_HUGEPAGES. Such blocks are then
+ * aligned to 2 MiB and, depending on the flags, backed with huge pages and
+ * allocated preferably on the given NUMA node.
+ *
+ * This is meant for applications processing very large frames, where TLB
+ * misses and remote memory accesses become significant. It is disabled by
+ * default.
+ *
+ * @param flags     a combination of AV_MEM_POLICY_* flags
+ * @param numa_node the NUMA node to allocate large blocks on, or -1 to leave
+ *                  the placement to the operating system
+ * @return 0 on success, AVERROR(ENOSYS) if the requested policy is not
+ *         supported on this system, AVERROR(EINVAL) on invalid arguments
+ */
+int av_mem_set_policy(int flags, int numa_node);
+
 /**
  * @}
  * @}
@@ -29,6 +29,18 @@
 #include "mem.h"
 #include "version.h"
 
+/**
+ * Size of a huge page, the granularity used for blocks the global memory
+ * policy applies to.
+ */
+#define FF_HUGEPAGE_SIZE (2 << 20)
+
+/**
+ * Apply the global memory policy set with av_mem_set_policy() to the 2 MiB
+ * aligned part of a block, adding the AV_MEM_POLICY_* flags in flags.
+ */
+void ff_mem_apply_policy(void *ptr, size_t size, int flags);
+
 #if !FF_API_DECLARE_ALIGNED
 /**
  * @def DECLARE_ALIGNED(n,t,v)
@@ -18,6 +18,8 @@
 
 #include <stdatomic.h>
 #include "cpu.h"
+#include "executor.h"
+#include "executor_internal.h"
 #include "slicethread.h"
 #include "mem.h"
 #include "thread.h"
@@ -49,8 +51,17 @@ struct AVSliceThread {
     void            *priv;
     void            (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads);
     void            (*main_func)(void *priv);
+
+    AVExecutor      *executor;
+    int             priority;
 };
 
+static void executor_job(void *opaque, int jobnr, int threadnr)
+{
+    AVSliceThread *ctx = opaque;
+    ctx->worker_func(ctx->priv, jobnr, threadnr, ctx->nb_jobs, ctx->nb_active_threads);
+}
+
 static int run_jobs(AVSliceThread *ctx)
 {
     unsigned nb_jobs    = ctx->nb_jobs;
@@ -92,10 +103,10 @@ static void *attribute_align_arg thread_worker(void *v)
     }
 }
 
-int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
-                              void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
-                              void (*main_func)(void *priv),
-                              int nb_threads)
+int avpriv_slicethread_create2(AVSliceThread **pctx, void *priv,
+                               void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                               void (*main_func)(void *priv),
+                               int nb_threads, int flags)
 {
     AVSliceThread *ctx;
     int nb_workers, i;
@@ -117,6 +128,15 @@ int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
     if (!ctx)
         return AVERROR(ENOMEM);
 
+    /* The executor cannot run a main function next to the jobs. */
+    if (!main_func && !(flags & AVPRIV_SLICETHREAD_FLAG_DEDICATED) && nb_threads > 1 &&
+        (ctx->executor = ff_executor_ref_global())) {
+        ctx->priv        = priv;
+        ctx->worker_func = worker_func;
+        ctx->nb_threads  = nb_threads;
+        return nb_threads;
+    }
+
     if (nb_workers && !(ctx->workers = av_calloc(nb_workers, sizeof(*ctx->workers)))) {
         av_freep(pctx);
         return AVERROR(ENOMEM);
@@ -162,6 +182,14 @@ int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
     return nb_threads;
 }
 
+int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
+                              void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                              void (*main_func)(void *priv),
+                              int nb_threads)
+{
+    return avpriv_slicethread_create2(pctx, priv, worker_func, main_func, nb_threads, 0);
+}
+
 void avpriv_slicethread_execute(AVSliceThread *ctx, int nb_jobs, int execute_main)
 {
     int nb_workers, i, is_last = 0;
@@ -169,6 +197,13 @@ void avpriv_slicethread_execute(AVSliceThread *ctx, int nb_jobs, int execute_mai
     av_assert0(nb_jobs > 0);
     ctx->nb_jobs           = nb_jobs;
     ctx->nb_active_threads = FFMIN(nb_jobs, ctx->nb_threads);
+
+    if (ctx->executor) {
+        av_executor_execute(ctx->executor, ctx->priority, executor_job, ctx,
+                            nb_jobs, ctx->nb_active_threads);
+        return;
+    }
+
     atomic_store_explicit(&ctx->first_job, 0, memory_order_relaxed);
     atomic_store_explicit(&ctx->current_job, ctx->nb_active_threads, memory_order_relaxed);
     nb_workers             = ctx->nb_active_threads;
@@ -197,6 +232,11 @@ void avpriv_slicethread_execute(AVSliceThread *ctx, int nb_jobs, int execute_mai
     }
 }
 
+void avpriv_slicethread_set_priority(AVSliceThread *ctx, int priority)
+{
+    ctx->priority = priority;
+}
+
 void avpriv_slicethread_free(AVSliceThread **pctx)
 {
     AVSliceThread *ctx;
@@ -206,6 +246,12 @@ void avpriv_slicethread_free(AVSliceThread **pctx)
         return;
 
     ctx = *pctx;
+    if (ctx->executor) {
+        av_executor_free(&ctx->executor);
+        av_freep(pctx);
+        return;
+    }
+
     nb_workers = ctx->nb_threads;
     if (!ctx->main_func)
         nb_workers--;
@@ -243,11 +289,24 @@ int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
     return AVERROR(ENOSYS);
 }
 
+int avpriv_slicethread_create2(AVSliceThread **pctx, void *priv,
+                               void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                               void (*main_func)(void *priv),
+                               int nb_threads, int flags)
+{
+    *pctx = NULL;
+    return AVERROR(ENOSYS);
+}
+
 void avpriv_slicethread_execute(AVSliceThread *ctx, int nb_jobs, int execute_main)
 {
     av_assert0(0);
 }
 
+void avpriv_slicethread_set_priority(AVSliceThread *ctx, int priority)
+{
+}
+
 void avpriv_slicethread_free(AVSliceThread **pctx)
 {
     av_assert0(!pctx || !*pctx);
@@ -29,12 +29,33 @@ typedef struct AVSliceThread AVSliceThread;
  * @param main_func special callback function, called from main thread, may be NULL
  * @param nb_threads number of threads, 0 for automatic, must be >= 0
  * @return return number of threads or negative AVERROR on failure
+ *
+ * If no main_func is given and a process-wide executor is installed (see
+ * av_executor_global_init()), the jobs run on the executor using at most
+ * nb_threads threads at once and no threads are created. Jobs are then
+ * started in order and job 0 always runs with threadnr 0, but jobs are not
+ * guaranteed to run concurrently.
  */
 int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
                               void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
                               void (*main_func)(void *priv),
                               int nb_threads);
 
+/**
+ * Always use threads dedicated to the context, so that all the jobs of an
+ * execution run concurrently when there are at least as many threads as jobs.
+ */
+#define AVPRIV_SLICETHREAD_FLAG_DEDICATED (1 << 0)
+
+/**
+ * Create slice threading context, like avpriv_slicethread_create().
+ * @param flags combination of AVPRIV_SLICETHREAD_FLAG_* flags
+ */
+int avpriv_slicethread_create2(AVSliceThread **pctx, void *priv,
+                               void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                               void (*main_func)(void *priv),
+                               int nb_threads, int flags);
+
 /**
  * Execute slice threading.
  * @param ctx slice threading context
@@ -43,6 +64,15 @@ int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
  */
 void avpriv_slicethread_execute(AVSliceThread *ctx, int nb_jobs, int execute_main);
 
+/**
+ * Set the priority of the jobs of this context on the process-wide executor,
+ * see av_executor_execute(). Has no effect if the context uses threads of
+ * its own.
+ * @param ctx slice threading context
+ * @param priority priority, higher values are served first
+ */
+void avpriv_slicethread_set_priority(AVSliceThread *ctx, int priority);
+
 /**
  * Destroy slice threading context.
  * @param pctx pointer to context
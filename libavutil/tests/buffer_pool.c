@@ -0,0 +1,149 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Stress test and contention benchmark for AVBufferPool.
+ *
+ * Without arguments a fixed number of threads hammer a locked and a lockless
+ * pool and verify that no buffer is ever handed out twice at the same time.
+ * With "-b [max_threads] [iterations]" the get/release throughput of both
+ * pool modes is measured for 1 to max_threads threads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/buffer.h"
+#include "libavutil/macros.h"
+#include "libavutil/mem.h"
+#include "libavutil/thread.h"
+#include "libavutil/time.h"
+
+#define BUF_SIZE   64
+#define HELD       4
+
+typedef struct ThreadArg {
+    AVBufferPool *pool;
+    int id;
+    int iterations;
+    int errors;
+} ThreadArg;
+
+static void *worker(void *opaque)
+{
+    ThreadArg *arg = opaque;
+    AVBufferRef *held[HELD] = { NULL };
+
+    for (int i = 0; i < arg->iterations; i++) {
+        AVBufferRef **ref = &held[i % HELD];
+
+        if (*ref) {
+            for (int j = 0; j < BUF_SIZE; j++)
+                if ((*ref)->data[j] != (uint8_t)arg->id)
+                    arg->errors++;
+            av_buffer_unref(ref);
+        }
+        *ref = av_buffer_pool_get(arg->pool);
+        if (!*ref) {
+            arg->errors++;
+            break;
+        }
+        memset((*ref)->data, arg->id, BUF_SIZE);
+    }
+    for (int i = 0; i < HELD; i++)
+        av_buffer_unref(&held[i]);
+
+    return NULL;
+}
+
+static int run(int flags, int nb_threads, int iterations, int64_t *time)
+{
+    AVBufferPool *pool = av_buffer_pool_init3(BUF_SIZE, NULL, NULL, NULL, flags);
+    pthread_t *threads = av_calloc(nb_threads, sizeof(*threads));
+    ThreadArg *args    = av_calloc(nb_threads, sizeof(*args));
+    int64_t start;
+    int errors = 0;
+
+    if (!pool || !threads || !args) {
+        errors = -1;
+        goto end;
+    }
+
+    start = av_gettime_relative();
+    for (int i = 0; i < nb_threads; i++) {
+        args[i].pool       = pool;
+        args[i].id         = i + 1;
+        args[i].iterations = iterations;
+        if (pthread_create(&threads[i], NULL, worker, &args[i])) {
+            nb_threads = i;
+            errors = -1;
+            break;
+        }
+    }
+    for (int i = 0; i < nb_threads; i++) {
+        pthread_join(threads[i], NULL);
+        errors += args[i].errors;
+    }
+    *time = av_gettime_relative() - start;
+
+end:
+    av_buffer_pool_uninit(&pool);
+    av_free(threads);
+    av_free(args);
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct {
+        const char *name;
+        int flags;
+    } modes[] = {
+        { "locked",   0                            },
+        { "lockless", AV_BUFFER_POOL_FLAG_LOCKLESS },
+    };
+    int64_t time;
+    int ret = 0;
+
+    if (argc > 1 && !strcmp(argv[1], "-b")) {
+        int max_threads = argc > 2 ? atoi(argv[2]) : 64;
+        int iterations  = argc > 3 ? atoi(argv[3]) : 200000;
+
+        printf("threads %12s %12s (ns per get/release)\n", modes[0].name, modes[1].name);
+        for (int nb_threads = 1; nb_threads <= max_threads; nb_threads *= 2) {
+            printf("%7d", nb_threads);
+            for (int m = 0; m < FF_ARRAY_ELEMS(modes); m++) {
+                if (run(modes[m].flags, nb_threads, iterations, &time))
+                    return 1;
+                printf(" %12.1f", time * 1000.0 / ((int64_t)nb_threads * iterations));
+            }
+            printf("\n");
+        }
+        return 0;
+    }
+
+    for (int m = 0; m < FF_ARRAY_ELEMS(modes); m++) {
+        int errors = run(modes[m].flags, 8, 20000, &time);
+
+        printf("%s: %s\n", modes[m].name, errors ? "failed" : "ok");
+        ret |= !!errors;
+    }
+
+    return ret;
+}
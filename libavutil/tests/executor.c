@@ -0,0 +1,138 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Several client threads run batches on one executor at the same time.
+ * Every job waits for the previous one to start, like wavefront decoding
+ * does, and some jobs run nested batches. The test checks that all jobs
+ * run exactly once and that no two running jobs of a batch share a
+ * threadnr.
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "libavutil/executor.h"
+#include "libavutil/mem.h"
+#include "libavutil/thread.h"
+#include "libavutil/time.h"
+
+#define NB_CLIENTS     4
+#define NB_BATCHES   200
+#define NB_JOBS       24
+#define MAX_THREADS    3
+
+typedef struct Batch {
+    AVExecutor *executor;
+    int nested;
+    atomic_int started;
+    atomic_int runs[NB_JOBS];
+    atomic_int busy[MAX_THREADS];
+    atomic_int errors;
+} Batch;
+
+static void run_batch(AVExecutor *executor, int priority, int nested, atomic_int *errors);
+
+static void job(void *opaque, int jobnr, int threadnr)
+{
+    Batch *b = opaque;
+    int valid = threadnr >= 0 && threadnr < MAX_THREADS;
+
+    if (!valid || atomic_fetch_add(&b->busy[threadnr], 1))
+        atomic_fetch_add(&b->errors, 1);
+
+    /* jobs start in order, so waiting for a lower job must not deadlock */
+    while (atomic_load(&b->started) < jobnr)
+        av_usleep(1);
+    atomic_fetch_add(&b->started, 1);
+    atomic_fetch_add(&b->runs[jobnr], 1);
+
+    if (!b->nested && jobnr % 8 == 1)
+        run_batch(b->executor, 0, 1, &b->errors);
+
+    if (valid)
+        atomic_fetch_sub(&b->busy[threadnr], 1);
+}
+
+static void run_batch(AVExecutor *executor, int priority, int nested, atomic_int *errors)
+{
+    Batch *b = av_mallocz(sizeof(*b));
+
+    if (!b) {
+        atomic_fetch_add(errors, 1);
+        return;
+    }
+    b->executor = executor;
+    b->nested   = nested;
+
+    if (av_executor_execute(executor, priority, job, b, NB_JOBS, MAX_THREADS) < 0)
+        atomic_fetch_add(errors, 1);
+
+    for (int i = 0; i < NB_JOBS; i++)
+        if (atomic_load(&b->runs[i]) != 1)
+            atomic_fetch_add(errors, 1);
+    atomic_fetch_add(errors, atomic_load(&b->errors));
+    av_free(b);
+}
+
+typedef struct Client {
+    AVExecutor *executor;
+    int priority;
+    atomic_int errors;
+} Client;
+
+static void *client(void *opaque)
+{
+    Client *c = opaque;
+
+    for (int i = 0; i < NB_BATCHES; i++)
+        run_batch(c->executor, c->priority, 0, &c->errors);
+
+    return NULL;
+}
+
+int main(void)
+{
+    AVExecutor *executor = av_executor_alloc(4);
+    pthread_t threads[NB_CLIENTS];
+    Client clients[NB_CLIENTS] = { { 0 } };
+    int nb_threads, errors = 0;
+
+    if (!executor) {
+        fprintf(stderr, "Failed to create the executor\n");
+        return 1;
+    }
+
+    for (nb_threads = 0; nb_threads < NB_CLIENTS; nb_threads++) {
+        clients[nb_threads].executor = executor;
+        clients[nb_threads].priority = nb_threads & 1;
+        if (pthread_create(&threads[nb_threads], NULL, client, &clients[nb_threads])) {
+            errors++;
+            break;
+        }
+    }
+    for (int i = 0; i < nb_threads; i++) {
+        pthread_join(threads[i], NULL);
+        errors += atomic_load(&clients[i].errors);
+    }
+
+    av_executor_free(&executor);
+
+    printf("%s\n", errors ? "failed" : "ok");
+    return !!errors;
+}
@@ -0,0 +1,143 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Test and benchmark for the huge page memory policy.
+ *
+ * Without arguments large blocks are allocated with and without the policy
+ * and through a pool with AV_BUFFER_POOL_FLAG_HUGEPAGES, and checked for
+ * usability. With "-b [size_mib] [numa_node]" a TLB-miss heavy random walk
+ * over a buffer of the given size is timed with the default and the huge
+ * page policy.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/buffer.h"
+#include "libavutil/error.h"
+#include "libavutil/lfg.h"
+#include "libavutil/macros.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"
+
+#define BLOCK_SIZE (4 << 20)
+
+static int check_block(uint8_t *data, size_t size)
+{
+    if (!data)
+        return 1;
+    memset(data, 0x5a, size);
+    return data[0] != 0x5a || data[size - 1] != 0x5a;
+}
+
+static int test_alloc(int flags)
+{
+    uint8_t *data;
+    int ret;
+
+    ret = av_mem_set_policy(flags, -1);
+    if (ret < 0 && ret != AVERROR(ENOSYS))
+        return 1;
+
+    data = av_malloc(BLOCK_SIZE);
+    ret  = check_block(data, BLOCK_SIZE);
+    av_free(data);
+
+    av_mem_set_policy(0, -1);
+    return ret;
+}
+
+static int test_pool(void)
+{
+    AVBufferPool *pool = av_buffer_pool_init3(BLOCK_SIZE + 4096, NULL, NULL, NULL,
+                                              AV_BUFFER_POOL_FLAG_HUGEPAGES);
+    AVBufferRef *buf[2];
+    int ret = 0;
+
+    if (!pool)
+        return 1;
+    for (int i = 0; i < 2; i++) {
+        buf[i] = av_buffer_pool_get(pool);
+        ret |= check_block(buf[i] ? buf[i]->data : NULL, BLOCK_SIZE + 4096);
+    }
+    for (int i = 0; i < 2; i++)
+        av_buffer_unref(&buf[i]);
+    av_buffer_pool_uninit(&pool);
+
+    return ret;
+}
+
+static int64_t random_walk(size_t size, int flags, int numa_node)
+{
+    const size_t nb_pages = size >> 12;
+    uint32_t *data;
+    uint32_t pos = 0;
+    AVLFG lfg;
+    int64_t start, time;
+
+    if (av_mem_set_policy(flags, numa_node) < 0)
+        return -1;
+    data = av_malloc(size);
+    av_mem_set_policy(0, -1);
+    if (!data)
+        return -1;
+
+    /* link every 4 KiB page into one random cycle */
+    for (size_t i = 0; i < nb_pages; i++)
+        data[i << 10] = i;
+    av_lfg_init(&lfg, 0);
+    for (size_t i = nb_pages - 1; i > 0; i--) {
+        size_t j = av_lfg_get(&lfg) % i;
+        FFSWAP(uint32_t, data[i << 10], data[j << 10]);
+    }
+
+    start = av_gettime_relative();
+    for (size_t i = 0; i < 16 * nb_pages; i++)
+        pos = data[(size_t)pos << 10];
+    time = av_gettime_relative() - start;
+
+    av_free(data);
+    return pos == UINT32_MAX ? -1 : time;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && !strcmp(argv[1], "-b")) {
+        size_t size   = (size_t)(argc > 2 ? atoi(argv[2]) : 1024) << 20;
+        int numa_node = argc > 3 ? atoi(argv[3]) : -1;
+        int64_t def   = random_walk(size, 0, numa_node);
+        int64_t huge  = random_walk(size, AV_MEM_POLICY_HUGEPAGES, numa_node);
+
+        if (def < 0 || huge < 0) {
+            fprintf(stderr, "allocation failed or policy not supported\n");
+            return 1;
+        }
+        printf("random page walk over %zu MiB: default %"PRId64" us, hugepages %"PRId64" us\n",
+               size >> 20, def, huge);
+        return 0;
+    }
+
+    printf("default: %s\n",   test_alloc(0) ? "failed" : "ok");
+    printf("hugepages: %s\n", test_alloc(AV_MEM_POLICY_HUGEPAGES) ? "failed" : "ok");
+    printf("pool: %s\n",      test_pool() ? "failed" : "ok");
+
+    return 0;
+}
@@ -81,6 +81,24 @@ int av_gettime_relative_is_monotonic(void)
 #endif
 }
 
+int64_t av_gettime_thread_cpu(void)
+{
+#if HAVE_CLOCK_GETTIME && defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    if (!clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+        return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    return -1;
+#elif HAVE_WINDOWS_H
+    FILETIME c, e, k, u;
+    if (GetThreadTimes(GetCurrentThread(), &c, &e, &k, &u))
+        return (((int64_t)k.dwHighDateTime << 32 | k.dwLowDateTime) +
+                ((int64_t)u.dwHighDateTime << 32 | u.dwLowDateTime)) / 10;
+    return -1;
+#else
+    return -1;
+#endif
+}
+
 int av_usleep(unsigned usec)
 {
 #if HAVE_NANOSLEEP
@@ -43,6 +43,14 @@ int64_t av_gettime_relative(void);
  */
 int av_gettime_relative_is_monotonic(void);
 
+/**
+ * Get the CPU time consumed by the calling thread, in microseconds.
+ *
+ * @return the thread CPU time, or a negative value if it is not available
+ *         on this platform.
+ */
+int64_t av_gettime_thread_cpu(void);
+
 /**
  * Sleep for a period of time.  Although the duration is expressed in
  * microseconds, the actual delay may be rounded to the precision of the
@@ -84,6 +84,9 @@ static const AVOption swscale_options[] = {
     { "threads",         "number of threads",             OFFSET(nb_threads),   AV_OPT_TYPE_INT, {.i64 = 1 }, 0, INT_MAX, VE, "threads" },
         { "auto",        NULL,                            0,                  AV_OPT_TYPE_CONST, {.i64 = 0 },    .flags = VE, "threads" },
 
+    { "tile_width",      "scale in vertical strips of this width", OFFSET(tile_width), AV_OPT_TYPE_INT, {.i64 = 0 }, -1, INT_MAX, VE, "tile_width" },
+        { "auto",        "fit the strips in the cache",   0,                  AV_OPT_TYPE_CONST, {.i64 = -1 },   .flags = VE, "tile_width" },
+
     { NULL }
 };
 
@@ -91,6 +91,20 @@ void (*interleaveBytes)(const uint8_t *src1, const uint8_t *src2, uint8_t *dst,
 void (*deinterleaveBytes)(const uint8_t *src, uint8_t *dst1, uint8_t *dst2,
                           int width, int height, int srcStride,
                           int dst1Stride, int dst2Stride);
+void (*interleaveWords)(const uint16_t *src1, const uint16_t *src2,
+                        uint16_t *dst, int width, int shift);
+void (*deinterleaveWords)(const uint16_t *src, uint16_t *dst1, uint16_t *dst2,
+                          int width, int shift);
+void (*shiftWords)(const uint16_t *src, uint16_t *dst, int width, int shift);
+void (*yuyv16toyuv422)(uint16_t *ydst, uint16_t *udst, uint16_t *vdst,
+                       const uint16_t *src, int width, int shift);
+void (*yuv422toyuyv16)(const uint16_t *ysrc, const uint16_t *usrc,
+                       const uint16_t *vsrc, uint16_t *dst, int width,
+                       int shift);
+void (*x2rgb10togbrp10)(const uint8_t *src, uint16_t *gdst, uint16_t *bdst,
+                        uint16_t *rdst, int width);
+void (*gbrp10tox2rgb10)(const uint16_t *gsrc, const uint16_t *bsrc,
+                        const uint16_t *rsrc, uint8_t *dst, int width);
 void (*vu9_to_vu12)(const uint8_t *src1, const uint8_t *src2,
                     uint8_t *dst1, uint8_t *dst2,
                     int width, int height,
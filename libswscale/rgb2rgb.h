@@ -142,6 +142,59 @@ extern void (*deinterleaveBytes)(const uint8_t *src, uint8_t *dst1, uint8_t *dst
                                  int width, int height, int srcStride,
                                  int dst1Stride, int dst2Stride);
 
+/**
+ * The following functions operate on single lines of native endian 16-bit
+ * samples, width is the number of output samples per plane.
+ */
+
+/**
+ * Interleave two lines, shifting all samples left by shift bits.
+ */
+extern void (*interleaveWords)(const uint16_t *src1, const uint16_t *src2,
+                               uint16_t *dst, int width, int shift);
+
+/**
+ * Deinterleave a line, shifting all samples right by shift bits.
+ */
+extern void (*deinterleaveWords)(const uint16_t *src, uint16_t *dst1,
+                                 uint16_t *dst2, int width, int shift);
+
+/**
+ * Copy a line, shifting all samples left by shift bits if shift is
+ * positive and right by -shift bits otherwise.
+ */
+extern void (*shiftWords)(const uint16_t *src, uint16_t *dst, int width,
+                          int shift);
+
+/**
+ * Split a line of 16-bit YUYV (e.g. Y210) into planes, shifting all samples
+ * right by shift bits. width is the number of luma samples and must be even.
+ */
+extern void (*yuyv16toyuv422)(uint16_t *ydst, uint16_t *udst, uint16_t *vdst,
+                              const uint16_t *src, int width, int shift);
+
+/**
+ * Pack planar 4:2:2 lines into a line of 16-bit YUYV (e.g. Y210), shifting
+ * all samples left by shift bits. width is the number of luma samples and
+ * must be even.
+ */
+extern void (*yuv422toyuyv16)(const uint16_t *ysrc, const uint16_t *usrc,
+                              const uint16_t *vsrc, uint16_t *dst, int width,
+                              int shift);
+
+/**
+ * Convert a line of X2RGB10 to GBRP10, swap rdst and bdst for X2BGR10.
+ */
+extern void (*x2rgb10togbrp10)(const uint8_t *src, uint16_t *gdst,
+                               uint16_t *bdst, uint16_t *rdst, int width);
+
+/**
+ * Convert a line of GBRP10 to X2RGB10, swap rsrc and bsrc for X2BGR10.
+ * Samples above 1023 are clipped.
+ */
+extern void (*gbrp10tox2rgb10)(const uint16_t *gsrc, const uint16_t *bsrc,
+                               const uint16_t *rsrc, uint8_t *dst, int width);
+
 extern void (*vu9_to_vu12)(const uint8_t *src1, const uint8_t *src2,
                            uint8_t *dst1, uint8_t *dst2,
                            int width, int height,
@@ -743,6 +743,94 @@ static void deinterleaveBytes_c(const uint8_t *src, uint8_t *dst1, uint8_t *dst2
     }
 }
 
+static void interleaveWords_c(const uint16_t *src1, const uint16_t *src2,
+                              uint16_t *dst, int width, int shift)
+{
+    int w;
+
+    for (w = 0; w < width; w++) {
+        dst[2 * w + 0] = src1[w] << shift;
+        dst[2 * w + 1] = src2[w] << shift;
+    }
+}
+
+static void deinterleaveWords_c(const uint16_t *src, uint16_t *dst1,
+                                uint16_t *dst2, int width, int shift)
+{
+    int w;
+
+    for (w = 0; w < width; w++) {
+        dst1[w] = src[2 * w + 0] >> shift;
+        dst2[w] = src[2 * w + 1] >> shift;
+    }
+}
+
+static void shiftWords_c(const uint16_t *src, uint16_t *dst, int width,
+                         int shift)
+{
+    int w;
+
+    if (shift >= 0) {
+        for (w = 0; w < width; w++)
+            dst[w] = src[w] << shift;
+    } else {
+        for (w = 0; w < width; w++)
+            dst[w] = src[w] >> -shift;
+    }
+}
+
+static void yuyv16toyuv422_c(uint16_t *ydst, uint16_t *udst, uint16_t *vdst,
+                             const uint16_t *src, int width, int shift)
+{
+    int w;
+
+    for (w = 0; w < width >> 1; w++) {
+        ydst[2 * w + 0] = src[4 * w + 0] >> shift;
+        udst[w]         = src[4 * w + 1] >> shift;
+        ydst[2 * w + 1] = src[4 * w + 2] >> shift;
+        vdst[w]         = src[4 * w + 3] >> shift;
+    }
+}
+
+static void yuv422toyuyv16_c(const uint16_t *ysrc, const uint16_t *usrc,
+                             const uint16_t *vsrc, uint16_t *dst, int width,
+                             int shift)
+{
+    int w;
+
+    for (w = 0; w < width >> 1; w++) {
+        dst[4 * w + 0] = ysrc[2 * w + 0] << shift;
+        dst[4 * w + 1] = usrc[w]         << shift;
+        dst[4 * w + 2] = ysrc[2 * w + 1] << shift;
+        dst[4 * w + 3] = vsrc[w]         << shift;
+    }
+}
+
+static void x2rgb10togbrp10_c(const uint8_t *src, uint16_t *gdst,
+                              uint16_t *bdst, uint16_t *rdst, int width)
+{
+    const uint32_t *s = (const uint32_t *)src;
+    int w;
+
+    for (w = 0; w < width; w++) {
+        uint32_t p = s[w];
+        bdst[w] =  p        & 0x3FF;
+        gdst[w] = (p >> 10) & 0x3FF;
+        rdst[w] = (p >> 20) & 0x3FF;
+    }
+}
+
+static void gbrp10tox2rgb10_c(const uint16_t *gsrc, const uint16_t *bsrc,
+                              const uint16_t *rsrc, uint8_t *dst, int width)
+{
+    uint32_t *d = (uint32_t *)dst;
+    int w;
+
+    for (w = 0; w < width; w++)
+        d[w] = 3U << 30 | (uint32_t)FFMIN(rsrc[w], 0x3FF) << 20 |
+               FFMIN(gsrc[w], 0x3FF) << 10 | FFMIN(bsrc[w], 0x3FF);
+}
+
 static inline void vu9_to_vu12_c(const uint8_t *src1, const uint8_t *src2,
                                  uint8_t *dst1, uint8_t *dst2,
                                  int width, int height,
@@ -982,6 +1070,13 @@ static av_cold void rgb2rgb_init_c(void)
     ff_rgb24toyv12     = ff_rgb24toyv12_c;
     interleaveBytes    = interleaveBytes_c;
     deinterleaveBytes  = deinterleaveBytes_c;
+    interleaveWords    = interleaveWords_c;
+    deinterleaveWords  = deinterleaveWords_c;
+    shiftWords         = shiftWords_c;
+    yuyv16toyuv422     = yuyv16toyuv422_c;
+    yuv422toyuyv16     = yuv422toyuyv16_c;
+    x2rgb10togbrp10    = x2rgb10togbrp10_c;
+    gbrp10tox2rgb10    = gbrp10tox2rgb10_c;
     vu9_to_vu12        = vu9_to_vu12_c;
     yvu9_to_yuy2       = yvu9_to_yuy2_c;
 
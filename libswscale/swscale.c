@@ -879,6 +879,47 @@ static int scale_cascaded(SwsContext *c,
     return ret;
 }
 
+/**
+ * Scale each vertical strip of the image with its tile context. The tiles
+ * keep their own line buffers, so they are all fed the same slices.
+ */
+static int swscale_tiles(SwsContext *c, const uint8_t *src[],
+                         const int srcStride[], int srcSliceY, int srcSliceH,
+                         uint8_t *dst[], const int dstStride[],
+                         int dstSliceY, int dstSliceH)
+{
+    int ret = 0;
+
+    for (int i = 0; i < c->nb_tile_ctx; i++) {
+        SwsContext *t = c->tile_ctx[i];
+        const uint8_t *tile_src[4];
+        uint8_t *tile_dst[4];
+        // swscale() modifies the strides
+        int tile_srcStride[4];
+        int tile_dstStride[4];
+
+        for (int j = 0; j < 4; j++) {
+            tile_src[j] = src[j] ? src[j] + t->tile_src_offset[j] : NULL;
+            tile_dst[j] = dst[j] ? dst[j] + t->tile_dst_offset[j] : NULL;
+        }
+        memcpy(tile_srcStride, srcStride, sizeof(tile_srcStride));
+        memcpy(tile_dstStride, dstStride, sizeof(tile_dstStride));
+
+        if (usePal(c->srcFormat)) {
+            memcpy(t->pal_yuv, c->pal_yuv, sizeof(c->pal_yuv));
+            memcpy(t->pal_rgb, c->pal_rgb, sizeof(c->pal_rgb));
+        }
+
+        ret = swscale(t, tile_src, tile_srcStride, srcSliceY, srcSliceH,
+                      tile_dst, tile_dstStride, dstSliceY, dstSliceH);
+        if (ret < 0)
+            return ret;
+    }
+
+    c->dstY = c->tile_ctx[c->nb_tile_ctx - 1]->dstY;
+    return ret;
+}
+
 static int scale_internal(SwsContext *c,
                           const uint8_t * const srcSlice[], const int srcStride[],
                           int srcSliceY, int srcSliceH,
@@ -1042,6 +1083,9 @@ static int scale_internal(SwsContext *c,
                                   dst2, dstStride2);
         if (scale_dst)
             dst2[0] += dstSliceY * dstStride2[0];
+    } else if (c->nb_tile_ctx) {
+        ret = swscale_tiles(c, src2, srcStride2, srcSliceY_internal, srcSliceH,
+                            dst2, dstStride2, dstSliceY, dstSliceH);
     } else {
         ret = swscale(c, src2, srcStride2, srcSliceY_internal, srcSliceH,
                       dst2, dstStride2, dstSliceY, dstSliceH);
@@ -1197,6 +1241,148 @@ int sws_scale_frame(struct SwsContext *c, AVFrame *dst, const AVFrame *src)
     return ret;
 }
 
+/* source bytes per band fed to all the contexts of sws_scale_frame_multi() */
+#define MULTI_BAND_SIZE (256 * 1024)
+/* minimum band height, in vertical filter windows of the tallest context */
+#define MULTI_BAND_MIN_WINDOWS 8
+
+/* number of source rows, from the top, needed to output dst row y */
+static int multi_src_rows(const SwsContext *c, int y)
+{
+    const int chr_y = y >> c->chrDstVSubSample;
+    const int lum_end = c->vLumFilterPos[y] + c->vLumFilterSize;
+    const int chr_end = (c->vChrFilterPos[chr_y] + c->vChrFilterSize) << c->chrSrcVSubSample;
+
+    return FFMAX(lum_end, chr_end);
+}
+
+/* whether c has to be run on the whole source at once in sws_scale_frame_multi() */
+static int multi_needs_full_frame(const SwsContext *c, enum AVPixelFormat src_format)
+{
+    /* cascaded contexts and error diffusion carry state across rows, and
+     * bayer input is converted in row pairs */
+    if (c->cascaded_context[0] || c->dither == SWS_DITHER_ED || isBayer(src_format))
+        return 1;
+    /* scale_internal() copies or converts the whole source to a scratch
+     * buffer on every call for these */
+    if (c->src0Alpha && !c->dst0Alpha && isALPHA(c->dstFormat))
+        return 1;
+    if (c->srcXYZ && !(c->dstXYZ && c->srcW == c->dstW && c->srcH == c->dstH))
+        return 1;
+    return 0;
+}
+
+int sws_scale_frame_multi(struct SwsContext **c, AVFrame **dst, int nb,
+                          const AVFrame *src)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(src->format);
+    int macro_height, band_height, min_height = 1, started = 0, ret = 0;
+    int *dst_done;
+    size_t row_size = 0;
+
+    if (nb <= 0 || !desc)
+        return AVERROR(EINVAL);
+
+    for (int i = 0; i < nb; i++) {
+        if (c[i]->srcW != src->width || c[i]->srcH != src->height) {
+            av_log(c[i], AV_LOG_ERROR, "Source frame does not match the context\n");
+            return AVERROR(EINVAL);
+        }
+    }
+
+    /* first destination row not output yet, per context */
+    dst_done = av_calloc(nb, sizeof(*dst_done));
+    if (!dst_done)
+        return AVERROR(ENOMEM);
+
+    for (; started < nb; started++) {
+        ret = sws_frame_start(c[started], dst[started], src);
+        if (ret < 0)
+            goto end;
+    }
+
+    /* Contexts which need the whole source at once, or carry state from
+     * one output row to the next, are run first. The others are run on
+     * destination slices, so the output does not depend on where the
+     * bands fall. */
+    for (int i = 0; i < nb; i++) {
+        SwsContext *ci = c[i]->nb_slice_ctx ? c[i]->slice_ctx[0] : c[i];
+
+        if (!multi_needs_full_frame(ci, src->format)) {
+            if (!ci->convert_unscaled)
+                min_height = FFMAX(min_height,
+                                   FFMAX(ci->vLumFilterSize,
+                                         ci->vChrFilterSize << ci->chrSrcVSubSample));
+            continue;
+        }
+
+        ret = scale_internal(ci, (const uint8_t * const *)src->data,
+                             src->linesize, 0, src->height,
+                             c[i]->frame_dst->data, c[i]->frame_dst->linesize,
+                             0, ci->dstH);
+        if (ret < 0)
+            goto end;
+        dst_done[i] = ci->dstH;
+    }
+
+    for (int i = 0; i < 4 && src->data[i]; i++)
+        row_size += FFABS(src->linesize[i]);
+    macro_height = 1 << desc->log2_chroma_h;
+    band_height  = FFMAX(MULTI_BAND_SIZE / FFMAX(row_size, 1), 1);
+    band_height  = FFMAX(band_height, MULTI_BAND_MIN_WINDOWS * min_height);
+    band_height  = FFALIGN(band_height, macro_height);
+
+    for (int y = band_height; y < src->height + band_height; y += band_height) {
+        for (int i = 0; i < nb; i++) {
+            SwsContext *ci = c[i]->nb_slice_ctx ? c[i]->slice_ctx[0] : c[i];
+            const AVFrame *frame_dst = c[i]->frame_dst;
+            const int align = ci->dst_slice_align;
+            int dst_end = dst_done[i];
+            uint8_t *dst_slice[4] = { NULL };
+
+            if (dst_end == ci->dstH)
+                continue;
+
+            /* output every row whose source rows lie above the band end */
+            if (y >= src->height)
+                dst_end = ci->dstH;
+            else if (ci->convert_unscaled)
+                dst_end = y;
+            else
+                while (dst_end < ci->dstH && multi_src_rows(ci, dst_end) <= y)
+                    dst_end++;
+            if (dst_end < ci->dstH)
+                dst_end -= dst_end % align;
+            if (dst_end <= dst_done[i])
+                continue;
+
+            /* scale_internal() takes the slice rows, not the whole frame */
+            for (int p = 0; p < 4 && frame_dst->data[p]; p++) {
+                const int vshift = (p == 1 || p == 2) ? ci->chrDstVSubSample : 0;
+
+                dst_slice[p] = frame_dst->data[p] +
+                               frame_dst->linesize[p] * (ptrdiff_t)(dst_done[i] >> vshift);
+            }
+
+            ret = scale_internal(ci, (const uint8_t * const *)src->data,
+                                 src->linesize, 0, src->height,
+                                 dst_slice, frame_dst->linesize,
+                                 dst_done[i], dst_end - dst_done[i]);
+            if (ret < 0)
+                goto end;
+            dst_done[i] = dst_end;
+        }
+    }
+    ret = 0;
+
+end:
+    while (started--)
+        sws_frame_end(c[started]);
+    av_free(dst_done);
+
+    return ret;
+}
+
 /**
  * swscale wrapper, so we don't need to export the SwsContext.
  * Assumes planar YUV to be in YUV order instead of YVU.
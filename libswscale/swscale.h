@@ -236,6 +236,27 @@ int sws_scale(struct SwsContext *c, const uint8_t *const srcSlice[],
  */
 int sws_scale_frame(struct SwsContext *c, AVFrame *dst, const AVFrame *src);
 
+/**
+ * Scale source data from src into several destination frames, e.g. the
+ * renditions of a resolution ladder.
+ *
+ * All the contexts must have been initialized with the dimensions and pixel
+ * format of src, and may differ in everything else. The result is the same
+ * as calling sws_scale_frame() for every context, but the source is walked
+ * only once: each horizontal band of it is fed to all the contexts in turn
+ * while it is still in the CPU cache.
+ *
+ * @param c   array of nb scaling contexts
+ * @param dst array of nb destination frames, dst[i] being written by c[i].
+ *            See documentation for sws_frame_start() for more details.
+ * @param nb  number of contexts and destination frames
+ * @param src The source frame.
+ *
+ * @return 0 on success, a negative AVERROR code on failure
+ */
+int sws_scale_frame_multi(struct SwsContext **c, AVFrame **dst, int nb,
+                          const AVFrame *src);
+
 /**
  * Initialize the scaling process for a given pair of source/destination frames.
  * Must be called before any calls to sws_send_slice() and sws_receive_slice().
@@ -386,6 +407,55 @@ struct SwsContext *sws_getCachedContext(struct SwsContext *context,
                                         int flags, SwsFilter *srcFilter,
                                         SwsFilter *dstFilter, const double *param);
 
+/**
+ * A thread-safe pool of initialized scaling contexts.
+ *
+ * Applications that repeatedly create and free contexts with recurring
+ * parameters (e.g. one per request in a thumbnailing service) can get them
+ * from a pool instead, which hands out a previously released context with
+ * matching parameters when one is available, and only initializes a new
+ * one otherwise.
+ */
+typedef struct SwsContextPool SwsContextPool;
+
+/**
+ * Allocate an empty context pool.
+ *
+ * @param max_idle maximum number of released contexts kept for reuse, the
+ *                 least recently released ones are freed beyond that
+ * @return the pool, or NULL on allocation failure
+ */
+SwsContextPool *sws_context_pool_alloc(int max_idle);
+
+/**
+ * Free the pool and all the idle contexts it holds. All the contexts taken
+ * from the pool must have been released before.
+ */
+void sws_context_pool_free(SwsContextPool **pool);
+
+/**
+ * Get a scaling context for the given parameters, which are the same as
+ * for sws_getContext() without user filters.
+ *
+ * A reused context has its per-frame state and its colorspace details reset,
+ * so that it produces the same output as a newly allocated one.
+ *
+ * @return a context, which must be given back with sws_context_pool_release(),
+ *         or NULL on failure
+ */
+struct SwsContext *sws_context_pool_get(SwsContextPool *pool,
+                                        int srcW, int srcH, enum AVPixelFormat srcFormat,
+                                        int dstW, int dstH, enum AVPixelFormat dstFormat,
+                                        int flags, const double *param);
+
+/**
+ * Give a context obtained from sws_context_pool_get() back to the pool.
+ * Contexts not originating from the pool are freed.
+ *
+ * @param c pointer to the context, set to NULL on return
+ */
+void sws_context_pool_release(SwsContextPool *pool, struct SwsContext **c);
+
 /**
  * Convert an 8-bit paletted frame into a frame with a color depth of 32 bits.
  *
@@ -676,6 +676,18 @@ typedef struct SwsContext {
     unsigned int dst_slice_align;
     atomic_int   stride_unaligned_warned;
     atomic_int   data_unaligned_warned;
+
+    /* Column tiling: very wide images are scaled as vertical strips, each
+     * by its own tile context, so that the intermediate lines needed by the
+     * vertical scaler stay in cache. */
+    int                 tile_width;      ///< Requested tile width, 0 = disabled, -1 = automatic.
+    struct SwsContext **tile_ctx;
+    int              nb_tile_ctx;
+    struct SwsContext  *tile_parent;     ///< Context whose output a tile context is a strip of.
+    int                 tile_x;          ///< First output column of a tile context in its parent.
+    int                 tile_src_x;      ///< First input column used by a tile context.
+    int                 tile_src_offset[4]; ///< Byte offsets of tile_src_x in the input planes.
+    int                 tile_dst_offset[4]; ///< Byte offsets of tile_x in the output planes.
 } SwsContext;
 //FIXME check init (where 0)
 
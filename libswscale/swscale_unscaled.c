@@ -221,52 +221,152 @@ static int nv24ToPlanarWrapper(SwsContext *c, const uint8_t *src[],
     return srcSliceH;
 }
 
-static int planarToP01xWrapper(SwsContext *c, const uint8_t *src8[],
+static int planarToP01xWrapper(SwsContext *c, const uint8_t *src[],
                                int srcStride[], int srcSliceY,
                                int srcSliceH, uint8_t *dstParam8[],
                                int dstStride[])
 {
     const AVPixFmtDescriptor *src_format = av_pix_fmt_desc_get(c->srcFormat);
     const AVPixFmtDescriptor *dst_format = av_pix_fmt_desc_get(c->dstFormat);
-    const uint16_t **src = (const uint16_t**)src8;
-    uint16_t *dstY = (uint16_t*)(dstParam8[0] + dstStride[0] * srcSliceY);
-    uint16_t *dstUV = (uint16_t*)(dstParam8[1] + dstStride[1] * srcSliceY / 2);
-    int x, y;
+    const int vsub = src_format->log2_chroma_h;
+    const int chrSliceH = AV_CEIL_RSHIFT(srcSliceH, vsub);
+    const uint8_t *src0 = src[0], *src1 = src[1], *src2 = src[2];
+    uint8_t *dstY  = dstParam8[0] + dstStride[0] * srcSliceY;
+    uint8_t *dstUV = dstParam8[1] + dstStride[1] * (srcSliceY >> vsub);
+    int y;
 
     /* Calculate net shift required for values. */
-    const int shift[3] = {
+    const int shift[2] = {
         dst_format->comp[0].depth + dst_format->comp[0].shift -
         src_format->comp[0].depth - src_format->comp[0].shift,
         dst_format->comp[1].depth + dst_format->comp[1].shift -
         src_format->comp[1].depth - src_format->comp[1].shift,
-        dst_format->comp[2].depth + dst_format->comp[2].shift -
-        src_format->comp[2].depth - src_format->comp[2].shift,
     };
 
     av_assert0(!(srcStride[0] % 2 || srcStride[1] % 2 || srcStride[2] % 2 ||
                  dstStride[0] % 2 || dstStride[1] % 2));
 
     for (y = 0; y < srcSliceH; y++) {
-        uint16_t *tdstY = dstY;
-        const uint16_t *tsrc0 = src[0];
-        for (x = c->srcW; x > 0; x--) {
-            *tdstY++ = *tsrc0++ << shift[0];
+        shiftWords((const uint16_t *)src0, (uint16_t *)dstY, c->srcW, shift[0]);
+        src0 += srcStride[0];
+        dstY += dstStride[0];
+    }
+
+    for (y = 0; y < chrSliceH; y++) {
+        interleaveWords((const uint16_t *)src1, (const uint16_t *)src2,
+                        (uint16_t *)dstUV, c->chrSrcW, shift[1]);
+        src1  += srcStride[1];
+        src2  += srcStride[2];
+        dstUV += dstStride[1];
+    }
+
+    return srcSliceH;
+}
+
+static int p01xToPlanarWrapper(SwsContext *c, const uint8_t *src[],
+                               int srcStride[], int srcSliceY,
+                               int srcSliceH, uint8_t *dstParam8[],
+                               int dstStride[])
+{
+    const AVPixFmtDescriptor *src_format = av_pix_fmt_desc_get(c->srcFormat);
+    const AVPixFmtDescriptor *dst_format = av_pix_fmt_desc_get(c->dstFormat);
+    const int vsub = src_format->log2_chroma_h;
+    const int chrSliceH = AV_CEIL_RSHIFT(srcSliceH, vsub);
+    const uint8_t *src0 = src[0], *src1 = src[1];
+    uint8_t *dstY = dstParam8[0] + dstStride[0] * srcSliceY;
+    uint8_t *dstU = dstParam8[1] + dstStride[1] * (srcSliceY >> vsub);
+    uint8_t *dstV = dstParam8[2] + dstStride[2] * (srcSliceY >> vsub);
+    int y;
+
+    /* Calculate net shift required for values. */
+    const int shift[2] = {
+        src_format->comp[0].depth + src_format->comp[0].shift -
+        dst_format->comp[0].depth - dst_format->comp[0].shift,
+        src_format->comp[1].depth + src_format->comp[1].shift -
+        dst_format->comp[1].depth - dst_format->comp[1].shift,
+    };
+
+    av_assert0(!(srcStride[0] % 2 || srcStride[1] % 2 ||
+                 dstStride[0] % 2 || dstStride[1] % 2 || dstStride[2] % 2));
+
+    for (y = 0; y < srcSliceH; y++) {
+        shiftWords((const uint16_t *)src0, (uint16_t *)dstY, c->srcW, -shift[0]);
+        src0 += srcStride[0];
+        dstY += dstStride[0];
+    }
+
+    for (y = 0; y < chrSliceH; y++) {
+        deinterleaveWords((const uint16_t *)src1, (uint16_t *)dstU,
+                          (uint16_t *)dstV, c->chrSrcW, shift[1]);
+        src1 += srcStride[1];
+        dstU += dstStride[1];
+        dstV += dstStride[2];
+    }
+
+    return srcSliceH;
+}
+
+static int y210ToPlanarWrapper(SwsContext *c, const uint8_t *src[],
+                               int srcStride[], int srcSliceY,
+                               int srcSliceH, uint8_t *dstParam8[],
+                               int dstStride[])
+{
+    const AVPixFmtDescriptor *dst_format = av_pix_fmt_desc_get(c->dstFormat);
+    const int shift = 16 - dst_format->comp[0].depth;
+    const int w = c->srcW;
+    const uint8_t *src0 = src[0];
+    uint8_t *dstY = dstParam8[0] + dstStride[0] * srcSliceY;
+    uint8_t *dstU = dstParam8[1] + dstStride[1] * srcSliceY;
+    uint8_t *dstV = dstParam8[2] + dstStride[2] * srcSliceY;
+    int y;
+
+    for (y = 0; y < srcSliceH; y++) {
+        const uint16_t *s = (const uint16_t *)src0;
+
+        yuyv16toyuv422((uint16_t *)dstY, (uint16_t *)dstU, (uint16_t *)dstV,
+                       s, w & ~1, shift);
+        if (w & 1) {
+            ((uint16_t *)dstY)[w - 1]  = s[2 * w - 2] >> shift;
+            ((uint16_t *)dstU)[w >> 1] = s[2 * w - 1] >> shift;
+            ((uint16_t *)dstV)[w >> 1] = s[2 * w + 1] >> shift;
         }
-        src[0] += srcStride[0] / 2;
-        dstY += dstStride[0] / 2;
+        src0 += srcStride[0];
+        dstY += dstStride[0];
+        dstU += dstStride[1];
+        dstV += dstStride[2];
+    }
 
-        if (!(y & 1)) {
-            uint16_t *tdstUV = dstUV;
-            const uint16_t *tsrc1 = src[1];
-            const uint16_t *tsrc2 = src[2];
-            for (x = c->srcW / 2; x > 0; x--) {
-                *tdstUV++ = *tsrc1++ << shift[1];
-                *tdstUV++ = *tsrc2++ << shift[2];
-            }
-            src[1] += srcStride[1] / 2;
-            src[2] += srcStride[2] / 2;
-            dstUV += dstStride[1] / 2;
+    return srcSliceH;
+}
+
+static int planarToY210Wrapper(SwsContext *c, const uint8_t *src[],
+                               int srcStride[], int srcSliceY,
+                               int srcSliceH, uint8_t *dstParam8[],
+                               int dstStride[])
+{
+    const AVPixFmtDescriptor *src_format = av_pix_fmt_desc_get(c->srcFormat);
+    const int shift = 16 - src_format->comp[0].depth;
+    const int w = c->srcW;
+    const uint8_t *src0 = src[0], *src1 = src[1], *src2 = src[2];
+    uint8_t *dst = dstParam8[0] + dstStride[0] * srcSliceY;
+    int y;
+
+    for (y = 0; y < srcSliceH; y++) {
+        const uint16_t *sy = (const uint16_t *)src0;
+        uint16_t *d = (uint16_t *)dst;
+
+        yuv422toyuyv16(sy, (const uint16_t *)src1, (const uint16_t *)src2,
+                       d, w & ~1, shift);
+        if (w & 1) {
+            d[2 * w - 2] = sy[w - 1] << shift;
+            d[2 * w - 1] = ((const uint16_t *)src1)[w >> 1] << shift;
+            d[2 * w]     = sy[w - 1] << shift;
+            d[2 * w + 1] = ((const uint16_t *)src2)[w >> 1] << shift;
         }
+        src0 += srcStride[0];
+        src1 += srcStride[1];
+        src2 += srcStride[2];
+        dst  += dstStride[0];
     }
 
     return srcSliceH;
@@ -938,6 +1038,52 @@ static int planarRgb16ToRgb16Wrapper(SwsContext *c, const uint8_t *src[],
     return srcSliceH;
 }
 
+static int x2rgb10ToPlanarRgb10Wrapper(SwsContext *c, const uint8_t *src[],
+                                       int srcStride[], int srcSliceY, int srcSliceH,
+                                       uint8_t *dst[], int dstStride[])
+{
+    const int swap = c->srcFormat == AV_PIX_FMT_X2BGR10;
+    const uint8_t *src0 = src[0];
+    uint8_t *dstG = dst[0] + dstStride[0] * srcSliceY;
+    uint8_t *dstB = dst[1 + swap] + dstStride[1 + swap] * srcSliceY;
+    uint8_t *dstR = dst[2 - swap] + dstStride[2 - swap] * srcSliceY;
+    int y;
+
+    for (y = 0; y < srcSliceH; y++) {
+        x2rgb10togbrp10(src0, (uint16_t *)dstG, (uint16_t *)dstB,
+                        (uint16_t *)dstR, c->srcW);
+        src0 += srcStride[0];
+        dstG += dstStride[0];
+        dstB += dstStride[1 + swap];
+        dstR += dstStride[2 - swap];
+    }
+
+    return srcSliceH;
+}
+
+static int planarRgb10ToX2rgb10Wrapper(SwsContext *c, const uint8_t *src[],
+                                       int srcStride[], int srcSliceY, int srcSliceH,
+                                       uint8_t *dst[], int dstStride[])
+{
+    const int swap = c->dstFormat == AV_PIX_FMT_X2BGR10;
+    const uint8_t *srcG = src[0];
+    const uint8_t *srcB = src[1 + swap];
+    const uint8_t *srcR = src[2 - swap];
+    uint8_t *dst0 = dst[0] + dstStride[0] * srcSliceY;
+    int y;
+
+    for (y = 0; y < srcSliceH; y++) {
+        gbrp10tox2rgb10((const uint16_t *)srcG, (const uint16_t *)srcB,
+                        (const uint16_t *)srcR, dst0, c->srcW);
+        srcG += srcStride[0];
+        srcB += srcStride[1 + swap];
+        srcR += srcStride[2 - swap];
+        dst0 += dstStride[0];
+    }
+
+    return srcSliceH;
+}
+
 static void gbr24ptopacked24(const uint8_t *src[], int srcStride[],
                              uint8_t *dst, int dstStride, int srcSliceH,
                              int width)
@@ -1971,6 +2117,24 @@ static int planarCopyWrapper(SwsContext *c, const uint8_t *src[],
      (src_fmt == pix_fmt ## LE && dst_fmt == pix_fmt ## BE))
 
 
+/* Planar or semi-planar YUV with 9 to 16 bit samples in native endian words */
+static int isPlanarYUV16NE(enum AVPixelFormat pix_fmt)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(pix_fmt);
+    return isPlanarYUV(pix_fmt) && desc->comp[0].depth > 8 &&
+           !(desc->flags & AV_PIX_FMT_FLAG_FLOAT) &&
+           !!(desc->flags & AV_PIX_FMT_FLAG_BE) == HAVE_BIGENDIAN;
+}
+
+static int sameChromaSubsampling(enum AVPixelFormat src_fmt,
+                                 enum AVPixelFormat dst_fmt)
+{
+    const AVPixFmtDescriptor *src = av_pix_fmt_desc_get(src_fmt);
+    const AVPixFmtDescriptor *dst = av_pix_fmt_desc_get(dst_fmt);
+    return src->log2_chroma_w == dst->log2_chroma_w &&
+           src->log2_chroma_h == dst->log2_chroma_h;
+}
+
 void ff_get_unscaled_swscale(SwsContext *c)
 {
     const enum AVPixelFormat srcFormat = c->srcFormat;
@@ -2019,6 +2183,35 @@ void ff_get_unscaled_swscale(SwsContext *c)
         (dstFormat == AV_PIX_FMT_P010 || dstFormat == AV_PIX_FMT_P016)) {
         c->convert_unscaled = planarToP01xWrapper;
     }
+    /* yuv4xxp1x_to_p01x, only without loss of precision otherwise */
+    if (isPlanarYUV16NE(srcFormat) && !isSemiPlanarYUV(srcFormat) &&
+        isPlanarYUV16NE(dstFormat) &&  isSemiPlanarYUV(dstFormat) &&
+        sameChromaSubsampling(srcFormat, dstFormat) &&
+        av_pix_fmt_desc_get(dstFormat)->comp[0].depth >=
+        av_pix_fmt_desc_get(srcFormat)->comp[0].depth) {
+        c->convert_unscaled = planarToP01xWrapper;
+    }
+    /* p01x_to_yuv4xxp1x */
+    if (isPlanarYUV16NE(srcFormat) &&  isSemiPlanarYUV(srcFormat) &&
+        isPlanarYUV16NE(dstFormat) && !isSemiPlanarYUV(dstFormat) &&
+        !isALPHA(dstFormat) && sameChromaSubsampling(srcFormat, dstFormat) &&
+        av_pix_fmt_desc_get(dstFormat)->comp[0].depth ==
+        av_pix_fmt_desc_get(srcFormat)->comp[0].depth) {
+        c->convert_unscaled = p01xToPlanarWrapper;
+    }
+    /* y210_to_yuv422p1x */
+    if (srcFormat == AV_PIX_FMT_Y210 &&
+        isPlanarYUV16NE(dstFormat) && !isSemiPlanarYUV(dstFormat) &&
+        !isALPHA(dstFormat) && sameChromaSubsampling(srcFormat, dstFormat) &&
+        av_pix_fmt_desc_get(dstFormat)->comp[0].depth == 10) {
+        c->convert_unscaled = y210ToPlanarWrapper;
+    }
+    /* yuv422p10_to_y210 */
+    if (isPlanarYUV16NE(srcFormat) && !isSemiPlanarYUV(srcFormat) &&
+        dstFormat == AV_PIX_FMT_Y210 && sameChromaSubsampling(srcFormat, dstFormat) &&
+        av_pix_fmt_desc_get(srcFormat)->comp[0].depth == 10) {
+        c->convert_unscaled = planarToY210Wrapper;
+    }
     /* yuv420p_to_p01xle */
     if ((srcFormat == AV_PIX_FMT_YUV420P || srcFormat == AV_PIX_FMT_YUVA420P) &&
         (dstFormat == AV_PIX_FMT_P010LE || dstFormat == AV_PIX_FMT_P016LE)) {
@@ -2094,6 +2287,14 @@ void ff_get_unscaled_swscale(SwsContext *c)
         isPackedRGB(srcFormat) && dstFormat == AV_PIX_FMT_GBRP)
         c->convert_unscaled = rgbToPlanarRgbWrapper;
 
+    if ((srcFormat == AV_PIX_FMT_X2RGB10 || srcFormat == AV_PIX_FMT_X2BGR10) &&
+        dstFormat == AV_PIX_FMT_GBRP10)
+        c->convert_unscaled = x2rgb10ToPlanarRgb10Wrapper;
+
+    if (srcFormat == AV_PIX_FMT_GBRP10 &&
+        (dstFormat == AV_PIX_FMT_X2RGB10 || dstFormat == AV_PIX_FMT_X2BGR10))
+        c->convert_unscaled = planarRgb10ToX2rgb10Wrapper;
+
     if (isBayer(srcFormat)) {
         if (dstFormat == AV_PIX_FMT_RGB24)
             c->convert_unscaled = bayer_to_rgb24_wrapper;
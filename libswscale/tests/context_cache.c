@@ -0,0 +1,215 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Check that contexts built from the filter coefficient cache, and contexts
+ * reused from a SwsContextPool, give the same output as fresh contexts.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/frame.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/lfg.h"
+#include "libavutil/macros.h"
+#include "libavutil/pixdesc.h"
+
+#include "libswscale/swscale.h"
+#include "libswscale/swscale_internal.h"
+
+typedef struct Test {
+    int src_w, src_h;
+    enum AVPixelFormat src_format;
+    int dst_w, dst_h;
+    enum AVPixelFormat dst_format;
+    int flags;
+} Test;
+
+static const Test tests[] = {
+    { 1920, 1080, AV_PIX_FMT_YUV420P, 1280, 720, AV_PIX_FMT_YUV420P, SWS_BICUBIC },
+    { 1920, 1080, AV_PIX_FMT_YUV420P,  640, 360, AV_PIX_FMT_RGB24,   SWS_LANCZOS },
+    {  640,  480, AV_PIX_FMT_RGB24,    352, 288, AV_PIX_FMT_YUV420P, SWS_BILINEAR },
+    {  640,  480, AV_PIX_FMT_YUV422P,  640, 480, AV_PIX_FMT_YUV420P, SWS_BICUBIC },
+};
+
+static AVFrame *alloc_frame(int w, int h, enum AVPixelFormat format)
+{
+    AVFrame *frame = av_frame_alloc();
+
+    if (!frame)
+        return NULL;
+    frame->width  = w;
+    frame->height = h;
+    frame->format = format;
+    if (av_frame_get_buffer(frame, 0) < 0)
+        av_frame_free(&frame);
+    return frame;
+}
+
+static struct SwsContext *get_context(SwsContextPool *pool, const Test *t)
+{
+    const int flags = t->flags | SWS_ACCURATE_RND | SWS_BITEXACT;
+
+    if (pool)
+        return sws_context_pool_get(pool, t->src_w, t->src_h, t->src_format,
+                                    t->dst_w, t->dst_h, t->dst_format,
+                                    flags, NULL);
+    return sws_getContext(t->src_w, t->src_h, t->src_format,
+                          t->dst_w, t->dst_h, t->dst_format,
+                          flags, NULL, NULL, NULL);
+}
+
+static int frames_equal(const AVFrame *a, const AVFrame *b)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(a->format);
+    int planes = av_pix_fmt_count_planes(a->format);
+
+    for (int p = 0; p < planes; p++) {
+        const int is_chroma = (p == 1 || p == 2) && !(desc->flags & AV_PIX_FMT_FLAG_RGB);
+        const int h = is_chroma ? AV_CEIL_RSHIFT(a->height, desc->log2_chroma_h) : a->height;
+        const int bytes = av_image_get_linesize(a->format, a->width, p);
+
+        for (int y = 0; y < h; y++)
+            if (memcmp(a->data[p] + y * a->linesize[p],
+                       b->data[p] + y * b->linesize[p], bytes))
+                return 0;
+    }
+    return 1;
+}
+
+static int filter_equal(const int16_t *a, const int32_t *a_pos, int a_size,
+                        const int16_t *b, const int32_t *b_pos, int b_size,
+                        int n)
+{
+    if (a_size != b_size)
+        return 0;
+    if (!a || !b)
+        return a == b;
+    return !memcmp(a,     b,     n * a_size * sizeof(*a)) &&
+           !memcmp(a_pos, b_pos, n * sizeof(*a_pos));
+}
+
+static int filters_equal(const SwsContext *a, const SwsContext *b)
+{
+    return filter_equal(a->hLumFilter, a->hLumFilterPos, a->hLumFilterSize,
+                        b->hLumFilter, b->hLumFilterPos, b->hLumFilterSize,
+                        a->dstW) &&
+           filter_equal(a->hChrFilter, a->hChrFilterPos, a->hChrFilterSize,
+                        b->hChrFilter, b->hChrFilterPos, b->hChrFilterSize,
+                        a->chrDstW) &&
+           filter_equal(a->vLumFilter, a->vLumFilterPos, a->vLumFilterSize,
+                        b->vLumFilter, b->vLumFilterPos, b->vLumFilterSize,
+                        a->dstH) &&
+           filter_equal(a->vChrFilter, a->vChrFilterPos, a->vChrFilterSize,
+                        b->vChrFilter, b->vChrFilterPos, b->vChrFilterSize,
+                        a->chrDstH);
+}
+
+/* change the colorspace details away from the defaults */
+static int set_colorspace(struct SwsContext *c, int yuv_to_yuv)
+{
+    const int *bt709 = sws_getCoefficients(SWS_CS_ITU709);
+    const int *bt601 = sws_getCoefficients(SWS_CS_DEFAULT);
+
+    /* for YUV to YUV, only differing matrices have an effect */
+    return sws_setColorspaceDetails(c, bt709, 1, yuv_to_yuv ? bt601 : bt709, 0,
+                                    1 << 14, 3 << 15, 3 << 15);
+}
+
+static int run_test(const Test *t, SwsContextPool *pool, AVLFG *lfg)
+{
+    struct SwsContext *fresh = NULL, *cached = NULL, *pooled = NULL, *reused = NULL;
+    AVFrame *src = NULL, *ref = NULL, *out = NULL;
+    const int yuv_to_yuv = !isAnyRGB(t->src_format) && !isAnyRGB(t->dst_format);
+    int ret = -1, equal;
+
+    printf("%s %dx%d -> %s %dx%d:\n",
+           av_get_pix_fmt_name(t->src_format), t->src_w, t->src_h,
+           av_get_pix_fmt_name(t->dst_format), t->dst_w, t->dst_h);
+
+    src = alloc_frame(t->src_w, t->src_h, t->src_format);
+    ref = alloc_frame(t->dst_w, t->dst_h, t->dst_format);
+    out = alloc_frame(t->dst_w, t->dst_h, t->dst_format);
+    if (!src || !ref || !out)
+        goto end;
+    for (int p = 0; p < 4 && src->buf[p]; p++)
+        for (size_t i = 0; i < src->buf[p]->size; i++)
+            src->buf[p]->data[i] = av_lfg_get(lfg);
+
+    /* the first context for these parameters fills the cache, the second
+     * one is built from it */
+    fresh  = get_context(NULL, t);
+    cached = get_context(NULL, t);
+    if (!fresh || !cached)
+        goto end;
+    if (sws_scale_frame(fresh,  ref, src) < 0 ||
+        sws_scale_frame(cached, out, src) < 0)
+        goto end;
+    equal = filters_equal(fresh, cached) && frames_equal(ref, out);
+    printf("  cached filters: %s\n", equal ? "same" : "different");
+    if (!equal)
+        goto end;
+
+    /* a context given back after changing its colorspace details must be
+     * handed out again as a fresh one */
+    pooled = get_context(pool, t);
+    if (!pooled || set_colorspace(pooled, yuv_to_yuv) < 0 ||
+        sws_scale_frame(pooled, out, src) < 0)
+        goto end;
+    sws_context_pool_release(pool, &pooled);
+
+    reused = get_context(pool, t);
+    if (!reused || sws_scale_frame(reused, out, src) < 0)
+        goto end;
+    equal = frames_equal(ref, out);
+    printf("  reused context: %s\n", equal ? "same" : "different");
+    if (!equal)
+        goto end;
+
+    ret = 0;
+end:
+    sws_context_pool_release(pool, &reused);
+    sws_context_pool_release(pool, &pooled);
+    sws_freeContext(fresh);
+    sws_freeContext(cached);
+    av_frame_free(&src);
+    av_frame_free(&ref);
+    av_frame_free(&out);
+    return ret;
+}
+
+int main(void)
+{
+    SwsContextPool *pool;
+    AVLFG lfg;
+    int ret = 0;
+
+    av_lfg_init(&lfg, 0xdeadbeef);
+
+    pool = sws_context_pool_alloc(FF_ARRAY_ELEMS(tests));
+    if (!pool)
+        return 1;
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(tests); i++)
+        if (run_test(&tests[i], pool, &lfg) < 0)
+            ret = 1;
+
+    sws_context_pool_free(&pool);
+    return ret;
+}
@@ -0,0 +1,214 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Check that sws_scale_frame_multi() gives the same output as calling
+ * sws_scale_frame() on each context in turn.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/frame.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/lfg.h"
+#include "libavutil/macros.h"
+#include "libavutil/opt.h"
+#include "libavutil/pixdesc.h"
+
+#include "libswscale/swscale.h"
+
+#define MAX_OUTPUTS 4
+
+typedef struct Output {
+    int w, h;
+    enum AVPixelFormat format;
+    const char *dither;
+} Output;
+
+typedef struct Test {
+    int w, h;
+    enum AVPixelFormat format;
+    int flags;
+    Output out[MAX_OUTPUTS];
+} Test;
+
+static const Test tests[] = {
+    { 3840, 2160, AV_PIX_FMT_YUV422P10LE, SWS_FAST_BILINEAR, {
+        { 1280,  720, AV_PIX_FMT_YUV420P10LE },
+        {  640,  360, AV_PIX_FMT_YUV420P10LE },
+        {  853,  480, AV_PIX_FMT_YUV420P },
+    } },
+    { 3840, 2160, AV_PIX_FMT_YUV422P10LE, SWS_BICUBIC, {
+        { 1280,  720, AV_PIX_FMT_YUV420P10LE },
+        {  640,  360, AV_PIX_FMT_YUV420P10LE },
+        {  853,  480, AV_PIX_FMT_YUV420P },
+    } },
+    { 1920, 1080, AV_PIX_FMT_YUV420P, SWS_LANCZOS, {
+        { 1920, 1080, AV_PIX_FMT_YUV420P },
+        { 1280,  720, AV_PIX_FMT_YUV420P },
+        {  640,  360, AV_PIX_FMT_RGB24 },
+        {  320,  180, AV_PIX_FMT_NV12 },
+    } },
+    {  640,  360, AV_PIX_FMT_YUV420P, SWS_BICUBIC, {
+        { 1920, 1080, AV_PIX_FMT_YUV420P },
+        {  960,  540, AV_PIX_FMT_YUV444P },
+        {  320,  240, AV_PIX_FMT_RGB8, "ed" },
+    } },
+    {  720,  576, AV_PIX_FMT_BGR24, SWS_BILINEAR, {
+        {  640,  360, AV_PIX_FMT_YUV420P },
+        {  352,  288, AV_PIX_FMT_GRAY8 },
+        {  720,  576, AV_PIX_FMT_YUYV422 },
+    } },
+    { 1920, 1080, AV_PIX_FMT_RGB0, SWS_BICUBIC, {
+        { 1280,  720, AV_PIX_FMT_RGBA },
+        {  640,  360, AV_PIX_FMT_YUVA420P },
+        {  640,  360, AV_PIX_FMT_YUV420P },
+    } },
+    { 1920, 1080, AV_PIX_FMT_XYZ12LE, SWS_BILINEAR, {
+        { 1280,  720, AV_PIX_FMT_RGB48LE },
+        {  640,  360, AV_PIX_FMT_YUV420P },
+    } },
+};
+
+static AVFrame *alloc_frame(int w, int h, enum AVPixelFormat format)
+{
+    AVFrame *frame = av_frame_alloc();
+
+    if (!frame)
+        return NULL;
+    frame->width  = w;
+    frame->height = h;
+    frame->format = format;
+    if (av_frame_get_buffer(frame, 0) < 0)
+        av_frame_free(&frame);
+    return frame;
+}
+
+static struct SwsContext *alloc_context(const AVFrame *src, const Output *o,
+                                        int flags)
+{
+    struct SwsContext *c = sws_alloc_context();
+
+    if (!c)
+        return NULL;
+    av_opt_set_int(c, "srcw",       src->width,  0);
+    av_opt_set_int(c, "srch",       src->height, 0);
+    av_opt_set_int(c, "src_format", src->format, 0);
+    av_opt_set_int(c, "dstw",       o->w,        0);
+    av_opt_set_int(c, "dsth",       o->h,        0);
+    av_opt_set_int(c, "dst_format", o->format,   0);
+    /* the inexact SIMD vertical scalers do not give the same output from
+     * two contexts with the same parameters */
+    av_opt_set_int(c, "sws_flags",  flags | SWS_ACCURATE_RND | SWS_BITEXACT, 0);
+    if (o->dither)
+        av_opt_set(c, "sws_dither", o->dither, 0);
+    if (sws_init_context(c, NULL, NULL) < 0) {
+        sws_freeContext(c);
+        return NULL;
+    }
+    return c;
+}
+
+static int frames_equal(const AVFrame *a, const AVFrame *b)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(a->format);
+    int planes = av_pix_fmt_count_planes(a->format);
+
+    for (int p = 0; p < planes; p++) {
+        const int is_chroma = (p == 1 || p == 2) && !(desc->flags & AV_PIX_FMT_FLAG_RGB);
+        const int h = is_chroma ? AV_CEIL_RSHIFT(a->height, desc->log2_chroma_h) : a->height;
+        const int bytes = av_image_get_linesize(a->format, a->width, p);
+
+        if (desc->flags & AV_PIX_FMT_FLAG_PAL && p == 1)
+            break;
+        for (int y = 0; y < h; y++)
+            if (memcmp(a->data[p] + y * a->linesize[p],
+                       b->data[p] + y * b->linesize[p], bytes))
+                return 0;
+    }
+    return 1;
+}
+
+static int run_test(const Test *t, AVLFG *lfg)
+{
+    struct SwsContext *c[MAX_OUTPUTS] = { NULL }, *c_ref[MAX_OUTPUTS] = { NULL };
+    AVFrame *ref[MAX_OUTPUTS] = { NULL }, *out[MAX_OUTPUTS] = { NULL };
+    AVFrame *src;
+    int nb = 0, ret = -1;
+
+    src = alloc_frame(t->w, t->h, t->format);
+    if (!src)
+        return -1;
+    for (int p = 0; p < 4 && src->buf[p]; p++)
+        for (size_t i = 0; i < src->buf[p]->size; i++)
+            src->buf[p]->data[i] = av_lfg_get(lfg);
+
+    printf("%s %dx%d:\n", av_get_pix_fmt_name(t->format), t->w, t->h);
+
+    for (; nb < MAX_OUTPUTS && t->out[nb].w; nb++) {
+        const Output *o = &t->out[nb];
+
+        /* separate contexts, as error diffusion carries state over */
+        c[nb]     = alloc_context(src, o, t->flags);
+        c_ref[nb] = alloc_context(src, o, t->flags);
+        ref[nb]   = alloc_frame(o->w, o->h, o->format);
+        out[nb]   = alloc_frame(o->w, o->h, o->format);
+        if (!c[nb] || !c_ref[nb] || !ref[nb] || !out[nb])
+            goto end;
+        if (sws_scale_frame(c_ref[nb], ref[nb], src) < 0)
+            goto end;
+    }
+
+    if (sws_scale_frame_multi(c, out, nb, src) < 0)
+        goto end;
+
+    ret = 0;
+    for (int i = 0; i < nb; i++) {
+        const int equal = frames_equal(ref[i], out[i]);
+
+        printf("  -> %s %dx%d: %s\n", av_get_pix_fmt_name(t->out[i].format),
+               t->out[i].w, t->out[i].h, equal ? "same" : "different");
+        if (!equal)
+            ret = -1;
+    }
+
+end:
+    for (int i = 0; i < MAX_OUTPUTS; i++) {
+        sws_freeContext(c[i]);
+        sws_freeContext(c_ref[i]);
+        av_frame_free(&ref[i]);
+        av_frame_free(&out[i]);
+    }
+    av_frame_free(&src);
+    return ret;
+}
+
+int main(void)
+{
+    AVLFG lfg;
+    int ret = 0;
+
+    av_lfg_init(&lfg, 0xdeadbeef);
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(tests); i++)
+        if (run_test(&tests[i], &lfg) < 0)
+            ret = 1;
+
+    return ret;
+}
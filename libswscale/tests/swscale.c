@@ -32,8 +32,10 @@
 #include "libavutil/crc.h"
 #include "libavutil/pixdesc.h"
 #include "libavutil/lfg.h"
+#include "libavutil/time.h"
 
 #include "libswscale/swscale.h"
+#include "libswscale/swscale_internal.h"
 
 /* HACK Duplicated from swscale_internal.h.
  * Should be removed when a cleaner pixel format system exists. */
@@ -355,6 +357,209 @@ static int fileTest(const uint8_t * const ref[4], int refStride[4],
     return 0;
 }
 
+/* Layout of the vertical filter taken by the x86 yuv2yuvX kernels when
+ * use_mmx_vfilter is set, one entry per tap followed by a NULL source. */
+typedef union VFilterData {
+    const int16_t *src;
+    uint16_t coeff[8];
+} VFilterData;
+
+/* time the luma hscale and yuv2planeX kernels selected for c, in Mpix/s of
+ * their output, by running them on their own over all the rows of a frame */
+static int benchKernels(SwsContext *c, const uint8_t *src, int srcStride,
+                        uint8_t *dst, int dstStride, double min_time,
+                        double *hscale, double *vscale)
+{
+    const int filterSize = c->vLumFilterSize;
+    const int16_t **vsrc = NULL;
+    VFilterData *vFilterData = NULL;
+    uint8_t *rows = NULL;
+    int64_t start, elapsed;
+    int64_t pixels;
+    int res = AVERROR(ENOMEM);
+
+    *hscale = *vscale = 0;
+
+    /* horizontal output rows, also the vertical input rows, which are 15 or
+     * 19 bits wide */
+    rows = av_mallocz(filterSize * (c->dstW * 4 + 64));
+    vsrc = av_malloc_array(filterSize, sizeof(*vsrc));
+    vFilterData = av_calloc(filterSize + 2, sizeof(*vFilterData));
+    if (!rows || !vsrc || !vFilterData)
+        goto end;
+    for (int i = 0; i < filterSize; i++)
+        vsrc[i] = (const int16_t *)(rows + i * (c->dstW * 4 + 64));
+
+    pixels = 0;
+    start  = av_gettime_relative();
+    do {
+        for (int y = 0; y < c->srcH; y++) {
+            const uint8_t *line = src + y * (ptrdiff_t)srcStride;
+            int16_t *out = (int16_t *)vsrc[y % filterSize];
+
+            if (c->hyscale_fast)
+                c->hyscale_fast(c, out, c->dstW, line, c->srcW, c->lumXInc);
+            else
+                c->hyScale(c, out, c->dstW, line, c->hLumFilter,
+                           c->hLumFilterPos, c->hLumFilterSize);
+        }
+        pixels += (int64_t)c->dstW * c->srcH;
+        elapsed = av_gettime_relative() - start;
+    } while (elapsed < min_time * 1000000);
+    *hscale = (double)pixels / FFMAX(elapsed, 1);
+
+    /* packed and other outputs use their own vertical scalers */
+    if (c->yuv2packedX || c->yuv2anyX || !c->yuv2planeX) {
+        res = 0;
+        goto end;
+    }
+
+    pixels = 0;
+    start  = av_gettime_relative();
+    do {
+        for (int y = 0; y < c->dstH; y++) {
+            const int16_t *filter = c->vLumFilter + y * filterSize;
+            uint8_t *out = dst + y * (ptrdiff_t)dstStride;
+
+            if (filterSize == 1) {
+                c->yuv2plane1(vsrc[0], out, c->dstW, c->lumDither8, 0);
+                continue;
+            }
+            if (c->use_mmx_vfilter) {
+                for (int i = 0; i < filterSize; i++) {
+                    vFilterData[i].src = vsrc[i];
+                    for (int j = 0; j < 4; j++)
+                        vFilterData[i].coeff[j + 4] = filter[i];
+                }
+                filter = (const int16_t *)vFilterData;
+            }
+            c->yuv2planeX(filter, filterSize, vsrc, out, c->dstW, c->lumDither8, 0);
+        }
+        pixels += (int64_t)c->dstW * c->dstH;
+        elapsed = av_gettime_relative() - start;
+    } while (elapsed < min_time * 1000000);
+    *vscale = (double)pixels / FFMAX(elapsed, 1);
+    res = 0;
+
+end:
+    av_free(rows);
+    av_free(vsrc);
+    av_free(vFilterData);
+    return res;
+}
+
+/* time full frame conversions at high resolutions for each scaling algorithm,
+ * and the luma kernels they use on their own */
+static int benchTest(enum AVPixelFormat srcFormat, enum AVPixelFormat dstFormat,
+                     double min_time)
+{
+    static const struct {
+        int srcW, srcH, dstW, dstH;
+    } sizes[] = {
+        { 1920, 1080, 3840, 2160 },
+        { 3840, 2160, 1920, 1080 },
+        { 3840, 2160, 7680, 4320 },
+        { 7680, 4320, 3840, 2160 },
+    };
+    static const struct {
+        int flags;
+        const char *name;
+    } scalers[] = {
+        { SWS_FAST_BILINEAR, "fast_bilinear" },
+        { SWS_BILINEAR,      "bilinear"      },
+        { SWS_BICUBIC,       "bicubic"       },
+        { SWS_SPLINE,        "spline"        },
+        { SWS_LANCZOS,       "lanczos"       },
+    };
+    uint8_t *src[4], *dst[4];
+    int srcStride[4], dstStride[4];
+    AVLFG rand;
+    int i, j, p, res = 0;
+
+    if (srcFormat == AV_PIX_FMT_NONE)
+        srcFormat = AV_PIX_FMT_YUV420P;
+    if (dstFormat == AV_PIX_FMT_NONE)
+        dstFormat = AV_PIX_FMT_YUV420P;
+
+    av_lfg_init(&rand, 1);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(sizes); i++) {
+        int srcW = sizes[i].srcW, srcH = sizes[i].srcH;
+        int dstW = sizes[i].dstW, dstH = sizes[i].dstH;
+        int size;
+
+        size = av_image_alloc(src, srcStride, srcW, srcH, srcFormat, 64);
+        if (size < 0)
+            return size;
+        res = av_image_alloc(dst, dstStride, dstW, dstH, dstFormat, 64);
+        if (res < 0) {
+            av_freep(&src[0]);
+            return res;
+        }
+        for (p = 0; p < size; p++)
+            src[0][p] = av_lfg_get(&rand);
+
+        for (j = 0; j < FF_ARRAY_ELEMS(scalers); j++) {
+            struct SwsContext *sws;
+            int64_t start, elapsed;
+            int frames = 0;
+
+            sws = sws_getContext(srcW, srcH, srcFormat, dstW, dstH, dstFormat,
+                                 scalers[j].flags, NULL, NULL, NULL);
+            if (!sws) {
+                fprintf(stderr, "Failed to get %s ---> %s\n",
+                        av_get_pix_fmt_name(srcFormat),
+                        av_get_pix_fmt_name(dstFormat));
+                res = -1;
+                break;
+            }
+
+            start = av_gettime_relative();
+            do {
+                sws_scale(sws, (const uint8_t * const *)src, srcStride, 0, srcH,
+                          dst, dstStride);
+                frames++;
+                elapsed = av_gettime_relative() - start;
+            } while (elapsed < min_time * 1000000);
+
+            printf("%s %4dx%-4d -> %s %4dx%-4d %-13s %8.1f Mpix/s",
+                   av_get_pix_fmt_name(srcFormat), srcW, srcH,
+                   av_get_pix_fmt_name(dstFormat), dstW, dstH,
+                   scalers[j].name,
+                   (double)dstW * dstH * frames / FFMAX(elapsed, 1));
+
+            /* contexts which do not scale in one pass on the whole frame
+             * have no kernels of their own to time, and sources converted
+             * to planar rows first are only timed as a whole */
+            if (!sws->convert_unscaled && !sws->cascaded_context[0] &&
+                !sws->nb_slice_ctx && !sws->nb_tile_ctx &&
+                !sws->lumToYV12 && !sws->readLumPlanar) {
+                double hscale, vscale;
+
+                res = benchKernels(sws, src[0], srcStride[0], dst[0], dstStride[0],
+                                   min_time, &hscale, &vscale);
+                if (res < 0) {
+                    sws_freeContext(sws);
+                    break;
+                }
+                printf(", hscale %8.1f Mpix/s", hscale);
+                if (vscale > 0)
+                    printf(", vscale %8.1f Mpix/s", vscale);
+            }
+            printf("\n");
+            fflush(stdout);
+            sws_freeContext(sws);
+        }
+
+        av_freep(&src[0]);
+        av_freep(&dst[0]);
+        if (res < 0)
+            return res;
+    }
+
+    return 0;
+}
+
 #define W 96
 #define H 96
 
@@ -374,6 +579,7 @@ int main(int argc, char **argv)
     int res = -1;
     int i;
     FILE *fp = NULL;
+    double bench = 0;
 
     if (!rgb_data || !data)
         return -1;
@@ -387,6 +593,12 @@ int main(int argc, char **argv)
                 fprintf(stderr, "could not open '%s'\n", argv[i + 1]);
                 goto error;
             }
+        } else if (!strcmp(argv[i], "-bench")) {
+            bench = atof(argv[i + 1]);
+            if (bench <= 0) {
+                fprintf(stderr, "invalid benchmark duration %s\n", argv[i + 1]);
+                goto error;
+            }
         } else if (!strcmp(argv[i], "-cpuflags")) {
             unsigned flags = av_get_cpu_flags();
             int ret = av_parse_cpu_caps(&flags, argv[i + 1]);
@@ -414,6 +626,12 @@ bad_option:
         }
     }
 
+    if (bench) {
+        av_free(rgb_data);
+        res = benchTest(srcFormat, dstFormat, bench);
+        goto error;
+    }
+
     sws = sws_getContext(W / 12, H / 12, AV_PIX_FMT_RGB32, W, H,
                          AV_PIX_FMT_YUVA420P, SWS_BILINEAR, NULL, NULL, NULL);
 
@@ -42,6 +42,7 @@
 #include "libavutil/avassert.h"
 #include "libavutil/avutil.h"
 #include "libavutil/bswap.h"
+#include "libavutil/buffer.h"
 #include "libavutil/cpu.h"
 #include "libavutil/imgutils.h"
 #include "libavutil/intreadwrite.h"
@@ -265,7 +266,7 @@ static const FormatEntry format_entries[] = {
     [AV_PIX_FMT_YUVA444P12LE] = { 1, 1 },
     [AV_PIX_FMT_NV24]        = { 1, 1 },
     [AV_PIX_FMT_NV42]        = { 1, 1 },
-    [AV_PIX_FMT_Y210LE]      = { 1, 0 },
+    [AV_PIX_FMT_Y210LE]      = { 1, 1 },
     [AV_PIX_FMT_X2RGB10LE]   = { 1, 1 },
     [AV_PIX_FMT_X2BGR10LE]   = { 1, 1 },
     [AV_PIX_FMT_P210BE]      = { 1, 1 },
@@ -280,34 +281,51 @@ static const FormatEntry format_entries[] = {
 
 void ff_shuffle_filter_coefficients(SwsContext *c, int *filterPos, int filterSize, int16_t *filter, int dstW){
 #if ARCH_X86_64
+    /* order in which the AVX-512 hscale gathers a group of 16 output pixels */
+    static const uint8_t avx512_pos_order[16] = {
+        0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15
+    };
     int i, j, k, l;
     int cpu_flags = av_get_cpu_flags();
-    if (EXTERNAL_AVX2_FAST(cpu_flags) && !(cpu_flags & AV_CPU_FLAG_SLOW_GATHER)) {
-        if ((c->srcBpc == 8) && (c->dstBpc <= 14)){
-            if (dstW % 16 == 0){
-                if (filter != NULL){
-                    for (i = 0; i < dstW; i += 8){
-                        FFSWAP(int, filterPos[i + 2], filterPos[i+4]);
-                        FFSWAP(int, filterPos[i + 3], filterPos[i+5]);
-                    }
-                    if (filterSize > 4){
-                        int16_t *tmp2 = av_malloc(dstW * filterSize * 2);
-                        memcpy(tmp2, filter, dstW * filterSize * 2);
-                        for (i = 0; i < dstW; i += 16){//pixel
-                            for (k = 0; k < filterSize / 4; ++k){//fcoeff
-                                for (j = 0; j < 16; ++j){//inner pixel
-                                    for (l = 0; l < 4; ++l){//coeff
-                                        int from = i * filterSize + j * filterSize + k * 4 + l;
-                                        int to = (i) * filterSize + j * 4 + l + k * 64;
-                                        filter[to] = tmp2[from];
-                                    }
-                                }
-                            }
+    int group = 0; // output pixels per iteration of the gather based hscale
+
+    if (!(cpu_flags & AV_CPU_FLAG_SLOW_GATHER) &&
+        (c->srcBpc == 8) && (c->dstBpc <= 14)) {
+        if (EXTERNAL_AVX512(cpu_flags) && dstW % 32 == 0)
+            group = 32;
+        else if (EXTERNAL_AVX2_FAST(cpu_flags) && dstW % 16 == 0)
+            group = 16;
+    }
+
+    if (group && filter != NULL) {
+        if (group == 32) {
+            for (i = 0; i < dstW; i += 16) {
+                int tmp[16];
+                for (j = 0; j < 16; j++)
+                    tmp[j] = filterPos[i + avx512_pos_order[j]];
+                memcpy(&filterPos[i], tmp, sizeof(tmp));
+            }
+        } else {
+            for (i = 0; i < dstW; i += 8){
+                FFSWAP(int, filterPos[i + 2], filterPos[i+4]);
+                FFSWAP(int, filterPos[i + 3], filterPos[i+5]);
+            }
+        }
+        if (filterSize > 4){
+            int16_t *tmp2 = av_malloc(dstW * filterSize * 2);
+            memcpy(tmp2, filter, dstW * filterSize * 2);
+            for (i = 0; i < dstW; i += group){//pixel
+                for (k = 0; k < filterSize / 4; ++k){//fcoeff
+                    for (j = 0; j < group; ++j){//inner pixel
+                        for (l = 0; l < 4; ++l){//coeff
+                            int from = i * filterSize + j * filterSize + k * 4 + l;
+                            int to = (i) * filterSize + j * 4 + l + k * 4 * group;
+                            filter[to] = tmp2[from];
                         }
-                        av_free(tmp2);
                     }
                 }
             }
+            av_free(tmp2);
         }
     }
 #endif
@@ -373,12 +391,12 @@ static const ScaleAlgorithm scale_algorithms[] = {
     { SWS_X,             "experimental",                    8 },
 };
 
-static av_cold int initFilter(int16_t **outFilter, int32_t **filterPos,
-                              int *outFilterSize, int xInc, int srcW,
-                              int dstW, int filterAlign, int one,
-                              int flags, int cpu_flags,
-                              SwsVector *srcFilter, SwsVector *dstFilter,
-                              double param[2], int srcPos, int dstPos)
+static av_cold int build_filter(int16_t **outFilter, int32_t **filterPos,
+                                int *outFilterSize, int xInc, int srcW,
+                                int dstW, int filterAlign, int one,
+                                int flags, int cpu_flags,
+                                SwsVector *srcFilter, SwsVector *dstFilter,
+                                double param[2], int srcPos, int dstPos)
 {
     int i;
     int filterSize;
@@ -773,6 +791,148 @@ done:
     return ret;
 }
 
+/*
+ * Process-wide cache of filter coefficients.
+ *
+ * Applications frequently create many contexts with the same geometry
+ * (one per stream, or a new one for every frame of a thumbnailer), and
+ * building the filters is the bulk of the sws_init_context() cost for
+ * large outputs. Entries are shared refcounted buffers holding filterPos
+ * followed by the coefficients; contexts always get private copies, as the
+ * arrays are rearranged in place and freed by sws_freeContext().
+ */
+#define FILTER_CACHE_ENTRIES   64
+#define FILTER_CACHE_MAX_BYTES (16 << 20)
+
+typedef struct FilterCacheKey {
+    int xInc, srcW, dstW;
+    int filterAlign, one;
+    int flags, cpu_flags;
+    int srcPos, dstPos;
+    double param[2];
+} FilterCacheKey;
+
+typedef struct FilterCacheEntry {
+    FilterCacheKey key;
+    int filterSize;
+    AVBufferRef *buf;
+} FilterCacheEntry;
+
+static AVMutex filter_cache_lock = AV_MUTEX_INITIALIZER;
+/* most recently used first */
+static FilterCacheEntry filter_cache[FILTER_CACHE_ENTRIES];
+static int    filter_cache_nb;
+static size_t filter_cache_bytes;
+
+static int filter_cache_find(const FilterCacheKey *key)
+{
+    for (int i = 0; i < filter_cache_nb; i++)
+        if (!memcmp(&filter_cache[i].key, key, sizeof(*key)))
+            return i;
+    return -1;
+}
+
+static void filter_cache_insert(const FilterCacheKey *key, int filterSize,
+                                AVBufferRef *buf)
+{
+    ff_mutex_lock(&filter_cache_lock);
+    if (filter_cache_find(key) >= 0 || buf->size > FILTER_CACHE_MAX_BYTES) {
+        /* another thread got there first */
+        av_buffer_unref(&buf);
+        goto end;
+    }
+    while (filter_cache_nb == FILTER_CACHE_ENTRIES ||
+           filter_cache_bytes + buf->size > FILTER_CACHE_MAX_BYTES) {
+        FilterCacheEntry *e = &filter_cache[--filter_cache_nb];
+        filter_cache_bytes -= e->buf->size;
+        av_buffer_unref(&e->buf);
+    }
+    memmove(&filter_cache[1], &filter_cache[0],
+            filter_cache_nb * sizeof(*filter_cache));
+    filter_cache[0].key        = *key;
+    filter_cache[0].filterSize = filterSize;
+    filter_cache[0].buf        = buf;
+    filter_cache_nb++;
+    filter_cache_bytes += buf->size;
+end:
+    ff_mutex_unlock(&filter_cache_lock);
+}
+
+static av_cold int initFilter(int16_t **outFilter, int32_t **filterPos,
+                              int *outFilterSize, int xInc, int srcW,
+                              int dstW, int filterAlign, int one,
+                              int flags, int cpu_flags,
+                              SwsVector *srcFilter, SwsVector *dstFilter,
+                              double param[2], int srcPos, int dstPos)
+{
+    const size_t pos_size = (dstW + 3) * sizeof(**filterPos);
+    AVBufferRef *buf = NULL;
+    FilterCacheKey key;
+    size_t coeff_size;
+    int idx, ret;
+
+    /* user supplied vectors are rare and not worth hashing */
+    if (srcFilter || dstFilter)
+        return build_filter(outFilter, filterPos, outFilterSize, xInc, srcW,
+                            dstW, filterAlign, one, flags, cpu_flags,
+                            srcFilter, dstFilter, param, srcPos, dstPos);
+
+    /* zero the padding too, the key is compared with memcmp() */
+    memset(&key, 0, sizeof(key));
+    key.xInc        = xInc;
+    key.srcW        = srcW;
+    key.dstW        = dstW;
+    key.filterAlign = filterAlign;
+    key.one         = one;
+    key.flags       = flags;
+    key.cpu_flags   = cpu_flags;
+    key.srcPos      = srcPos;
+    key.dstPos      = dstPos;
+    key.param[0]    = param[0];
+    key.param[1]    = param[1];
+
+    ff_mutex_lock(&filter_cache_lock);
+    idx = filter_cache_find(&key);
+    if (idx >= 0) {
+        FilterCacheEntry e = filter_cache[idx];
+        buf = av_buffer_ref(e.buf);
+        *outFilterSize = e.filterSize;
+        memmove(&filter_cache[1], &filter_cache[0], idx * sizeof(*filter_cache));
+        filter_cache[0] = e;
+    }
+    ff_mutex_unlock(&filter_cache_lock);
+
+    if (buf) {
+        coeff_size = buf->size - pos_size;
+        *filterPos = av_malloc(pos_size);
+        *outFilter = av_malloc(coeff_size);
+        if (!*filterPos || !*outFilter) {
+            av_buffer_unref(&buf);
+            return AVERROR(ENOMEM);
+        }
+        memcpy(*filterPos, buf->data, pos_size);
+        memcpy(*outFilter, buf->data + pos_size, coeff_size);
+        av_buffer_unref(&buf);
+        return 0;
+    }
+
+    ret = build_filter(outFilter, filterPos, outFilterSize, xInc, srcW, dstW,
+                       filterAlign, one, flags, cpu_flags, NULL, NULL,
+                       param, srcPos, dstPos);
+    if (ret < 0)
+        return ret;
+
+    /* caching is best effort, a failure here is not an error */
+    coeff_size = *outFilterSize * (dstW + 3) * sizeof(**outFilter);
+    buf = av_buffer_alloc(pos_size + coeff_size);
+    if (buf) {
+        memcpy(buf->data, *filterPos, pos_size);
+        memcpy(buf->data + pos_size, *outFilter, coeff_size);
+        filter_cache_insert(&key, *outFilterSize, buf);
+    }
+    return 0;
+}
+
 static void fill_rgb2yuv_table(SwsContext *c, const int table[4], int dstRange)
 {
     int64_t W, V, Z, Cy, Cu, Cv;
@@ -903,6 +1063,14 @@ static void fill_xyztables(struct SwsContext *c)
     }
 }
 
+static void free_tiles(SwsContext *c)
+{
+    for (int i = 0; i < c->nb_tile_ctx; i++)
+        sws_freeContext(c->tile_ctx[i]);
+    av_freep(&c->tile_ctx);
+    c->nb_tile_ctx = 0;
+}
+
 static int range_override_needed(enum AVPixelFormat format)
 {
     return !isYUV(format) && !isGray(format);
@@ -929,6 +1097,14 @@ int sws_setColorspaceDetails(struct SwsContext *c, const int inv_table[4],
         return parent_ret;
     }
 
+    for (int i = 0; i < c->nb_tile_ctx; i++) {
+        int ret = sws_setColorspaceDetails(c->tile_ctx[i], inv_table,
+                                           srcRange, table, dstRange,
+                                           brightness, contrast, saturation);
+        if (ret < 0)
+            return ret;
+    }
+
     handle_formats(c);
     desc_dst = av_pix_fmt_desc_get(c->dstFormat);
     desc_src = av_pix_fmt_desc_get(c->srcFormat);
@@ -974,7 +1150,8 @@ int sws_setColorspaceDetails(struct SwsContext *c, const int inv_table[4],
         return 0;
 
     if ((isYUV(c->dstFormat) || isGray(c->dstFormat)) && (isYUV(c->srcFormat) || isGray(c->srcFormat))) {
-        if (!c->cascaded_context[0] &&
+        /* the parent of a tile cascades instead of its tiles */
+        if (!c->cascaded_context[0] && !c->tile_parent &&
             memcmp(c->dstColorspaceTable, c->srcColorspaceTable, sizeof(int) * 4) &&
             c->srcW && c->srcH && c->dstW && c->dstH) {
             enum AVPixelFormat tmp_format;
@@ -986,6 +1163,8 @@ int sws_setColorspaceDetails(struct SwsContext *c, const int inv_table[4],
             int ret;
             av_log(c, AV_LOG_VERBOSE, "YUV color matrix differs for YUV->YUV, using intermediate RGB to convert\n");
 
+            free_tiles(c);
+
             if (isNBPS(c->dstFormat) || is16BPS(c->dstFormat)) {
                 if (isALPHA(c->srcFormat) && isALPHA(c->dstFormat)) {
                     tmp_format = AV_PIX_FMT_BGRA64;
@@ -1293,6 +1472,156 @@ static int context_init_threaded(SwsContext *c,
     return 0;
 }
 
+/**
+ * Replace a horizontal filter by its columns [x, x + w), with positions
+ * relative to the input column src_x.
+ */
+static av_cold int crop_filter(int16_t **filter, int32_t **filterPos,
+                               int filterSize, int x, int w, int src_x)
+{
+    int16_t *crop     = NULL;
+    int32_t *crop_pos = NULL;
+
+    if (!FF_ALLOC_TYPED_ARRAY(crop_pos, w + 3) ||
+        !FF_ALLOC_TYPED_ARRAY(crop,     filterSize * (w + 3))) {
+        av_free(crop_pos);
+        return AVERROR(ENOMEM);
+    }
+
+    /* the 3 extra entries repeat the last one, as in initFilter() */
+    for (int i = 0; i < w + 3; i++) {
+        const int xi = x + FFMIN(i, w - 1);
+        crop_pos[i] = (*filterPos)[xi] - src_x;
+        memcpy(crop + i * filterSize, *filter + xi * filterSize,
+               filterSize * sizeof(*crop));
+    }
+
+    av_freep(filter);
+    av_freep(filterPos);
+    *filter    = crop;
+    *filterPos = crop_pos;
+    return 0;
+}
+
+/* working set targeted by automatic tiling, a conservative L2 size */
+#define TILE_CACHE_SIZE (256 * 1024)
+/* alignment of the output columns of a tile, a multiple of the dither
+ * pattern period and of the SIMD widths of the output functions */
+#define TILE_ALIGN      128
+/* alignment of the input columns of a tile, enough for bitstream,
+ * chroma subsampled and packed formats */
+#define TILE_SRC_ALIGN  64
+
+/**
+ * Find the input columns [*src_x0, *src_x1) read for the output
+ * columns [x, x + w).
+ */
+static void tile_src_range(const SwsContext *c, int x, int w,
+                           int *src_x0, int *src_x1)
+{
+    const int cx0 = x >> c->chrDstHSubSample;
+    const int cx1 = AV_CEIL_RSHIFT(x + w, c->chrDstHSubSample);
+    int lo = INT_MAX, hi = 0;
+
+    /* the order of the positions may be shuffled for SIMD, but only inside
+     * groups which do not cross tile boundaries */
+    for (int i = x; i < x + w; i++) {
+        lo = FFMIN(lo, c->hLumFilterPos[i]);
+        hi = FFMAX(hi, c->hLumFilterPos[i] + c->hLumFilterSize);
+    }
+    for (int i = cx0; i < cx1; i++) {
+        lo = FFMIN(lo,  c->hChrFilterPos[i] << c->chrSrcHSubSample);
+        hi = FFMAX(hi, (c->hChrFilterPos[i] + c->hChrFilterSize) << c->chrSrcHSubSample);
+    }
+
+    *src_x0 = FFMAX(lo, 0) & ~(TILE_SRC_ALIGN - 1);
+    *src_x1 = FFMIN(hi, c->srcW);
+}
+
+static av_cold int context_init_tiles(SwsContext *c, SwsFilter *src_filter,
+                                      SwsFilter *dst_filter)
+{
+    int tile_w = c->tile_width;
+    int linesize[4];
+    int ret;
+
+    /* tiles must produce the same output as the whole image, so nothing
+     * can be carried along the lines */
+    if (c->flags & SWS_FAST_BILINEAR     ||
+        c->dither == SWS_DITHER_ED       ||
+        c->dither == SWS_DITHER_A_DITHER ||
+        c->dither == SWS_DITHER_X_DITHER ||
+        isBayer(c->srcFormat) || isBayer(c->dstFormat))
+        return 0;
+
+    if (tile_w < 0) {
+        /* fit the input lines of the vertical scaler in the cache */
+        const int sample_size = c->dstBpc > 14 ? 4 : 2;
+        const int col_size    = sample_size *
+            (c->vLumFilterSize * (c->needAlpha ? 2 : 1) +
+             ((2 * c->vChrFilterSize) >> c->chrDstHSubSample));
+        tile_w = TILE_CACHE_SIZE / col_size;
+    }
+    tile_w = FFALIGN(FFMAX(tile_w, 1), TILE_ALIGN);
+    if (tile_w >= c->dstW)
+        return 0;
+
+    c->tile_ctx = av_calloc((c->dstW + tile_w - 1) / tile_w, sizeof(*c->tile_ctx));
+    if (!c->tile_ctx)
+        return AVERROR(ENOMEM);
+
+    for (int x = 0; x < c->dstW; x += tile_w) {
+        const int w = FFMIN(tile_w, c->dstW - x);
+        int src_x0, src_x1;
+        SwsContext *t;
+
+        tile_src_range(c, x, w, &src_x0, &src_x1);
+
+        t = c->tile_ctx[c->nb_tile_ctx] = sws_alloc_context();
+        if (!t)
+            return AVERROR(ENOMEM);
+        c->nb_tile_ctx++;
+
+        ret = av_opt_copy(t, c);
+        if (ret < 0)
+            return ret;
+
+        t->parent      = c;
+        t->tile_parent = c;
+        t->nb_threads  = 1;
+        t->tile_width  = 0;
+        t->tile_x      = x;
+        t->tile_src_x  = src_x0;
+        t->srcW        = src_x1 - src_x0;
+        t->dstW        = w;
+
+        ret = sws_init_context(t, src_filter, dst_filter);
+        if (ret < 0)
+            return ret;
+
+        ret = sws_setColorspaceDetails(t, c->srcColorspaceTable, c->srcRange,
+                                       c->dstColorspaceTable, c->dstRange,
+                                       c->brightness, c->contrast, c->saturation);
+        if (ret < 0)
+            return ret;
+
+        ret = av_image_fill_linesizes(linesize, c->srcFormat, src_x0);
+        if (ret < 0)
+            return ret;
+        for (int i = 0; i < 4; i++)
+            t->tile_src_offset[i] = (i == 1 && usePal(c->srcFormat)) ? 0 : linesize[i];
+
+        ret = av_image_fill_linesizes(linesize, c->dstFormat, x);
+        if (ret < 0)
+            return ret;
+        memcpy(t->tile_dst_offset, linesize, sizeof(linesize));
+    }
+
+    av_log(c, AV_LOG_VERBOSE, "scaling in %d tiles of width %d\n",
+           c->nb_tile_ctx, tile_w);
+    return 0;
+}
+
 av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
                              SwsFilter *dstFilter)
 {
@@ -1328,7 +1657,7 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
     if (ff_thread_once(&rgb2rgb_once, ff_sws_rgb2rgb_init) != 0)
         return AVERROR_UNKNOWN;
 
-    unscaled = (srcW == dstW && srcH == dstH);
+    unscaled = (srcW == dstW && srcH == dstH) && !c->tile_parent;
 
     c->srcRange |= handle_jpeg(&c->srcFormat);
     c->dstRange |= handle_jpeg(&c->dstFormat);
@@ -1546,6 +1875,9 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
         ((dstW >> c->chrDstHSubSample) <= (srcW >> 1) ||
          (flags & SWS_FAST_BILINEAR)))
         c->chrSrcHSubSample = 1;
+    /* a tile must read its input chroma the same way as the whole image */
+    if (c->tile_parent)
+        c->chrSrcHSubSample = c->tile_parent->chrSrcHSubSample;
 
     // Note the AV_CEIL_RSHIFT is so that we always round toward +inf.
     c->chrSrcW = AV_CEIL_RSHIFT(srcW, c->chrSrcHSubSample);
@@ -1826,26 +2158,39 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
             const int filterAlign = X86_MMX(cpu_flags)     ? 4 :
                                     PPC_ALTIVEC(cpu_flags) ? 8 :
                                     have_neon(cpu_flags)   ? 8 : 1;
+            /* tiles use their part of the filter of the whole image */
+            const SwsContext *tp = c->tile_parent;
 
             if ((ret = initFilter(&c->hLumFilter, &c->hLumFilterPos,
-                           &c->hLumFilterSize, c->lumXInc,
-                           srcW, dstW, filterAlign, 1 << 14,
+                           &c->hLumFilterSize, tp ? tp->lumXInc : c->lumXInc,
+                           tp ? tp->srcW : srcW, tp ? tp->dstW : dstW,
+                           filterAlign, 1 << 14,
                            (flags & SWS_BICUBLIN) ? (flags | SWS_BICUBIC) : flags,
                            cpu_flags, srcFilter->lumH, dstFilter->lumH,
                            c->param,
                            get_local_pos(c, 0, 0, 0),
                            get_local_pos(c, 0, 0, 0))) < 0)
                 goto fail;
+            if (tp && (ret = crop_filter(&c->hLumFilter, &c->hLumFilterPos,
+                                         c->hLumFilterSize, c->tile_x, dstW,
+                                         c->tile_src_x)) < 0)
+                goto fail;
             ff_shuffle_filter_coefficients(c, c->hLumFilterPos, c->hLumFilterSize, c->hLumFilter, dstW);
             if ((ret = initFilter(&c->hChrFilter, &c->hChrFilterPos,
-                           &c->hChrFilterSize, c->chrXInc,
-                           c->chrSrcW, c->chrDstW, filterAlign, 1 << 14,
+                           &c->hChrFilterSize, tp ? tp->chrXInc : c->chrXInc,
+                           tp ? tp->chrSrcW : c->chrSrcW, tp ? tp->chrDstW : c->chrDstW,
+                           filterAlign, 1 << 14,
                            (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
                            cpu_flags, srcFilter->chrH, dstFilter->chrH,
                            c->param,
                            get_local_pos(c, c->chrSrcHSubSample, c->src_h_chr_pos, 0),
                            get_local_pos(c, c->chrDstHSubSample, c->dst_h_chr_pos, 0))) < 0)
                 goto fail;
+            if (tp && (ret = crop_filter(&c->hChrFilter, &c->hChrFilterPos,
+                                         c->hChrFilterSize,
+                                         c->tile_x     >> c->chrDstHSubSample, c->chrDstW,
+                                         c->tile_src_x >> c->chrSrcHSubSample)) < 0)
+                goto fail;
             ff_shuffle_filter_coefficients(c, c->hChrFilterPos, c->hChrFilterSize, c->hChrFilter, c->chrDstW);
         }
     } // initialize horizontal stuff
@@ -1988,7 +2333,13 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
 
     ff_sws_init_scale(c);
 
-    return ff_init_filters(c);
+    ret = ff_init_filters(c);
+    if (ret < 0)
+        return ret;
+
+    if (c->tile_width)
+        return context_init_tiles(c, srcFilter, dstFilter);
+    return 0;
 nomem:
     ret = AVERROR(ENOMEM);
 fail: // FIXME replace things by appropriate error codes
@@ -2388,6 +2739,7 @@ void sws_freeContext(SwsContext *c)
 
     for (i = 0; i < c->nb_slice_ctx; i++)
         sws_freeContext(c->slice_ctx[i]);
+    free_tiles(c);
     av_freep(&c->slice_ctx);
     av_freep(&c->slice_err);
 
@@ -2516,6 +2868,250 @@ struct SwsContext *sws_getCachedContext(struct SwsContext *context, int srcW,
     return context;
 }
 
+/* colorspace details of a pooled context as initialized */
+typedef struct PoolColorspace {
+    int inv_table[4], table[4];
+    int srcRange, dstRange;
+    int brightness, contrast, saturation;
+    int cascaded;
+} PoolColorspace;
+
+typedef struct PoolEntry {
+    SwsContext *c;
+    int in_use;
+    uint64_t last_used;
+
+    int srcW, srcH, dstW, dstH, flags;
+    enum AVPixelFormat srcFormat, dstFormat;
+    double param[2];
+    PoolColorspace cs;
+} PoolEntry;
+
+struct SwsContextPool {
+    AVMutex lock;
+    PoolEntry *entries;
+    int nb_entries;
+    int nb_idle;
+    int max_idle;
+    uint64_t clock;
+};
+
+SwsContextPool *sws_context_pool_alloc(int max_idle)
+{
+    SwsContextPool *pool = av_mallocz(sizeof(*pool));
+    if (!pool)
+        return NULL;
+
+    if (ff_mutex_init(&pool->lock, NULL)) {
+        av_free(pool);
+        return NULL;
+    }
+    pool->max_idle = FFMAX(max_idle, 0);
+    return pool;
+}
+
+void sws_context_pool_free(SwsContextPool **ppool)
+{
+    SwsContextPool *pool = *ppool;
+    if (!pool)
+        return;
+
+    for (int i = 0; i < pool->nb_entries; i++) {
+        av_assert0(!pool->entries[i].in_use);
+        sws_freeContext(pool->entries[i].c);
+    }
+    av_freep(&pool->entries);
+    ff_mutex_destroy(&pool->lock);
+    av_freep(ppool);
+}
+
+static void reset_context(SwsContext *c)
+{
+    if (!c)
+        return;
+
+    if (c->frame_src)
+        sws_frame_end(c);
+    c->sliceDir = 0;
+    for (int i = 0; i < FF_ARRAY_ELEMS(c->dither_error); i++)
+        if (c->dither_error[i])
+            memset(c->dither_error[i], 0, sizeof(c->dither_error[0][0]) * (c->dstW + 2));
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(c->cascaded_context); i++)
+        reset_context(c->cascaded_context[i]);
+    for (int i = 0; i < c->nb_slice_ctx; i++)
+        reset_context(c->slice_ctx[i]);
+    for (int i = 0; i < c->nb_tile_ctx; i++)
+        reset_context(c->tile_ctx[i]);
+}
+
+static int is_cascaded(const SwsContext *c)
+{
+    return !!(c->nb_slice_ctx ? c->slice_ctx[0] : c)->cascaded_context[0];
+}
+
+static void get_pool_colorspace(SwsContext *c, PoolColorspace *cs)
+{
+    int *inv_table, *table;
+
+    sws_getColorspaceDetails(c, &inv_table, &cs->srcRange, &table, &cs->dstRange,
+                             &cs->brightness, &cs->contrast, &cs->saturation);
+    memcpy(cs->inv_table, inv_table, sizeof(cs->inv_table));
+    memcpy(cs->table,     table,     sizeof(cs->table));
+    cs->cascaded = is_cascaded(c);
+}
+
+/* Restore the colorspace details a context was initialized with. Changing
+ * them can add cascaded contexts, which is not undone, so such contexts
+ * cannot be reused. */
+static int restore_pool_colorspace(SwsContext *c, const PoolColorspace *cs)
+{
+    PoolColorspace cur;
+    int ret;
+
+    get_pool_colorspace(c, &cur);
+    if (!memcmp(&cur, cs, sizeof(cur)))
+        return 0;
+
+    ret = sws_setColorspaceDetails(c, cs->inv_table, cs->srcRange,
+                                   cs->table, cs->dstRange, cs->brightness,
+                                   cs->contrast, cs->saturation);
+    if (ret < 0)
+        return ret;
+    return is_cascaded(c) == cs->cascaded ? 0 : AVERROR(EINVAL);
+}
+
+struct SwsContext *sws_context_pool_get(SwsContextPool *pool,
+                                        int srcW, int srcH, enum AVPixelFormat srcFormat,
+                                        int dstW, int dstH, enum AVPixelFormat dstFormat,
+                                        int flags, const double *param)
+{
+    static const double default_param[2] = { SWS_PARAM_DEFAULT,
+                                             SWS_PARAM_DEFAULT };
+    SwsContext *c = NULL;
+    PoolColorspace cs;
+    PoolEntry *e;
+    int best = -1;
+
+    if (!param)
+        param = default_param;
+
+    ff_mutex_lock(&pool->lock);
+    for (int i = 0; i < pool->nb_entries; i++) {
+        e = &pool->entries[i];
+        if (!e->in_use               &&
+            e->srcW      == srcW      &&
+            e->srcH      == srcH      &&
+            e->srcFormat == srcFormat &&
+            e->dstW      == dstW      &&
+            e->dstH      == dstH      &&
+            e->dstFormat == dstFormat &&
+            e->flags     == flags     &&
+            e->param[0]  == param[0]  &&
+            e->param[1]  == param[1]  &&
+            (best < 0 || e->last_used > pool->entries[best].last_used))
+            best = i;
+    }
+    if (best >= 0) {
+        e = &pool->entries[best];
+        e->in_use = 1;
+        pool->nb_idle--;
+        c  = e->c;
+        cs = e->cs;
+    }
+    ff_mutex_unlock(&pool->lock);
+
+    if (c) {
+        reset_context(c);
+        if (restore_pool_colorspace(c, &cs) >= 0)
+            return c;
+
+        ff_mutex_lock(&pool->lock);
+        for (int i = 0; i < pool->nb_entries; i++) {
+            if (pool->entries[i].c == c) {
+                pool->entries[i] = pool->entries[--pool->nb_entries];
+                break;
+            }
+        }
+        ff_mutex_unlock(&pool->lock);
+        sws_freeContext(c);
+    }
+
+    c = sws_getContext(srcW, srcH, srcFormat, dstW, dstH, dstFormat,
+                       flags, NULL, NULL, param);
+    if (!c)
+        return NULL;
+    get_pool_colorspace(c, &cs);
+
+    ff_mutex_lock(&pool->lock);
+    e = av_realloc_array(pool->entries, pool->nb_entries + 1, sizeof(*e));
+    if (e) {
+        pool->entries = e;
+        e = &pool->entries[pool->nb_entries++];
+        e->c         = c;
+        e->in_use    = 1;
+        e->last_used = 0;
+        e->srcW      = srcW;
+        e->srcH      = srcH;
+        e->srcFormat = srcFormat;
+        e->dstW      = dstW;
+        e->dstH      = dstH;
+        e->dstFormat = dstFormat;
+        e->flags     = flags;
+        e->param[0]  = param[0];
+        e->param[1]  = param[1];
+        e->cs        = cs;
+    }
+    ff_mutex_unlock(&pool->lock);
+
+    if (!e)
+        sws_freeContext(c);
+    return e ? c : NULL;
+}
+
+void sws_context_pool_release(SwsContextPool *pool, struct SwsContext **pc)
+{
+    SwsContext *evict = NULL, *c = *pc;
+    int idx = -1;
+
+    if (!c)
+        return;
+    *pc = NULL;
+
+    ff_mutex_lock(&pool->lock);
+    for (int i = 0; i < pool->nb_entries; i++) {
+        if (pool->entries[i].c == c) {
+            idx = i;
+            break;
+        }
+    }
+    if (idx >= 0) {
+        PoolEntry *e = &pool->entries[idx];
+        av_assert0(e->in_use);
+        e->in_use    = 0;
+        e->last_used = ++pool->clock;
+        pool->nb_idle++;
+
+        if (pool->nb_idle > pool->max_idle) {
+            int oldest = -1;
+            for (int i = 0; i < pool->nb_entries; i++) {
+                e = &pool->entries[i];
+                if (!e->in_use &&
+                    (oldest < 0 || e->last_used < pool->entries[oldest].last_used))
+                    oldest = i;
+            }
+            evict = pool->entries[oldest].c;
+            pool->entries[oldest] = pool->entries[--pool->nb_entries];
+            pool->nb_idle--;
+        }
+    } else {
+        evict = c;
+    }
+    ff_mutex_unlock(&pool->lock);
+
+    sws_freeContext(evict);
+}
+
 int ff_range_add(RangeList *rl, unsigned int start, unsigned int len)
 {
     Range *tmp;
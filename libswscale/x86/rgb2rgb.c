@@ -138,6 +138,21 @@ DECLARE_ALIGNED(8, extern const uint64_t, ff_bgr2UVOffset);
 
 #endif /* HAVE_INLINE_ASM */
 
+void ff_interleave_words_sse2(const uint16_t *src1, const uint16_t *src2,
+                              uint16_t *dst, int width, int shift);
+void ff_shift_words_sse2(const uint16_t *src, uint16_t *dst, int width, int shift);
+void ff_yuv422toyuyv16_sse2(const uint16_t *ysrc, const uint16_t *usrc,
+                            const uint16_t *vsrc, uint16_t *dst, int width,
+                            int shift);
+void ff_deinterleave_words_sse4(const uint16_t *src, uint16_t *dst1,
+                                uint16_t *dst2, int width, int shift);
+void ff_yuyv16toyuv422_sse4(uint16_t *ydst, uint16_t *udst, uint16_t *vdst,
+                            const uint16_t *src, int width, int shift);
+void ff_x2rgb10togbrp10_sse4(const uint8_t *src, uint16_t *gdst,
+                             uint16_t *bdst, uint16_t *rdst, int width);
+void ff_gbrp10tox2rgb10_sse4(const uint16_t *gsrc, const uint16_t *bsrc,
+                             const uint16_t *rsrc, uint8_t *dst, int width);
+
 void ff_shuffle_bytes_2103_mmxext(const uint8_t *src, uint8_t *dst, int src_size);
 void ff_shuffle_bytes_2103_ssse3(const uint8_t *src, uint8_t *dst, int src_size);
 void ff_shuffle_bytes_0321_ssse3(const uint8_t *src, uint8_t *dst, int src_size);
@@ -152,6 +167,18 @@ void ff_shuffle_bytes_1230_avx2(const uint8_t *src, uint8_t *dst, int src_size);
 void ff_shuffle_bytes_3012_avx2(const uint8_t *src, uint8_t *dst, int src_size);
 void ff_shuffle_bytes_3210_avx2(const uint8_t *src, uint8_t *dst, int src_size);
 
+void ff_interleave_words_avx2(const uint16_t *src1, const uint16_t *src2,
+                              uint16_t *dst, int width, int shift);
+void ff_shift_words_avx2(const uint16_t *src, uint16_t *dst, int width, int shift);
+void ff_deinterleave_words_avx2(const uint16_t *src, uint16_t *dst1,
+                                uint16_t *dst2, int width, int shift);
+void ff_yuyv16toyuv422_avx2(uint16_t *ydst, uint16_t *udst, uint16_t *vdst,
+                            const uint16_t *src, int width, int shift);
+void ff_x2rgb10togbrp10_avx2(const uint8_t *src, uint16_t *gdst,
+                             uint16_t *bdst, uint16_t *rdst, int width);
+void ff_gbrp10tox2rgb10_avx2(const uint16_t *gsrc, const uint16_t *bsrc,
+                             const uint16_t *rsrc, uint8_t *dst, int width);
+
 void ff_uyvytoyuv422_sse2(uint8_t *ydst, uint8_t *udst, uint8_t *vdst,
                           const uint8_t *src, int width, int height,
                           int lumStride, int chromStride, int srcStride);
@@ -181,6 +208,9 @@ av_cold void rgb2rgb_init_x86(void)
         shuffle_bytes_2103 = ff_shuffle_bytes_2103_mmxext;
     }
     if (EXTERNAL_SSE2(cpu_flags)) {
+        interleaveWords = ff_interleave_words_sse2;
+        shiftWords      = ff_shift_words_sse2;
+        yuv422toyuyv16  = ff_yuv422toyuyv16_sse2;
 #if ARCH_X86_64
         uyvytoyuv422 = ff_uyvytoyuv422_sse2;
 #endif
@@ -192,6 +222,12 @@ av_cold void rgb2rgb_init_x86(void)
         shuffle_bytes_3012 = ff_shuffle_bytes_3012_ssse3;
         shuffle_bytes_3210 = ff_shuffle_bytes_3210_ssse3;
     }
+    if (EXTERNAL_SSE4(cpu_flags)) {
+        deinterleaveWords = ff_deinterleave_words_sse4;
+        yuyv16toyuv422    = ff_yuyv16toyuv422_sse4;
+        x2rgb10togbrp10   = ff_x2rgb10togbrp10_sse4;
+        gbrp10tox2rgb10   = ff_gbrp10tox2rgb10_sse4;
+    }
 #if ARCH_X86_64
     if (EXTERNAL_AVX2_FAST(cpu_flags)) {
         shuffle_bytes_0321 = ff_shuffle_bytes_0321_avx2;
@@ -199,6 +235,12 @@ av_cold void rgb2rgb_init_x86(void)
         shuffle_bytes_1230 = ff_shuffle_bytes_1230_avx2;
         shuffle_bytes_3012 = ff_shuffle_bytes_3012_avx2;
         shuffle_bytes_3210 = ff_shuffle_bytes_3210_avx2;
+        interleaveWords    = ff_interleave_words_avx2;
+        deinterleaveWords  = ff_deinterleave_words_avx2;
+        shiftWords         = ff_shift_words_avx2;
+        yuyv16toyuv422     = ff_yuyv16toyuv422_avx2;
+        x2rgb10togbrp10    = ff_x2rgb10togbrp10_avx2;
+        gbrp10tox2rgb10    = ff_gbrp10tox2rgb10_avx2;
     }
     if (EXTERNAL_AVX(cpu_flags)) {
         uyvytoyuv422 = ff_uyvytoyuv422_avx;
@@ -309,3 +309,492 @@ UYVY_TO_YUV422
 INIT_XMM avx
 UYVY_TO_YUV422
 %endif
+
+;-----------------------------------------------------------------------------
+; interleave_words(const uint16_t *src1, const uint16_t *src2, uint16_t *dst,
+;                  int width, int shift)
+;-----------------------------------------------------------------------------
+%macro INTERLEAVE_WORDS 0
+cglobal interleave_words, 5, 6, 5, src1, src2, dst, w, shift, x
+    movd            xm4, shiftd
+    movsxdifnidn     wq, wd
+    mov              xq, wq
+
+    lea           src1q, [src1q + wq * 2]
+    lea           src2q, [src2q + wq * 2]
+    lea            dstq, [dstq  + wq * 4]
+    neg              wq
+
+;calc scalar loop
+    and              xq, mmsize / 2 - 1
+    je .scalar_end
+
+.loop_scalar:
+    pinsrw          xm0, [src1q + wq * 2], 0
+    pinsrw          xm0, [src2q + wq * 2], 1
+    psllw           xm0, xm4
+    movd [dstq + wq * 4], xm0
+    add              wq, 1
+    sub              xq, 1
+    jg .loop_scalar
+
+.scalar_end:
+;check if width < mmsize / 2
+    cmp              wq, 0
+    jge .end
+
+.loop_simd:
+%if cpuflag(avx2)
+    vpermq           m0, [src1q + wq * 2], q3120
+    vpermq           m1, [src2q + wq * 2], q3120
+%else
+    movu             m0, [src1q + wq * 2]
+    movu             m1, [src2q + wq * 2]
+%endif
+    psllw            m0, xm4
+    psllw            m1, xm4
+    punpckhwd        m2, m0, m1
+    punpcklwd        m0, m1
+    movu [dstq + wq * 4         ], m0
+    movu [dstq + wq * 4 + mmsize], m2
+    add              wq, mmsize / 2
+    jl .loop_simd
+
+.end:
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; deinterleave_words(const uint16_t *src, uint16_t *dst1, uint16_t *dst2,
+;                    int width, int shift)
+;-----------------------------------------------------------------------------
+%macro DEINTERLEAVE_WORDS 0
+cglobal deinterleave_words, 5, 6, 6, src, dst1, dst2, w, shift, x
+    movd            xm4, shiftd
+    pcmpeqd          m5, m5
+    psrld            m5, 16
+    movsxdifnidn     wq, wd
+    mov              xq, wq
+
+    lea            srcq, [srcq  + wq * 4]
+    lea           dst1q, [dst1q + wq * 2]
+    lea           dst2q, [dst2q + wq * 2]
+    neg              wq
+
+;calc scalar loop
+    and              xq, mmsize / 2 - 1
+    je .scalar_end
+
+.loop_scalar:
+    movd            xm0, [srcq + wq * 4]
+    psrlw           xm0, xm4
+    pextrw [dst1q + wq * 2], xm0, 0
+    pextrw [dst2q + wq * 2], xm0, 1
+    add              wq, 1
+    sub              xq, 1
+    jg .loop_scalar
+
+.scalar_end:
+;check if width < mmsize / 2
+    cmp              wq, 0
+    jge .end
+
+.loop_simd:
+    movu             m0, [srcq + wq * 4         ]
+    movu             m1, [srcq + wq * 4 + mmsize]
+    psrld            m2, m0, 16
+    psrld            m3, m1, 16
+    pand             m0, m5
+    pand             m1, m5
+    packusdw         m0, m1
+    packusdw         m2, m3
+%if cpuflag(avx2)
+    vpermq           m0, m0, q3120
+    vpermq           m2, m2, q3120
+%endif
+    psrlw            m0, xm4
+    psrlw            m2, xm4
+    movu [dst1q + wq * 2], m0
+    movu [dst2q + wq * 2], m2
+    add              wq, mmsize / 2
+    jl .loop_simd
+
+.end:
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; shift_words(const uint16_t *src, uint16_t *dst, int width, int shift)
+;-----------------------------------------------------------------------------
+%macro SHIFT_WORDS 0
+cglobal shift_words, 4, 5, 4, src, dst, w, shift, x
+    ; split shift into a left (m2) and a right (m3) shift count
+    xor              xd, xd
+    test         shiftd, shiftd
+    jge .left
+    neg          shiftd
+    xchg             xd, shiftd
+.left:
+    movd            xm2, shiftd
+    movd            xm3, xd
+
+    movsxdifnidn     wq, wd
+    mov              xq, wq
+
+    lea            srcq, [srcq + wq * 2]
+    lea            dstq, [dstq + wq * 2]
+    neg              wq
+
+;calc scalar loop
+    and              xq, mmsize / 2 - 1
+    je .scalar_end
+
+.loop_scalar:
+    pinsrw          xm0, [srcq + wq * 2], 0
+    psllw           xm0, xm2
+    psrlw           xm0, xm3
+    movd         shiftd, xm0
+    mov [dstq + wq * 2], shiftw
+    add              wq, 1
+    sub              xq, 1
+    jg .loop_scalar
+
+.scalar_end:
+;check if width < mmsize / 2
+    cmp              wq, 0
+    jge .end
+
+.loop_simd:
+    movu             m0, [srcq + wq * 2]
+    psllw            m0, xm2
+    psrlw            m0, xm3
+    movu [dstq + wq * 2], m0
+    add              wq, mmsize / 2
+    jl .loop_simd
+
+.end:
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; yuyv16toyuv422(uint16_t *ydst, uint16_t *udst, uint16_t *vdst,
+;                const uint16_t *src, int width, int shift)
+;-----------------------------------------------------------------------------
+%macro YUYV16_TO_YUV422 0
+cglobal yuyv16toyuv422, 6, 7, 8, ydst, udst, vdst, src, w, shift, x
+    movd            xm4, shiftd
+    pcmpeqd          m5, m5
+    psrld            m5, 16
+    movsxdifnidn     wq, wd
+    mov              xq, wq
+
+    ; w luma samples take w * 4 bytes of src and w bytes of each chroma plane
+    lea            srcq, [srcq  + wq * 4]
+    lea           ydstq, [ydstq + wq * 2]
+    add           udstq, wq
+    add           vdstq, wq
+    neg              wq
+
+;calc scalar loop
+    and              xq, mmsize - 1
+    je .scalar_end
+
+.loop_scalar:
+    movq            xm0, [srcq + wq * 4]
+    psrlw           xm0, xm4
+    pextrw [ydstq + wq * 2    ], xm0, 0
+    pextrw [udstq + wq        ], xm0, 1
+    pextrw [ydstq + wq * 2 + 2], xm0, 2
+    pextrw [vdstq + wq        ], xm0, 3
+    add              wq, 2
+    sub              xq, 2
+    jg .loop_scalar
+
+.scalar_end:
+;check if width < mmsize
+    cmp              wq, 0
+    jge .end
+
+.loop_simd:
+    movu             m0, [srcq + wq * 4             ]
+    movu             m1, [srcq + wq * 4 + mmsize    ]
+    movu             m2, [srcq + wq * 4 + mmsize * 2]
+    movu             m3, [srcq + wq * 4 + mmsize * 3]
+
+    ; extract y
+    pand             m6, m0, m5
+    pand             m7, m1, m5
+    packusdw         m6, m7
+    psrld            m0, 16
+    psrld            m1, 16
+    packusdw         m0, m1 ; UVUV...
+    pand             m7, m2, m5
+    pand             m1, m3, m5
+    packusdw         m7, m1
+    psrld            m2, 16
+    psrld            m3, 16
+    packusdw         m2, m3 ; UVUV...
+%if cpuflag(avx2)
+    vpermq           m6, m6, q3120
+    vpermq           m7, m7, q3120
+    vpermq           m0, m0, q3120
+    vpermq           m2, m2, q3120
+%endif
+    psrlw            m6, xm4
+    psrlw            m7, xm4
+    movu [ydstq + wq * 2         ], m6
+    movu [ydstq + wq * 2 + mmsize], m7
+
+    ; extract uv
+    psrld            m1, m0, 16
+    psrld            m3, m2, 16
+    pand             m0, m5
+    pand             m2, m5
+    packusdw         m0, m2 ; UUUU...
+    packusdw         m1, m3 ; VVVV...
+%if cpuflag(avx2)
+    vpermq           m0, m0, q3120
+    vpermq           m1, m1, q3120
+%endif
+    psrlw            m0, xm4
+    psrlw            m1, xm4
+    movu  [udstq + wq], m0
+    movu  [vdstq + wq], m1
+
+    add              wq, mmsize
+    jl .loop_simd
+
+.end:
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; yuv422toyuyv16(const uint16_t *ysrc, const uint16_t *usrc,
+;                const uint16_t *vsrc, uint16_t *dst, int width, int shift)
+;-----------------------------------------------------------------------------
+%macro YUV422_TO_YUYV16 0
+cglobal yuv422toyuyv16, 6, 7, 7, ysrc, usrc, vsrc, dst, w, shift, x
+    movd            xm6, shiftd
+    movsxdifnidn     wq, wd
+    mov              xq, wq
+
+    ; w luma samples take w * 4 bytes of dst and w bytes of each chroma plane
+    lea           ysrcq, [ysrcq + wq * 2]
+    add           usrcq, wq
+    add           vsrcq, wq
+    lea            dstq, [dstq  + wq * 4]
+    neg              wq
+
+;calc scalar loop
+    and              xq, mmsize - 1
+    je .scalar_end
+
+.loop_scalar:
+    pinsrw          xm0, [ysrcq + wq * 2    ], 0
+    pinsrw          xm0, [usrcq + wq        ], 1
+    pinsrw          xm0, [ysrcq + wq * 2 + 2], 2
+    pinsrw          xm0, [vsrcq + wq        ], 3
+    psllw           xm0, xm6
+    movq [dstq + wq * 4], xm0
+    add              wq, 2
+    sub              xq, 2
+    jg .loop_scalar
+
+.scalar_end:
+;check if width < mmsize
+    cmp              wq, 0
+    jge .end
+
+.loop_simd:
+    movu             m0, [ysrcq + wq * 2         ]
+    movu             m1, [ysrcq + wq * 2 + mmsize]
+    movu             m2, [usrcq + wq]
+    movu             m3, [vsrcq + wq]
+    psllw            m0, xm6
+    psllw            m1, xm6
+    psllw            m2, xm6
+    psllw            m3, xm6
+    punpckhwd        m4, m2, m3
+    punpcklwd        m2, m3 ; UVUV...
+    punpckhwd        m3, m0, m2
+    punpcklwd        m0, m2
+    punpckhwd        m5, m1, m4
+    punpcklwd        m1, m4
+    movu [dstq + wq * 4             ], m0
+    movu [dstq + wq * 4 + mmsize    ], m3
+    movu [dstq + wq * 4 + mmsize * 2], m1
+    movu [dstq + wq * 4 + mmsize * 3], m5
+    add              wq, mmsize
+    jl .loop_simd
+
+.end:
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; x2rgb10togbrp10(const uint8_t *src, uint16_t *gdst, uint16_t *bdst,
+;                 uint16_t *rdst, int width)
+;-----------------------------------------------------------------------------
+%macro X2RGB10_TO_GBRP10 0
+cglobal x2rgb10togbrp10, 5, 6, 6, src, gdst, bdst, rdst, w, x
+    pcmpeqd          m5, m5
+    psrld            m5, 22
+    movsxdifnidn     wq, wd
+    mov              xq, wq
+
+    lea            srcq, [srcq  + wq * 4]
+    lea           gdstq, [gdstq + wq * 2]
+    lea           bdstq, [bdstq + wq * 2]
+    lea           rdstq, [rdstq + wq * 2]
+    neg              wq
+
+;calc scalar loop
+    and              xq, mmsize / 2 - 1
+    je .scalar_end
+
+.loop_scalar:
+    movd            xm0, [srcq + wq * 4]
+    pand            xm1, xm0, xm5
+    psrld           xm0, 10
+    pand            xm2, xm0, xm5
+    psrld           xm0, 10
+    pand            xm0, xm5
+    pextrw [bdstq + wq * 2], xm1, 0
+    pextrw [gdstq + wq * 2], xm2, 0
+    pextrw [rdstq + wq * 2], xm0, 0
+    add              wq, 1
+    sub              xq, 1
+    jg .loop_scalar
+
+.scalar_end:
+;check if width < mmsize / 2
+    cmp              wq, 0
+    jge .end
+
+.loop_simd:
+    movu             m0, [srcq + wq * 4         ]
+    movu             m1, [srcq + wq * 4 + mmsize]
+    pand             m2, m0, m5
+    pand             m3, m1, m5
+    packusdw         m2, m3 ; B
+    psrld            m0, 10
+    psrld            m1, 10
+    pand             m3, m0, m5
+    pand             m4, m1, m5
+    packusdw         m3, m4 ; G
+    psrld            m0, 10
+    psrld            m1, 10
+    pand             m0, m5
+    pand             m1, m5
+    packusdw         m0, m1 ; R
+%if cpuflag(avx2)
+    vpermq           m2, m2, q3120
+    vpermq           m3, m3, q3120
+    vpermq           m0, m0, q3120
+%endif
+    movu [bdstq + wq * 2], m2
+    movu [gdstq + wq * 2], m3
+    movu [rdstq + wq * 2], m0
+    add              wq, mmsize / 2
+    jl .loop_simd
+
+.end:
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; gbrp10tox2rgb10(const uint16_t *gsrc, const uint16_t *bsrc,
+;                 const uint16_t *rsrc, uint8_t *dst, int width)
+;-----------------------------------------------------------------------------
+; %1 g / high words ; %2 b / low words ; %3 r ; %4 tmp ; %5 pw_1023 ; %6 pw_0xc000
+%macro PACK_X2RGB10 6
+    pminuw           %1, %5
+    pminuw           %2, %5
+    pminuw           %3, %5
+    psllw            %4, %1, 10
+    por              %2, %4     ; b | g << 10
+    psrlw            %1, 6
+    psllw            %3, 4
+    por              %1, %3
+    por              %1, %6     ; 3 << 14 | r << 4 | g >> 6
+%endmacro
+
+%macro GBRP10_TO_X2RGB10 0
+cglobal gbrp10tox2rgb10, 5, 6, 7, gsrc, bsrc, rsrc, dst, w, x
+    pcmpeqw          m5, m5
+    psrlw            m5, 6
+    pcmpeqw          m6, m6
+    psllw            m6, 14
+    movsxdifnidn     wq, wd
+    mov              xq, wq
+
+    lea           gsrcq, [gsrcq + wq * 2]
+    lea           bsrcq, [bsrcq + wq * 2]
+    lea           rsrcq, [rsrcq + wq * 2]
+    lea            dstq, [dstq  + wq * 4]
+    neg              wq
+
+;calc scalar loop
+    and              xq, mmsize / 2 - 1
+    je .scalar_end
+
+.loop_scalar:
+    pinsrw          xm0, [gsrcq + wq * 2], 0
+    pinsrw          xm1, [bsrcq + wq * 2], 0
+    pinsrw          xm2, [rsrcq + wq * 2], 0
+    PACK_X2RGB10    xm0, xm1, xm2, xm3, xm5, xm6
+    punpcklwd       xm1, xm0
+    movd [dstq + wq * 4], xm1
+    add              wq, 1
+    sub              xq, 1
+    jg .loop_scalar
+
+.scalar_end:
+;check if width < mmsize / 2
+    cmp              wq, 0
+    jge .end
+
+.loop_simd:
+%if cpuflag(avx2)
+    vpermq           m0, [gsrcq + wq * 2], q3120
+    vpermq           m1, [bsrcq + wq * 2], q3120
+    vpermq           m2, [rsrcq + wq * 2], q3120
+%else
+    movu             m0, [gsrcq + wq * 2]
+    movu             m1, [bsrcq + wq * 2]
+    movu             m2, [rsrcq + wq * 2]
+%endif
+    PACK_X2RGB10     m0, m1, m2, m3, m5, m6
+    punpckhwd        m2, m1, m0
+    punpcklwd        m1, m0
+    movu [dstq + wq * 4         ], m1
+    movu [dstq + wq * 4 + mmsize], m2
+    add              wq, mmsize / 2
+    jl .loop_simd
+
+.end:
+    RET
+%endmacro
+
+INIT_XMM sse2
+INTERLEAVE_WORDS
+SHIFT_WORDS
+YUV422_TO_YUYV16
+
+INIT_XMM sse4
+DEINTERLEAVE_WORDS
+YUYV16_TO_YUV422
+X2RGB10_TO_GBRP10
+GBRP10_TO_X2RGB10
+
+%if ARCH_X86_64
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+INTERLEAVE_WORDS
+DEINTERLEAVE_WORDS
+SHIFT_WORDS
+YUYV16_TO_YUV422
+X2RGB10_TO_GBRP10
+GBRP10_TO_X2RGB10
+%endif
+%endif
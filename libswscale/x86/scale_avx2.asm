@@ -22,8 +22,9 @@
 
 %include "libavutil/x86/x86util.asm"
 
-SECTION_RODATA 32
+SECTION_RODATA 64
 
+swizzle512: dd 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
 swizzle: dd 0, 4, 1, 5, 2, 6, 3, 7
 four: times 8 dd 4
 
@@ -43,19 +44,47 @@ SECTION .text
 ; pixels, the position of the first pixel is given in filterPos[nOutputPixel].
 ;-----------------------------------------------------------------------------
 
+; vphaddd has no EVEX form, emulate it with two shuffles
+%macro PHADDD 3 ; dst, src1, src2
+%if mmsize == 64
+    vshufps  m13, %2, %3, q2020
+    vshufps  %1,  %2, %3, q3131
+    paddd    %1, m13
+%else
+    vphaddd  %1, %2, %3
+%endif
+%endmacro
+
+%macro GATHERDD 2 ; dst, addr
+%if mmsize == 64
+    kxnorw     k1, k1, k1
+    vpgatherdd %1{k1}, %2
+%else
+    vpcmpeqd   m13, m13
+    vpgatherdd %1, %2, m13
+%endif
+%endmacro
+
+; The AVX2 version handles 16 output pixels per iteration and the AVX-512 one
+; 32, the filter positions and coefficients are reordered accordingly by
+; ff_shuffle_filter_coefficients().
 %macro SCALE_FUNC 1
 cglobal hscale8to15_%1, 7, 9, 16, pos0, dst, w, srcmem, filter, fltpos, fltsize, count, inner
     pxor m0, m0
+%if mmsize == 64
+    mova m15, [swizzle512]
+%else
     mova m15, [swizzle]
+%endif
     xor countq, countq
     movsxd wq, wd
 %ifidn %1, X4
-    mova m14, [four]
+    vpbroadcastd m14, [four]
     shr fltsized, 2
 %endif
 .loop:
     movu m1, [fltposq]
-    movu m2, [fltposq+32]
+    movu m2, [fltposq+mmsize]
 %ifidn %1, X4
     pxor m9, m9
     pxor m10, m10
@@ -64,19 +93,17 @@ cglobal hscale8to15_%1, 7, 9, 16, pos0, dst, w, srcmem, filter, fltpos, fltsize,
     xor innerq, innerq
 .innerloop:
 %endif
-    vpcmpeqd  m13, m13
-    vpgatherdd m3,[srcmemq + m1], m13
-    vpcmpeqd  m13, m13
-    vpgatherdd m4,[srcmemq + m2], m13
+    GATHERDD m3, [srcmemq + m1]
+    GATHERDD m4, [srcmemq + m2]
     vpunpcklbw m5, m3, m0
     vpunpckhbw m6, m3, m0
     vpunpcklbw m7, m4, m0
     vpunpckhbw m8, m4, m0
     vpmaddwd m5, m5, [filterq]
-    vpmaddwd m6, m6, [filterq + 32]
-    vpmaddwd m7, m7, [filterq + 64]
-    vpmaddwd m8, m8, [filterq + 96]
-    add filterq, 0x80
+    vpmaddwd m6, m6, [filterq + mmsize]
+    vpmaddwd m7, m7, [filterq + 2*mmsize]
+    vpmaddwd m8, m8, [filterq + 3*mmsize]
+    add filterq, 4*mmsize
 %ifidn %1, X4
     paddd m9, m5
     paddd m10, m6
@@ -87,19 +114,19 @@ cglobal hscale8to15_%1, 7, 9, 16, pos0, dst, w, srcmem, filter, fltpos, fltsize,
     add innerq, 1
     cmp innerq, fltsizeq
     jl .innerloop
-    vphaddd m5, m9, m10
-    vphaddd m6, m11, m12
+    PHADDD m5, m9, m10
+    PHADDD m6, m11, m12
 %else
-    vphaddd m5, m5, m6
-    vphaddd m6, m7, m8
+    PHADDD m5, m5, m6
+    PHADDD m6, m7, m8
 %endif
     vpsrad  m5, 7
     vpsrad  m6, 7
     vpackssdw m5, m5, m6
     vpermd m5, m15, m5
-    vmovdqu [dstq + countq * 2], m5
-    add fltposq, 0x40
-    add countq, 0x10
+    movu [dstq + countq * 2], m5
+    add fltposq, 2*mmsize
+    add countq, mmsize/2
     cmp countq, wq
     jl .loop
 REP_RET
@@ -111,4 +138,9 @@ INIT_YMM avx2
 SCALE_FUNC 4
 SCALE_FUNC X4
 %endif
+%if HAVE_AVX512_EXTERNAL
+INIT_ZMM avx512
+SCALE_FUNC 4
+SCALE_FUNC X4
+%endif
 %endif
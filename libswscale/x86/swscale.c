@@ -236,6 +236,9 @@ YUV2YUVX_FUNC(sse3, 32)
 #if HAVE_AVX2_EXTERNAL
 YUV2YUVX_FUNC(avx2, 64)
 #endif
+#if HAVE_AVX512_EXTERNAL
+YUV2YUVX_FUNC(avx512, 128)
+#endif
 
 #define SCALE_FUNC(filter_n, from_bpc, to_bpc, opt) \
 void ff_hscale ## from_bpc ## to ## to_bpc ## _ ## filter_n ## _ ## opt( \
@@ -278,6 +281,8 @@ SCALE_FUNCS_SSE(sse4);
 
 SCALE_FUNC(4, 8, 15, avx2);
 SCALE_FUNC(X4, 8, 15, avx2);
+SCALE_FUNC(4, 8, 15, avx512);
+SCALE_FUNC(X4, 8, 15, avx512);
 
 #define VSCALEX_FUNC(size, opt) \
 void ff_yuv2planeX_ ## size ## _ ## opt(const int16_t *filter, int filterSize, \
@@ -494,6 +499,10 @@ av_cold void ff_sws_init_swscale_x86(SwsContext *c)
 #if HAVE_AVX2_EXTERNAL
         if (EXTERNAL_AVX2_FAST(cpu_flags))
             c->yuv2planeX = yuv2yuvX_avx2;
+#endif
+#if HAVE_AVX512_EXTERNAL
+        if (EXTERNAL_AVX512(cpu_flags))
+            c->yuv2planeX = yuv2yuvX_avx512;
 #endif
     }
 
@@ -698,6 +707,22 @@ switch(c->dstBpc){ \
         }
     }
 
+#define ASSIGN_AVX512_SCALE_FUNC(hscalefn, filtersize) \
+    switch (filtersize) { \
+    case 4:  hscalefn = ff_hscale8to15_4_avx512; break; \
+    default: hscalefn = ff_hscale8to15_X4_avx512; break; \
+    }
+
+    /* must match the filter layout chosen by ff_shuffle_filter_coefficients() */
+    if (EXTERNAL_AVX512(cpu_flags) && !(cpu_flags & AV_CPU_FLAG_SLOW_GATHER)) {
+        if ((c->srcBpc == 8) && (c->dstBpc <= 14)) {
+            if (c->chrDstW % 32 == 0)
+                ASSIGN_AVX512_SCALE_FUNC(c->hcScale, c->hChrFilterSize);
+            if (c->dstW % 32 == 0)
+                ASSIGN_AVX512_SCALE_FUNC(c->hyScale, c->hLumFilterSize);
+        }
+    }
+
     if (EXTERNAL_AVX2_FAST(cpu_flags)) {
         switch (c->dstFormat) {
         case AV_PIX_FMT_NV12:
@@ -22,6 +22,10 @@
 
 %include "libavutil/x86/x86util.asm"
 
+SECTION_RODATA 64
+
+permq512: dq 0, 2, 4, 6, 1, 3, 5, 7
+
 SECTION .text
 
 ;-----------------------------------------------------------------------------
@@ -109,7 +113,11 @@ cglobal yuv2yuvX, 7, 7, 8, filter, filterSize, src, dest, dstW, dither, offset
     packuswb             m6, m6, m1
 %endif
     mov                  srcq, [filterq]
-%if cpuflag(avx2)
+%if cpuflag(avx512)
+    mova                 m0, [permq512]
+    vpermq               m3, m0, m3
+    vpermq               m6, m0, m6
+%elif cpuflag(avx2)
     vpermq               m3, m3, 216
     vpermq               m6, m6, 216
 %endif
@@ -134,3 +142,7 @@ YUV2YUVX_FUNC
 INIT_YMM avx2
 YUV2YUVX_FUNC
 %endif
+%if HAVE_AVX512_EXTERNAL
+INIT_ZMM avx512
+YUV2YUVX_FUNC
+%endif
@@ -0,0 +1,274 @@
+/*
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Decoder buffer requirements test.
+ * Encodes a few MPEG-4 frames and decodes them with a caller provided
+ * get_buffer2(), checking the requirements reported through
+ * AVCodecContext.buffer_requirements and avcodec_get_buffer_requirements(),
+ * and that buffers not meeting them are rejected.
+ */
+
+#include <string.h>
+
+#include "libavcodec/avcodec.h"
+#include "libavutil/buffer.h"
+#include "libavutil/common.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/mem.h"
+#include "libavutil/pixdesc.h"
+
+#define WIDTH      100
+#define HEIGHT     60
+#define NB_FRAMES  3
+
+typedef struct TestState {
+    int misalign;                   /* offset the data pointers by one byte */
+    int nb_calls;                   /* calls of the buffer_requirements callback */
+    int nb_buffers;                 /* buffers returned by get_buffer2() */
+    int failed;
+    AVCodecBufferRequirements req;  /* last reported requirements */
+} TestState;
+
+static int is_pow2(int x)
+{
+    return x > 0 && !(x & (x - 1));
+}
+
+static int buffer_requirements(AVCodecContext *avctx,
+                               const AVCodecBufferRequirements *req)
+{
+    TestState *s = avctx->opaque;
+    AVCodecBufferRequirements *cur;
+    int planes = av_pix_fmt_count_planes(req->format);
+
+    s->nb_calls++;
+    s->req = *req;
+
+    if (req->format != AV_PIX_FMT_YUV420P ||
+        req->width < WIDTH || req->height < HEIGHT ||
+        !is_pow2(req->data_align) || req->padding < 0) {
+        av_log(avctx, AV_LOG_ERROR, "Invalid requirements: %s %dx%d, "
+               "data_align %d, padding %d\n", av_get_pix_fmt_name(req->format),
+               req->width, req->height, req->data_align, req->padding);
+        s->failed = 1;
+    }
+    for (int i = 0; i < planes; i++) {
+        if (!is_pow2(req->linesize_align[i])) {
+            av_log(avctx, AV_LOG_ERROR, "Invalid linesize_align[%d] %d\n",
+                   i, req->linesize_align[i]);
+            s->failed = 1;
+        }
+    }
+
+    /* the same requirements must be available on demand */
+    cur = avcodec_get_buffer_requirements(avctx);
+    if (!cur || memcmp(cur, req, sizeof(*req))) {
+        av_log(avctx, AV_LOG_ERROR, "avcodec_get_buffer_requirements() does "
+               "not match the reported requirements\n");
+        s->failed = 1;
+    }
+    av_free(cur);
+
+    return 0;
+}
+
+static int get_buffer(AVCodecContext *avctx, AVFrame *frame, int flags)
+{
+    TestState *s = avctx->opaque;
+    const AVCodecBufferRequirements *req = &s->req;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(frame->format);
+    int planes = av_pix_fmt_count_planes(frame->format);
+
+    if (!s->nb_calls || frame->format != req->format ||
+        frame->width > req->width || frame->height > req->height) {
+        av_log(avctx, AV_LOG_ERROR, "get_buffer2() called without matching "
+               "requirements\n");
+        s->failed = 1;
+        return AVERROR(EINVAL);
+    }
+
+    for (int i = 0; i < planes; i++) {
+        const int h     = i ? AV_CEIL_RSHIFT(req->height, desc->log2_chroma_h) : req->height;
+        const int align = FFMAX(req->linesize_align[i], req->data_align);
+        int linesize    = av_image_get_linesize(req->format, req->width, i);
+
+        if (linesize < 0)
+            return linesize;
+        linesize = FFALIGN(linesize, align);
+
+        /* av_buffer_alloc() is aligned enough for any data_align */
+        frame->buf[i] = av_buffer_alloc(linesize * h + req->padding + s->misalign);
+        if (!frame->buf[i])
+            return AVERROR(ENOMEM);
+        frame->data[i]     = frame->buf[i]->data + s->misalign;
+        frame->linesize[i] = linesize;
+    }
+    frame->extended_data = frame->data;
+    s->nb_buffers++;
+
+    return 0;
+}
+
+static int encode(AVPacket **pkts)
+{
+    const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    AVCodecContext *ctx = NULL;
+    AVFrame *frame = NULL;
+    AVPacket *pkt = NULL;
+    int nb_pkts = 0, ret;
+
+    ctx   = avcodec_alloc_context3(codec);
+    frame = av_frame_alloc();
+    pkt   = av_packet_alloc();
+    if (!ctx || !frame || !pkt) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    ctx->width     = WIDTH;
+    ctx->height    = HEIGHT;
+    ctx->pix_fmt   = AV_PIX_FMT_YUV420P;
+    ctx->time_base = (AVRational){ 1, 25 };
+    ret = avcodec_open2(ctx, codec, NULL);
+    if (ret < 0)
+        goto end;
+
+    frame->width  = WIDTH;
+    frame->height = HEIGHT;
+    frame->format = AV_PIX_FMT_YUV420P;
+    ret = av_frame_get_buffer(frame, 0);
+    if (ret < 0)
+        goto end;
+
+    for (int i = 0; i <= NB_FRAMES; i++) {
+        AVFrame *in = i < NB_FRAMES ? frame : NULL;
+
+        if (in) {
+            ret = av_frame_make_writable(frame);
+            if (ret < 0)
+                goto end;
+            for (int p = 0; p < 3; p++) {
+                const int h = p ? HEIGHT / 2 : HEIGHT;
+                const int w = p ? WIDTH  / 2 : WIDTH;
+                for (int y = 0; y < h; y++)
+                    for (int x = 0; x < w; x++)
+                        frame->data[p][y * frame->linesize[p] + x] = x * 3 + y * (p + 1) + i * 8;
+            }
+            frame->pts = i;
+        }
+
+        ret = avcodec_send_frame(ctx, in);
+        if (ret < 0)
+            goto end;
+        while ((ret = avcodec_receive_packet(ctx, pkt)) >= 0)
+            pkts[nb_pkts++] = av_packet_clone(pkt);
+        if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+            goto end;
+    }
+    ret = nb_pkts;
+
+end:
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+    return ret;
+}
+
+/* return the number of decoded frames or a negative error code */
+static int decode(AVPacket **pkts, int nb_pkts, TestState *s)
+{
+    const AVCodec *codec = avcodec_find_decoder(AV_CODEC_ID_MPEG4);
+    AVCodecContext *ctx = NULL;
+    AVFrame *frame = NULL;
+    int nb_frames = 0, ret;
+
+    ctx   = avcodec_alloc_context3(codec);
+    frame = av_frame_alloc();
+    if (!ctx || !frame) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    ctx->opaque              = s;
+    ctx->thread_count        = 1;
+    ctx->thread_type         = 0;
+    ctx->get_buffer2         = get_buffer;
+    ctx->buffer_requirements = buffer_requirements;
+    ret = avcodec_open2(ctx, codec, NULL);
+    if (ret < 0)
+        goto end;
+
+    for (int i = 0; i <= nb_pkts; i++) {
+        ret = avcodec_send_packet(ctx, i < nb_pkts ? pkts[i] : NULL);
+        if (ret < 0)
+            goto end;
+        while ((ret = avcodec_receive_frame(ctx, frame)) >= 0) {
+            nb_frames++;
+            av_frame_unref(frame);
+        }
+        if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+            goto end;
+    }
+    ret = nb_frames;
+
+end:
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+    return ret;
+}
+
+int main(void)
+{
+    AVPacket *pkts[NB_FRAMES * 2] = { NULL };
+    TestState s = { 0 };
+    int nb_pkts, ret = 1;
+
+    nb_pkts = encode(pkts);
+    if (nb_pkts <= 0) {
+        av_log(NULL, AV_LOG_ERROR, "Encoding failed\n");
+        goto end;
+    }
+
+    /* buffers meeting the requirements */
+    ret = decode(pkts, nb_pkts, &s);
+    if (ret != NB_FRAMES || s.failed || s.nb_calls != 1) {
+        av_log(NULL, AV_LOG_ERROR, "Decoding with matching buffers failed: "
+               "%d frames, %d callback calls\n", ret, s.nb_calls);
+        ret = 1;
+        goto end;
+    }
+
+    /* misaligned data pointers must be rejected after get_buffer2() */
+    memset(&s, 0, sizeof(s));
+    s.misalign = 1;
+    ret = decode(pkts, nb_pkts, &s);
+    if (ret >= 0 || !s.nb_buffers || s.failed) {
+        av_log(NULL, AV_LOG_ERROR, "Misaligned buffers were not rejected: %d\n", ret);
+        ret = 1;
+        goto end;
+    }
+
+    ret = 0;
+end:
+    for (int i = 0; i < FF_ARRAY_ELEMS(pkts); i++)
+        av_packet_free(&pkts[i]);
+    return ret;
+}
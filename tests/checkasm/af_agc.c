@@ -0,0 +1,122 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavfilter/af_agc.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem_internal.h"
+#include "checkasm.h"
+
+#define LEN 480
+
+static void randomize_flt(float *buf, int len)
+{
+    for (int i = 0; i < len; i++)
+        buf[i] = (int)(rnd() & 0xffff) / 16384.f - 2.f;
+}
+
+static void randomize_s16(int16_t *buf, int len)
+{
+    for (int i = 0; i < len; i++)
+        buf[i] = rnd();
+}
+
+static void check_peak(const AGCDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(float,   src_flt, [LEN]);
+    LOCAL_ALIGNED_32(int16_t, src_s16, [LEN]);
+
+    randomize_flt(src_flt, LEN);
+    randomize_s16(src_s16, LEN);
+    src_s16[LEN / 3] = INT16_MIN;
+
+    if (check_func(dsp->peak_flt, "agc_peak_flt")) {
+        float ref, new;
+        declare_func_float(float, const float *src, ptrdiff_t len);
+
+        ref = call_ref(src_flt, LEN);
+        new = call_new(src_flt, LEN);
+        if (ref != new)
+            fail();
+        bench_new(src_flt, LEN);
+    }
+
+    if (check_func(dsp->peak_s16, "agc_peak_s16")) {
+        int ref, new;
+        declare_func(int, const int16_t *src, ptrdiff_t len);
+
+        for (int len = 16; len <= LEN; len += LEN - 16) {
+            ref = call_ref(src_s16, len);
+            new = call_new(src_s16, len);
+            if (ref != new)
+                fail();
+        }
+        bench_new(src_s16, LEN);
+    }
+}
+
+static void check_ramp(const AGCDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(float,   src_flt,  [LEN]);
+    LOCAL_ALIGNED_32(float,   dst0_flt, [LEN]);
+    LOCAL_ALIGNED_32(float,   dst1_flt, [LEN]);
+    LOCAL_ALIGNED_32(int16_t, src_s16,  [LEN]);
+    LOCAL_ALIGNED_32(int16_t, dst0_s16, [LEN]);
+    LOCAL_ALIGNED_32(int16_t, dst1_s16, [LEN]);
+    const float gain = 0.25f + (rnd() & 0xffff) / 16384.f;
+    const float step = ((int)(rnd() & 0xffff) - 0x8000) / (float)(1 << 27);
+
+    randomize_flt(src_flt, LEN);
+    randomize_s16(src_s16, LEN);
+
+    if (check_func(dsp->ramp_flt, "agc_ramp_flt")) {
+        declare_func(void, float *dst, const float *src, ptrdiff_t len,
+                     float gain, float step);
+
+        call_ref(dst0_flt, src_flt, LEN, gain, step);
+        call_new(dst1_flt, src_flt, LEN, gain, step);
+        if (memcmp(dst0_flt, dst1_flt, LEN * sizeof(*dst0_flt)))
+            fail();
+        bench_new(dst1_flt, src_flt, LEN, gain, step);
+    }
+
+    if (check_func(dsp->ramp_s16, "agc_ramp_s16")) {
+        declare_func(void, int16_t *dst, const int16_t *src, ptrdiff_t len,
+                     float gain, float step);
+
+        call_ref(dst0_s16, src_s16, LEN, gain, step);
+        call_new(dst1_s16, src_s16, LEN, gain, step);
+        if (memcmp(dst0_s16, dst1_s16, LEN * sizeof(*dst0_s16)))
+            fail();
+        bench_new(dst1_s16, src_s16, LEN, gain, step);
+    }
+}
+
+void checkasm_check_agc(void)
+{
+    AGCDSPContext dsp;
+
+    ff_agc_init(&dsp);
+
+    check_peak(&dsp);
+    report("peak");
+
+    check_ramp(&dsp);
+    report("ramp");
+}
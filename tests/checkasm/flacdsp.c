@@ -21,6 +21,7 @@
 #include <string.h>
 #include "checkasm.h"
 #include "libavcodec/flacdsp.h"
+#include "libavcodec/mathops.h"
 #include "libavutil/common.h"
 #include "libavutil/internal.h"
 #include "libavutil/intreadwrite.h"
@@ -54,6 +55,35 @@ static void check_decorrelate(uint8_t **ref_dst, uint8_t **ref_src, uint8_t **ne
     bench_new(new_dst, (int32_t **)new_src, channels, BUF_SIZE / sizeof(int32_t), 8);
 }
 
+static void check_lpc16_encode(void)
+{
+    /* the SIMD versions read and write past the end of the buffers */
+    LOCAL_ALIGNED_16(int32_t, smp,     [BUF_SIZE + 32]);
+    LOCAL_ALIGNED_16(int32_t, ref_res, [BUF_SIZE + 32]);
+    LOCAL_ALIGNED_16(int32_t, new_res, [BUF_SIZE + 32]);
+    int32_t coefs[32];
+    int order, len, i;
+
+    declare_func(void, int32_t *res, const int32_t *smp, int len, int order,
+                 const int32_t *coefs, int shift);
+
+    for (i = 0; i < BUF_SIZE + 32; i++)
+        smp[i] = sign_extend(rnd(), 16);
+
+    for (order = 1; order <= 32; order++) {
+        for (i = 0; i < order; i++)
+            coefs[i] = sign_extend(rnd(), 11);
+        /* the last block of a stream can have any length, so also cover
+         * lengths that are not a multiple of the vector width */
+        len = order & 1 ? BUF_SIZE - rnd() % 32 : BUF_SIZE;
+        call_ref(ref_res, smp, len, order, coefs, 12);
+        call_new(new_res, smp, len, order, coefs, 12);
+        if (memcmp(ref_res, new_res, len * sizeof(*ref_res)))
+            fail();
+    }
+    bench_new(new_res, smp, BUF_SIZE, 32, coefs, 12);
+}
+
 void checkasm_check_flacdsp(void)
 {
     LOCAL_ALIGNED_16(uint8_t, ref_dst, [BUF_SIZE*MAX_CHANNELS]);
@@ -88,4 +118,9 @@ void checkasm_check_flacdsp(void)
     }
 
     report("decorrelate");
+
+    ff_flacdsp_init(&h, AV_SAMPLE_FMT_S16, 2, 0);
+    if (check_func(h.lpc16_encode, "flac_enc_lpc_16"))
+        check_lpc16_encode();
+    report("lpc16_encode");
 }
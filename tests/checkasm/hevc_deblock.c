@@ -0,0 +1,166 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#include "libavcodec/hevcdsp.h"
+
+#include "checkasm.h"
+
+#define SIZEOF_PIXEL ((bit_depth + 7) / 8)
+#define BUF_STRIDE (16 * 2)
+#define BUF_LINES 16
+#define BUF_SIZE (BUF_STRIDE * BUF_LINES)
+#define ITERATIONS 64
+
+static const char *const dir_names[2] = { "h", "v" };
+
+// An edge between two noisy flat areas, across rows for the horizontal
+// filters and across columns for the vertical ones. The step and the noise
+// are drawn so that all of the strong, normal and no filter decisions are
+// taken.
+static void randomize_edge(uint8_t *buf0, uint8_t *buf1, int bit_depth, int vertical)
+{
+    const int max   = (1 << bit_depth) - 1;
+    const int scale = 1 << (bit_depth - 8);
+    const int noise = (rnd() % 5) * scale;
+    const int step  = ((int)(rnd() % 49) - 24) * scale;
+    const int base  = rnd() % (max + 1);
+    int x, y;
+
+    for (y = 0; y < BUF_LINES; y++) {
+        for (x = 0; x < BUF_STRIDE / SIZEOF_PIXEL; x++) {
+            const int q = (vertical ? x : y) >= 8;
+            int v = base + q * step;
+
+            if (noise)
+                v += (int)(rnd() % (2 * noise + 1)) - noise;
+            v = av_clip(v, 0, max);
+            if (SIZEOF_PIXEL == 1) {
+                buf0[y * BUF_STRIDE + x] = v;
+            } else {
+                AV_WN16A(buf0 + y * BUF_STRIDE + 2 * x, v);
+            }
+        }
+    }
+    memcpy(buf1, buf0, BUF_SIZE);
+}
+
+static void randomize_params(int *tc, uint8_t *no_p, uint8_t *no_q)
+{
+    int j;
+
+    for (j = 0; j < 2; j++) {
+        tc[j]   = rnd() % 25;
+        // the decoder calls the _c variants when a side must not be
+        // filtered (PCM or lossless blocks), so the SIMD ones ignore these
+        no_p[j] = 0;
+        no_q[j] = 0;
+    }
+}
+
+static void check_deblock_luma(HEVCDSPContext *h, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, buf0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, buf1, [BUF_SIZE]);
+    int tc[2], beta, dir, i;
+    uint8_t no_p[2], no_q[2];
+
+    declare_func(void, uint8_t *pix, ptrdiff_t stride, int beta, int *tc,
+                 uint8_t *no_p, uint8_t *no_q);
+
+    for (dir = 0; dir < 2; dir++) {
+        void (*func)(uint8_t *pix, ptrdiff_t stride, int beta, int *tc,
+                     uint8_t *no_p, uint8_t *no_q) =
+            dir ? h->hevc_v_loop_filter_luma : h->hevc_h_loop_filter_luma;
+        // the edge lies between the 8th and 9th row or column
+        const int offset = dir ? 8 * SIZEOF_PIXEL + 4 * BUF_STRIDE
+                               : 8 * BUF_STRIDE + 4 * SIZEOF_PIXEL;
+
+        if (check_func(func, "hevc_%s_loop_filter_luma_%d", dir_names[dir], bit_depth)) {
+            for (i = 0; i < ITERATIONS; i++) {
+                randomize_edge(buf0, buf1, bit_depth, dir);
+                randomize_params(tc, no_p, no_q);
+                beta = rnd() % 65;
+
+                call_ref(buf0 + offset, BUF_STRIDE, beta, tc, no_p, no_q);
+                call_new(buf1 + offset, BUF_STRIDE, beta, tc, no_p, no_q);
+                if (memcmp(buf0, buf1, BUF_SIZE))
+                    fail();
+            }
+            bench_new(buf1 + offset, BUF_STRIDE, beta, tc, no_p, no_q);
+        }
+    }
+}
+
+static void check_deblock_chroma(HEVCDSPContext *h, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, buf0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, buf1, [BUF_SIZE]);
+    int tc[2], dir, i;
+    uint8_t no_p[2], no_q[2];
+
+    declare_func(void, uint8_t *pix, ptrdiff_t stride, int *tc,
+                 uint8_t *no_p, uint8_t *no_q);
+
+    for (dir = 0; dir < 2; dir++) {
+        void (*func)(uint8_t *pix, ptrdiff_t stride, int *tc,
+                     uint8_t *no_p, uint8_t *no_q) =
+            dir ? h->hevc_v_loop_filter_chroma : h->hevc_h_loop_filter_chroma;
+        const int offset = dir ? 8 * SIZEOF_PIXEL + 4 * BUF_STRIDE
+                               : 8 * BUF_STRIDE + 4 * SIZEOF_PIXEL;
+
+        if (check_func(func, "hevc_%s_loop_filter_chroma_%d", dir_names[dir], bit_depth)) {
+            for (i = 0; i < ITERATIONS; i++) {
+                randomize_edge(buf0, buf1, bit_depth, dir);
+                randomize_params(tc, no_p, no_q);
+
+                call_ref(buf0 + offset, BUF_STRIDE, tc, no_p, no_q);
+                call_new(buf1 + offset, BUF_STRIDE, tc, no_p, no_q);
+                if (memcmp(buf0, buf1, BUF_SIZE))
+                    fail();
+            }
+            bench_new(buf1 + offset, BUF_STRIDE, tc, no_p, no_q);
+        }
+    }
+}
+
+void checkasm_check_hevc_deblock(void)
+{
+    int bit_depth;
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        HEVCDSPContext h;
+
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_deblock_luma(&h, bit_depth);
+    }
+    report("luma");
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        HEVCDSPContext h;
+
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_deblock_chroma(&h, bit_depth);
+    }
+    report("chroma");
+}
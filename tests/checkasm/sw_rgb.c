@@ -179,6 +179,229 @@ static void check_interleave_bytes(void)
     }
 }
 
+#define MAX_WORDS 512
+
+static const int word_widths[] = { 1, 2, 7, 8, 15, 16, 31, 32, 33, 100, 510 };
+
+static void check_interleave_words(void)
+{
+    LOCAL_ALIGNED_32(uint16_t, src0, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, src1, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst0, [2 * MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst1, [2 * MAX_WORDS]);
+
+    declare_func(void, const uint16_t *src1, const uint16_t *src2,
+                 uint16_t *dst, int width, int shift);
+
+    randomize_buffers((uint8_t *)src0, MAX_WORDS * 2);
+    randomize_buffers((uint8_t *)src1, MAX_WORDS * 2);
+
+    if (check_func(interleaveWords, "interleave_words")) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(word_widths); i++) {
+            int w = word_widths[i], shift = rnd() % 9;
+
+            memset(dst0, 0, 4 * MAX_WORDS);
+            memset(dst1, 0, 4 * MAX_WORDS);
+            call_ref(src0, src1, dst0, w, shift);
+            call_new(src0, src1, dst1, w, shift);
+            if (memcmp(dst0, dst1, 4 * MAX_WORDS))
+                fail();
+        }
+        bench_new(src0, src1, dst1, MAX_WORDS, 6);
+    }
+}
+
+static void check_deinterleave_words(void)
+{
+    LOCAL_ALIGNED_32(uint16_t, src, [2 * MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst0_0, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst0_1, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst1_0, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst1_1, [MAX_WORDS]);
+
+    declare_func(void, const uint16_t *src, uint16_t *dst1, uint16_t *dst2,
+                 int width, int shift);
+
+    randomize_buffers((uint8_t *)src, MAX_WORDS * 4);
+
+    if (check_func(deinterleaveWords, "deinterleave_words")) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(word_widths); i++) {
+            int w = word_widths[i], shift = rnd() % 9;
+
+            memset(dst0_0, 0, 2 * MAX_WORDS);
+            memset(dst0_1, 0, 2 * MAX_WORDS);
+            memset(dst1_0, 0, 2 * MAX_WORDS);
+            memset(dst1_1, 0, 2 * MAX_WORDS);
+            call_ref(src, dst0_0, dst0_1, w, shift);
+            call_new(src, dst1_0, dst1_1, w, shift);
+            if (memcmp(dst0_0, dst1_0, 2 * MAX_WORDS) ||
+                memcmp(dst0_1, dst1_1, 2 * MAX_WORDS))
+                fail();
+        }
+        bench_new(src, dst1_0, dst1_1, MAX_WORDS, 6);
+    }
+}
+
+static void check_shift_words(void)
+{
+    LOCAL_ALIGNED_32(uint16_t, src, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst0, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst1, [MAX_WORDS]);
+
+    declare_func(void, const uint16_t *src, uint16_t *dst, int width, int shift);
+
+    randomize_buffers((uint8_t *)src, MAX_WORDS * 2);
+
+    if (check_func(shiftWords, "shift_words")) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(word_widths); i++) {
+            int w = word_widths[i], shift = (int)(rnd() % 17) - 8;
+
+            memset(dst0, 0, 2 * MAX_WORDS);
+            memset(dst1, 0, 2 * MAX_WORDS);
+            call_ref(src, dst0, w, shift);
+            call_new(src, dst1, w, shift);
+            if (memcmp(dst0, dst1, 2 * MAX_WORDS))
+                fail();
+        }
+        bench_new(src, dst1, MAX_WORDS, 6);
+    }
+}
+
+static void check_yuyv16_to_422p(void)
+{
+    LOCAL_ALIGNED_32(uint16_t, src, [2 * MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst_y_0, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst_y_1, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst_u_0, [MAX_WORDS / 2]);
+    LOCAL_ALIGNED_32(uint16_t, dst_u_1, [MAX_WORDS / 2]);
+    LOCAL_ALIGNED_32(uint16_t, dst_v_0, [MAX_WORDS / 2]);
+    LOCAL_ALIGNED_32(uint16_t, dst_v_1, [MAX_WORDS / 2]);
+
+    declare_func(void, uint16_t *ydst, uint16_t *udst, uint16_t *vdst,
+                 const uint16_t *src, int width, int shift);
+
+    randomize_buffers((uint8_t *)src, MAX_WORDS * 4);
+
+    if (check_func(yuyv16toyuv422, "yuyv16toyuv422")) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(word_widths); i++) {
+            int w = word_widths[i] & ~1, shift = rnd() % 7;
+
+            memset(dst_y_0, 0, 2 * MAX_WORDS);
+            memset(dst_y_1, 0, 2 * MAX_WORDS);
+            memset(dst_u_0, 0, MAX_WORDS);
+            memset(dst_u_1, 0, MAX_WORDS);
+            memset(dst_v_0, 0, MAX_WORDS);
+            memset(dst_v_1, 0, MAX_WORDS);
+            call_ref(dst_y_0, dst_u_0, dst_v_0, src, w, shift);
+            call_new(dst_y_1, dst_u_1, dst_v_1, src, w, shift);
+            if (memcmp(dst_y_0, dst_y_1, 2 * MAX_WORDS) ||
+                memcmp(dst_u_0, dst_u_1, MAX_WORDS) ||
+                memcmp(dst_v_0, dst_v_1, MAX_WORDS))
+                fail();
+        }
+        bench_new(dst_y_1, dst_u_1, dst_v_1, src, MAX_WORDS, 6);
+    }
+}
+
+static void check_422p_to_yuyv16(void)
+{
+    LOCAL_ALIGNED_32(uint16_t, src_y, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, src_u, [MAX_WORDS / 2]);
+    LOCAL_ALIGNED_32(uint16_t, src_v, [MAX_WORDS / 2]);
+    LOCAL_ALIGNED_32(uint16_t, dst0, [2 * MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst1, [2 * MAX_WORDS]);
+
+    declare_func(void, const uint16_t *ysrc, const uint16_t *usrc,
+                 const uint16_t *vsrc, uint16_t *dst, int width, int shift);
+
+    randomize_buffers((uint8_t *)src_y, MAX_WORDS * 2);
+    randomize_buffers((uint8_t *)src_u, MAX_WORDS);
+    randomize_buffers((uint8_t *)src_v, MAX_WORDS);
+
+    if (check_func(yuv422toyuyv16, "yuv422toyuyv16")) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(word_widths); i++) {
+            int w = word_widths[i] & ~1, shift = rnd() % 7;
+
+            memset(dst0, 0, 4 * MAX_WORDS);
+            memset(dst1, 0, 4 * MAX_WORDS);
+            call_ref(src_y, src_u, src_v, dst0, w, shift);
+            call_new(src_y, src_u, src_v, dst1, w, shift);
+            if (memcmp(dst0, dst1, 4 * MAX_WORDS))
+                fail();
+        }
+        bench_new(src_y, src_u, src_v, dst1, MAX_WORDS, 6);
+    }
+}
+
+static void check_x2rgb10_to_gbrp10(void)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [4 * MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst0_g, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst0_b, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst0_r, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst1_g, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst1_b, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, dst1_r, [MAX_WORDS]);
+
+    declare_func(void, const uint8_t *src, uint16_t *gdst, uint16_t *bdst,
+                 uint16_t *rdst, int width);
+
+    randomize_buffers(src, MAX_WORDS * 4);
+
+    if (check_func(x2rgb10togbrp10, "x2rgb10togbrp10")) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(word_widths); i++) {
+            int w = word_widths[i];
+
+            memset(dst0_g, 0, 2 * MAX_WORDS);
+            memset(dst0_b, 0, 2 * MAX_WORDS);
+            memset(dst0_r, 0, 2 * MAX_WORDS);
+            memset(dst1_g, 0, 2 * MAX_WORDS);
+            memset(dst1_b, 0, 2 * MAX_WORDS);
+            memset(dst1_r, 0, 2 * MAX_WORDS);
+            call_ref(src, dst0_g, dst0_b, dst0_r, w);
+            call_new(src, dst1_g, dst1_b, dst1_r, w);
+            if (memcmp(dst0_g, dst1_g, 2 * MAX_WORDS) ||
+                memcmp(dst0_b, dst1_b, 2 * MAX_WORDS) ||
+                memcmp(dst0_r, dst1_r, 2 * MAX_WORDS))
+                fail();
+        }
+        bench_new(src, dst1_g, dst1_b, dst1_r, MAX_WORDS);
+    }
+}
+
+static void check_gbrp10_to_x2rgb10(void)
+{
+    LOCAL_ALIGNED_32(uint16_t, src_g, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, src_b, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint16_t, src_r, [MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [4 * MAX_WORDS]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [4 * MAX_WORDS]);
+
+    declare_func(void, const uint16_t *gsrc, const uint16_t *bsrc,
+                 const uint16_t *rsrc, uint8_t *dst, int width);
+
+    /* mostly valid 10-bit samples, with some out of range ones */
+    for (int i = 0; i < MAX_WORDS; i++) {
+        src_g[i] = rnd() & 0x7FF;
+        src_b[i] = rnd() & 0x7FF;
+        src_r[i] = rnd() & 0x7FF;
+    }
+
+    if (check_func(gbrp10tox2rgb10, "gbrp10tox2rgb10")) {
+        for (int i = 0; i < FF_ARRAY_ELEMS(word_widths); i++) {
+            int w = word_widths[i];
+
+            memset(dst0, 0, 4 * MAX_WORDS);
+            memset(dst1, 0, 4 * MAX_WORDS);
+            call_ref(src_g, src_b, src_r, dst0, w);
+            call_new(src_g, src_b, src_r, dst1, w);
+            if (memcmp(dst0, dst1, 4 * MAX_WORDS))
+                fail();
+        }
+        bench_new(src_g, src_b, src_r, dst1, MAX_WORDS);
+    }
+}
+
 void checkasm_check_sw_rgb(void)
 {
     ff_sws_rgb2rgb_init();
@@ -203,4 +426,25 @@ void checkasm_check_sw_rgb(void)
 
     check_interleave_bytes();
     report("interleave_bytes");
+
+    check_interleave_words();
+    report("interleave_words");
+
+    check_deinterleave_words();
+    report("deinterleave_words");
+
+    check_shift_words();
+    report("shift_words");
+
+    check_yuyv16_to_422p();
+    report("yuyv16toyuv422");
+
+    check_422p_to_yuyv16();
+    report("yuv422toyuyv16");
+
+    check_x2rgb10_to_gbrp10();
+    report("x2rgb10togbrp10");
+
+    check_gbrp10_to_x2rgb10();
+    report("gbrp10tox2rgb10");
 }
@@ -3,6 +3,11 @@ fate-api-flac: $(APITESTSDIR)/api-flac-test$(EXESUF)
 fate-api-flac: CMD = run $(APITESTSDIR)/api-flac-test$(EXESUF)
 fate-api-flac: CMP = null
 
+FATE_API_LIBAVCODEC-$(call ALLYES, MPEG4_ENCODER MPEG4_DECODER) += fate-api-buffer-requirements
+fate-api-buffer-requirements: $(APITESTSDIR)/api-buffer-requirements-test$(EXESUF)
+fate-api-buffer-requirements: CMD = run $(APITESTSDIR)/api-buffer-requirements-test$(EXESUF)
+fate-api-buffer-requirements: CMP = null
+
 FATE_API_SAMPLES_LIBAVFORMAT-$(call DEMDEC, FLV, FLV) += fate-api-band
 fate-api-band: $(APITESTSDIR)/api-band-test$(EXESUF)
 fate-api-band: CMD = run $(APITESTSDIR)/api-band-test$(EXESUF) $(TARGET_SAMPLES)/mpeg4/resize_down-up.h263
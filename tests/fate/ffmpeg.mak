@@ -26,6 +26,16 @@ fate-mapchan: $(FATE_MAPCHAN)
 FATE_FFMPEG-$(CONFIG_COLOR_FILTER) += fate-ffmpeg-filter_complex
 fate-ffmpeg-filter_complex: CMD = framecrc -filter_complex color=d=1:r=5 -fflags +bitexact
 
+FATE_FFMPEG-$(call ALLYES, TESTSRC_FILTER SPLIT_FILTER HFLIP_FILTER VFLIP_FILTER NEGATE_FILTER) += fate-ffmpeg-filter_complex_frame_threads
+fate-ffmpeg-filter_complex_frame_threads: CMD = framecrc -filter_complex_threads 4 -filter_thread_type slice+frame \
+  -filter_complex "testsrc=d=1:r=5,split=3[a][b][c];[a]hflip[x];[b]vflip[y];[c]negate[z]" \
+  -map "[x]" -map "[y]" -map "[z]" -fflags +bitexact
+
+FATE_FFMPEG-$(call ALLYES, LAVFI_INDEV TESTSRC_FILTER FORMAT_FILTER SCALE_FILTER RAWVIDEO_ENCODER) += fate-ffmpeg-shared_conversion
+fate-ffmpeg-shared_conversion: CMD = framecrc -auto_conversion_filters -shared_conversion -f lavfi -i testsrc=d=1:r=5,format=yuv422p \
+  -map 0 -sws_flags +accurate_rnd+bitexact -pix_fmt yuv420p -c:v rawvideo -f null - \
+  -map 0 -sws_flags +accurate_rnd+bitexact -pix_fmt yuv420p -c:v rawvideo
+
 # Ticket 6603
 FATE_FFMPEG-$(call ALLYES, AEVALSRC_FILTER ASETNSAMPLES_FILTER AC3_FIXED_ENCODER) += fate-ffmpeg-filter_complex_audio
 fate-ffmpeg-filter_complex_audio: CMD = framecrc -auto_conversion_filters -filter_complex "aevalsrc=0:d=0.1,asetnsamples=1537" -c ac3_fixed
@@ -41,6 +51,23 @@ fate-ffmpeg-filter_colorkey: CMD = framecrc -auto_conversion_filters -idct simpl
 FATE_FFMPEG-$(CONFIG_COLOR_FILTER) += fate-ffmpeg-lavfi
 fate-ffmpeg-lavfi: CMD = framecrc -lavfi color=d=1:r=5 -fflags +bitexact
 
+FATE_FFMPEG-$(call ALLYES, RAWVIDEO_DEMUXER RAWVIDEO_DECODER WAV_DEMUXER PCM_S16LE_DECODER) += fate-ffmpeg-decode-thread
+fate-ffmpeg-decode-thread: tests/data/vsynth1.yuv tests/data/asynth-44100-2.wav
+fate-ffmpeg-decode-thread: CMD = framecrc -decode_queue_size 2 -s 352x288 -pix_fmt yuv420p -i $(TARGET_PATH)/tests/data/vsynth1.yuv \
+  -decode_queue_size 4 -i $(TARGET_PATH)/tests/data/asynth-44100-2.wav -map 0:v -map 1:a -c:v rawvideo -c:a pcm_s16le -t 1
+
+FATE_FFMPEG-$(call ALLYES, RAWVIDEO_DEMUXER RAWVIDEO_DECODER WAV_DEMUXER PCM_S16LE_DECODER FFV1_ENCODER FLAC_ENCODER) += fate-ffmpeg-encode-thread
+fate-ffmpeg-encode-thread: tests/data/vsynth1.yuv tests/data/asynth-44100-2.wav
+fate-ffmpeg-encode-thread: CMD = framecrc -s 352x288 -pix_fmt yuv420p -i $(TARGET_PATH)/tests/data/vsynth1.yuv \
+  -i $(TARGET_PATH)/tests/data/asynth-44100-2.wav -map 0:v -map 1:a -c:v ffv1 -c:a flac -t 1 \
+  -async_depth:v 2 -async_depth:a 4
+
+FATE_FFMPEG-$(call ALLYES, RAWVIDEO_DEMUXER RAWVIDEO_DECODER WAV_DEMUXER PCM_S16LE_DECODER) += fate-ffmpeg-mux-thread
+fate-ffmpeg-mux-thread: tests/data/vsynth1.yuv tests/data/asynth-44100-2.wav
+fate-ffmpeg-mux-thread: CMD = framecrc -s 352x288 -pix_fmt yuv420p -i $(TARGET_PATH)/tests/data/vsynth1.yuv \
+  -i $(TARGET_PATH)/tests/data/asynth-44100-2.wav -map 0:v -map 1:a -c:v rawvideo -c:a pcm_s16le -t 1 \
+  -thread_queue_size 3 -thread_queue_max_bytes 200000
+
 FATE_SAMPLES_FFMPEG-$(CONFIG_RAWVIDEO_DEMUXER) += fate-force_key_frames
 fate-force_key_frames: tests/data/vsynth_lena.yuv
 fate-force_key_frames: CMD = enc_dec \
@@ -63,6 +63,11 @@ fate-filter-agate: tests/data/asynth-44100-2.wav
 fate-filter-agate: SRC = $(TARGET_PATH)/tests/data/asynth-44100-2.wav
 fate-filter-agate: CMD = framecrc -i $(SRC) -af aresample,agate=level_in=10:range=0:threshold=1:ratio=1:attack=1:knee=1:makeup=4,aresample
 
+FATE_AFILTER-$(call FILTERDEMDECENCMUX, AGC, WAV, PCM_S16LE, PCM_S16LE, WAV) += fate-filter-agc
+fate-filter-agc: tests/data/asynth-44100-2.wav
+fate-filter-agc: SRC = $(TARGET_PATH)/tests/data/asynth-44100-2.wav
+fate-filter-agc: CMD = framecrc -i $(SRC) -af aresample,agc=targetDBFS=3,aresample
+
 FATE_AFILTER-$(call FILTERDEMDECENCMUX, AFADE, WAV, PCM_S16LE, PCM_S16LE, WAV) += fate-filter-alimiter
 fate-filter-alimiter: tests/data/asynth-44100-2.wav
 fate-filter-alimiter: SRC = $(TARGET_PATH)/tests/data/asynth-44100-2.wav
@@ -129,6 +129,18 @@ FATE_FILTER-$(call ALLYES, MINTERPOLATE_FILTER TESTSRC2_FILTER) += fate-filter-m
 fate-filter-minterpolate-up: CMD = framecrc -lavfi testsrc2=r=2:d=10,minterpolate=fps=10 -t 1
 fate-filter-minterpolate-down: CMD = framecrc -lavfi testsrc2=r=2:d=10,minterpolate=fps=1 -t 1
 
+FATE_FILTER-$(call ALLYES, SCALE_LADDER_FILTER TESTSRC2_FILTER FORMAT_FILTER) += fate-filter-scale_ladder fate-filter-scale_ladder-rgb fate-filter-scale_ladder-cascade
+fate-filter-scale_ladder: CMD = framecrc -filter_complex "testsrc2=s=352x288:r=5:d=1,format=yuv422p10le,scale_ladder=sizes=320x240|176x144|128x96:flags=bicubic+accurate_rnd+bitexact[a][b][c];[a]format=yuv420p10le[x];[b]format=yuv420p[y];[c]format=rgb24[z]" \
+  -map "[x]" -map "[y]" -map "[z]"
+fate-filter-scale_ladder-rgb: CMD = framecrc -filter_complex "testsrc2=s=352x288:r=5:d=1,format=rgb24,scale_ladder=sizes=320x240|176x144:flags=bicubic+accurate_rnd+bitexact[a][b];[a]format=yuv420p[x];[b]format=bgra[y]" \
+  -map "[x]" -map "[y]"
+fate-filter-scale_ladder-cascade: CMD = framecrc -filter_complex "testsrc2=s=352x288:r=5:d=1,format=yuv420p,scale_ladder=sizes=320x240|128x96|160x120:flags=bicubic+accurate_rnd+bitexact:cascade=1[a][b][c];[a]format=yuv420p[x];[b]format=yuv420p[y];[c]format=yuv420p[z]" \
+  -map "[x]" -map "[y]" -map "[z]"
+
+FATE_FILTER-$(call ALLYES, TESTSRC2_FILTER SPLIT_FILTER FORMAT_FILTER SCALE_FILTER) += fate-filter-scale-p2xx-p4xx
+fate-filter-scale-p2xx-p4xx: CMD = framecrc -filter_complex "testsrc2=s=352x288:r=5:d=1,split=4[a][b][c][d];[a]scale=flags=accurate_rnd+bitexact,format=yuv422p10le,scale=flags=accurate_rnd+bitexact,format=p210le[w];[b]scale=flags=accurate_rnd+bitexact,format=yuv422p12le,scale=flags=accurate_rnd+bitexact,format=p216le[x];[c]scale=351:288:flags=accurate_rnd+bitexact,format=yuv444p10le,scale=flags=accurate_rnd+bitexact,format=p410le[y];[d]scale=351:288:flags=accurate_rnd+bitexact,format=yuv444p12le,scale=flags=accurate_rnd+bitexact,format=p416le[z]" \
+  -map "[w]" -map "[x]" -map "[y]" -map "[z]"
+
 FATE_FILTER_VSYNTH-$(CONFIG_BOXBLUR_FILTER) += fate-filter-boxblur
 fate-filter-boxblur: CMD = framecrc -c:v pgmyuv -i $(SRC) -vf boxblur=2:1
 
@@ -499,6 +511,9 @@ fate-filter-scale200: CMD = video_filter "scale=w=200:h=200"
 FATE_FILTER_VSYNTH-$(CONFIG_SCALE_FILTER) += fate-filter-scale500
 fate-filter-scale500: CMD = video_filter "scale=w=500:h=500"
 
+FATE_FILTER_VSYNTH-$(CONFIG_SCALE_FILTER) += fate-filter-scale500-tiled
+fate-filter-scale500-tiled: CMD = video_filter "scale=w=500:h=500:tile_width=128"
+
 FATE_FILTER_VSYNTH-$(CONFIG_SCALE2REF_FILTER) += fate-filter-scale2ref_keep_aspect
 fate-filter-scale2ref_keep_aspect: tests/data/filtergraphs/scale2ref_keep_aspect
 fate-filter-scale2ref_keep_aspect: CMD = framemd5 -frames:v 5 -filter_complex_script $(TARGET_PATH)/tests/data/filtergraphs/scale2ref_keep_aspect -map "[main]"
@@ -450,3 +450,7 @@ fate-h264-dts_5frames:                            CMD = probeframes $(TARGET_SAM
 
 fate-h264-encparams: CMD = venc_data $(TARGET_SAMPLES)/h264-conformance/FRext/FRExt_MMCO4_Sony_B.264 0 1
 FATE_SAMPLES_DUMP_DATA += fate-h264-encparams
+
+FATE_H264-$(call DEMDEC, H264, H264) += fate-h264-conformance-ba1_ft_c-frame-slice-threads
+fate-h264-conformance-ba1_ft_c-frame-slice-threads: CMD = threads=4 thread_type=frame+slice framecrc -frame_threads 2 -framerate 19 -i $(TARGET_SAMPLES)/h264-conformance/BA1_FT_C.264
+fate-h264-conformance-ba1_ft_c-frame-slice-threads: REF = $(SRC_PATH)/tests/ref/fate/h264-conformance-ba1_ft_c
@@ -285,6 +285,10 @@ FATE_HEVC-$(call DEMDEC, HEVC, HEVC) += fate-hevc-cabac-tudepth
 fate-hevc-small422chroma: CMD = framecrc -flags unaligned -i $(TARGET_SAMPLES)/hevc/food.hevc -pix_fmt yuv422p10le -vf scale
 FATE_HEVC-$(call DEMDEC, HEVC, HEVC) += fate-hevc-small422chroma
 
+fate-hevc-conformance-WPP_A_ericsson_MAIN_2-frame-slice-threads: CMD = threads=4 thread_type=frame+slice framecrc -frame_threads 2 -flags unaligned -i $(TARGET_SAMPLES)/hevc-conformance/WPP_A_ericsson_MAIN_2.bit -pix_fmt yuv420p
+fate-hevc-conformance-WPP_A_ericsson_MAIN_2-frame-slice-threads: REF = $(SRC_PATH)/tests/ref/fate/hevc-conformance-WPP_A_ericsson_MAIN_2
+FATE_HEVC-$(call DEMDEC, HEVC, HEVC) += fate-hevc-conformance-WPP_A_ericsson_MAIN_2-frame-slice-threads
+
 FATE_SAMPLES_AVCONV += $(FATE_HEVC-yes)
 FATE_SAMPLES_FFPROBE += $(FATE_HEVC_FFPROBE-yes)
 
@@ -6,6 +6,14 @@ FATE_LIBSWSCALE += fate-sws-floatimg-cmp
 fate-sws-floatimg-cmp: libswscale/tests/floatimg_cmp$(EXESUF)
 fate-sws-floatimg-cmp: CMD = run libswscale/tests/floatimg_cmp$(EXESUF)
 
+FATE_LIBSWSCALE += fate-sws-context-cache
+fate-sws-context-cache: libswscale/tests/context_cache$(EXESUF)
+fate-sws-context-cache: CMD = run libswscale/tests/context_cache$(EXESUF)
+
+FATE_LIBSWSCALE += fate-sws-scale-multi
+fate-sws-scale-multi: libswscale/tests/scale_multi$(EXESUF)
+fate-sws-scale-multi: CMD = run libswscale/tests/scale_multi$(EXESUF)
+
 SWS_SLICE_TEST-$(call DEMDEC, MATROSKA, VP9) += fate-sws-slice-yuv422-12bit-rgb48
 fate-sws-slice-yuv422-12bit-rgb48: CMD = run tools/scale_slice_test$(EXESUF) $(TARGET_SAMPLES)/vp9-test-vectors/vp93-2-20-12bit-yuv422.webm 150 100 rgb48
 
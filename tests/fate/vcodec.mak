@@ -288,6 +288,25 @@ fate-vsynth%-mpeg2-thread:       ENCOPTS = -qscale 10 -bf 2 -flags +ildct+ilme \
 fate-vsynth%-mpeg2-thread-ivlc:  ENCOPTS = -qscale 10 -bf 2 -flags +ildct+ilme \
                                            -intra_vlc 1 -threads 2 -slices 2
 
+FATE_MPEG2_RC_LOOKAHEAD = fate-vsynth1-mpeg2-rc-lookahead                 \
+                          fate-vsynth1-mpeg2-rc-lookahead-vbv
+
+FATE_VSYNTH1_MPEG2-$(call ENCDEC, MPEG2VIDEO, MPEG2VIDEO MPEGVIDEO) += $(FATE_MPEG2_RC_LOOKAHEAD)
+
+$(FATE_MPEG2_RC_LOOKAHEAD): FMT   = mpeg2video
+$(FATE_MPEG2_RC_LOOKAHEAD): CODEC = mpeg2video
+
+fate-vsynth1-mpeg2-rc-lookahead:     ENCOPTS = -b:v 600k -bf 2 -rc_lookahead 8
+fate-vsynth1-mpeg2-rc-lookahead-vbv: ENCOPTS = -b:v 600k -maxrate 800k -bufsize 400k \
+                                               -bf 2 -rc_lookahead 8
+
+FATE_VSYNTH1_MPEG2-$(call ENCDEC, MPEG2VIDEO, MPEG2VIDEO MPEGVIDEO) += fate-vsynth1-mpeg2-frame-threads
+fate-vsynth1-mpeg2-frame-threads: FMT         = mpeg2video
+fate-vsynth1-mpeg2-frame-threads: CODEC       = mpeg2video
+fate-vsynth1-mpeg2-frame-threads: ENCOPTS     = -qscale 10 -bf 2
+fate-vsynth1-mpeg2-frame-threads: THREADS     = 4
+fate-vsynth1-mpeg2-frame-threads: THREAD_TYPE = frame
+
 FATE_MPEG4_MP4 = mpeg4
 FATE_MPEG4_AVI = mpeg4-rc                                               \
                  mpeg4-adv                                              \
@@ -348,6 +367,10 @@ fate-vsynth%-msmpeg4v2:          ENCOPTS = -qscale 10
 FATE_VCODEC-$(call ENCDEC, PNG, AVI)    += mpng
 fate-vsynth%-mpng:               CODEC   = png
 
+FATE_VSYNTH1_MPNG-$(call ENCDEC, PNG, AVI) += fate-vsynth1-mpng-slice
+fate-vsynth1-mpng-slice:         CODEC   = png
+fate-vsynth1-mpng-slice:         ENCOPTS = -threads 3 -thread_type slice
+
 FATE_VCODEC-$(call ENCDEC, MSVIDEO1, AVI) += msvideo1
 
 FATE_VCODEC-$(call ENCDEC, PRORES, MOV) += prores prores_int prores_444 prores_444_int prores_ks
@@ -461,7 +484,8 @@ FATE_VCODEC-$(call ENCDEC, Y41P, AVI) += y41p
 FATE_VCODEC-$(call ENCDEC, ZLIB, AVI) += zlib
 
 FATE_VCODEC += $(FATE_VCODEC-yes)
-FATE_VSYNTH1 = $(FATE_VCODEC:%=fate-vsynth1-%)
+FATE_VSYNTH1 = $(FATE_VCODEC:%=fate-vsynth1-%) $(FATE_VSYNTH1_MPEG2-yes) \
+               $(FATE_VSYNTH1_MPNG-yes)
 FATE_VSYNTH2 = $(FATE_VCODEC:%=fate-vsynth2-%)
 FATE_VSYNTH_LENA = $(FATE_VCODEC:%=fate-vsynth_lena-%)
 # Redundant tests because they just resize the input